@@ -21,6 +21,7 @@ m4_include([m4.include/mc-with-internal-edit.m4])
 m4_include([m4.include/mc-subshell.m4])
 m4_include([m4.include/mc-background.m4])
 m4_include([m4.include/mc-ext2fs-attr.m4])
+m4_include([m4.include/mc-uring.m4])
 m4_include([m4.include/mc-glib.m4])
 m4_include([m4.include/mc-vfs.m4])
 m4_include([m4.include/mc-version.m4])
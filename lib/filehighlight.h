@@ -14,6 +14,7 @@ typedef struct mc_fhl_struct
 {
     mc_config_t *config;
     GPtrArray *filters;
+    struct mc_fhl_index_struct *index;  // filters compiled for fast lookup
 } mc_fhl_t;
 
 /*** global variables defined in .c file *********************************************************/
@@ -70,6 +70,38 @@ mc_fhl_array_free (mc_fhl_t *fhl)
         g_ptr_array_free (fhl->filters, TRUE);
         fhl->filters = NULL;
     }
+
+    mc_fhl_index_free (fhl->index);
+    fhl->index = NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+mc_fhl_index_t *
+mc_fhl_index_new (void)
+{
+    mc_fhl_index_t *index;
+
+    index = g_new0 (mc_fhl_index_t, 1);
+    index->extensions = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    index->extensions_nocase = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    index->regexps = g_array_new (FALSE, FALSE, sizeof (guint));
+
+    return index;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+mc_fhl_index_free (mc_fhl_index_t *index)
+{
+    if (index != NULL)
+    {
+        g_hash_table_destroy (index->extensions);
+        g_hash_table_destroy (index->extensions_nocase);
+        g_array_free (index->regexps, TRUE);
+        g_free (index);
+    }
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -177,98 +177,150 @@ mc_fhl_is_special (const file_entry_t *fe)
 
 /* --------------------------------------------------------------------------------------------- */
 
-static int
-mc_fhl_get_color_filetype (const mc_fhl_filter_t *mc_filter, const mc_fhl_t *fhl,
-                           const file_entry_t *fe)
-{
-    gboolean my_color = FALSE;
-
-    (void) fhl;
+/**
+ * Check whether file has the type.
+ */
 
-    switch (mc_filter->file_type)
+static gboolean
+mc_fhl_is_file_type (mc_flhgh_ftype_type file_type, const file_entry_t *fe)
+{
+    switch (file_type)
     {
     case MC_FLHGH_FTYPE_T_FILE:
-        if (mc_fhl_is_file (fe))
-            my_color = TRUE;
-        break;
+        return mc_fhl_is_file (fe);
     case MC_FLHGH_FTYPE_T_FILE_EXE:
-        if (mc_fhl_is_file (fe) && mc_fhl_is_file_exec (fe))
-            my_color = TRUE;
-        break;
+        return mc_fhl_is_file (fe) && mc_fhl_is_file_exec (fe);
     case MC_FLHGH_FTYPE_T_DIR:
-        if (mc_fhl_is_dir (fe) || mc_fhl_is_link_to_dir (fe))
-            my_color = TRUE;
-        break;
+        return mc_fhl_is_dir (fe) || mc_fhl_is_link_to_dir (fe);
     case MC_FLHGH_FTYPE_T_LINK_DIR:
-        if (mc_fhl_is_link_to_dir (fe))
-            my_color = TRUE;
-        break;
+        return mc_fhl_is_link_to_dir (fe);
     case MC_FLHGH_FTYPE_T_LINK:
-        if (mc_fhl_is_link (fe) || mc_fhl_is_hlink (fe))
-            my_color = TRUE;
-        break;
+        return mc_fhl_is_link (fe) || mc_fhl_is_hlink (fe);
     case MC_FLHGH_FTYPE_T_HARDLINK:
-        if (mc_fhl_is_hlink (fe))
-            my_color = TRUE;
-        break;
+        return mc_fhl_is_hlink (fe);
     case MC_FLHGH_FTYPE_T_SYMLINK:
-        if (mc_fhl_is_link (fe))
-            my_color = TRUE;
-        break;
+        return mc_fhl_is_link (fe);
     case MC_FLHGH_FTYPE_T_STALE_LINK:
-        if (mc_fhl_is_stale_link (fe))
-            my_color = TRUE;
-        break;
+        return mc_fhl_is_stale_link (fe);
     case MC_FLHGH_FTYPE_T_DEVICE:
-        if (mc_fhl_is_device_char (fe) || mc_fhl_is_device_block (fe))
-            my_color = TRUE;
-        break;
+        return mc_fhl_is_device_char (fe) || mc_fhl_is_device_block (fe);
     case MC_FLHGH_FTYPE_T_DEVICE_BLOCK:
-        if (mc_fhl_is_device_block (fe))
-            my_color = TRUE;
-        break;
+        return mc_fhl_is_device_block (fe);
     case MC_FLHGH_FTYPE_T_DEVICE_CHAR:
-        if (mc_fhl_is_device_char (fe))
-            my_color = TRUE;
-        break;
+        return mc_fhl_is_device_char (fe);
     case MC_FLHGH_FTYPE_T_SPECIAL:
-        if (mc_fhl_is_special (fe))
-            my_color = TRUE;
-        break;
+        return mc_fhl_is_special (fe);
     case MC_FLHGH_FTYPE_T_SPECIAL_SOCKET:
-        if (mc_fhl_is_special_socket (fe))
-            my_color = TRUE;
-        break;
+        return mc_fhl_is_special_socket (fe);
     case MC_FLHGH_FTYPE_T_SPECIAL_FIFO:
-        if (mc_fhl_is_special_fifo (fe))
-            my_color = TRUE;
-        break;
+        return mc_fhl_is_special_fifo (fe);
     case MC_FLHGH_FTYPE_T_SPECIAL_DOOR:
-        if (mc_fhl_is_special_door (fe))
-            my_color = TRUE;
-        break;
+        return mc_fhl_is_special_door (fe);
     default:
-        break;
+        return FALSE;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Find the first file type filter that matches the file.
+ *
+ * @return position of filter plus 1, 0 if there is no such filter
+ */
+
+static guint
+mc_fhl_get_first_file_type (const mc_fhl_index_t *index, const file_entry_t *fe)
+{
+    guint first = 0;
+    int i;
+
+    for (i = 0; i < MC_FLHGH_FTYPE_T_NUM; i++)
+    {
+        const guint n = index->file_types[i];
+
+        if (n != 0 && (first == 0 || n < first)
+            && mc_fhl_is_file_type ((mc_flhgh_ftype_type) i, fe))
+            first = n;
+    }
+
+    return first;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Find the first extension filter that matches the file and precedes @first.
+ * Any part of file name after a dot is an extension, as in ".*\.(ext1|ext2)$" regexp.
+ *
+ * @return position of filter plus 1, or @first
+ */
+
+static guint
+mc_fhl_get_first_extension (const mc_fhl_index_t *index, const file_entry_t *fe, guint first)
+{
+    char lower[BUF_SMALL];
+    const char *name = fe->fname->str;
+    const char *dot;
+    gboolean nocase;
+
+    nocase = g_hash_table_size (index->extensions_nocase) != 0;
+
+    for (dot = strchr (name, '.'); dot != NULL; dot = strchr (dot + 1, '.'))
+    {
+        const char *ext = dot + 1;
+        const size_t len = fe->fname->len - (size_t) (ext - name);
+        guint n;
+
+        n = GPOINTER_TO_UINT (g_hash_table_lookup (index->extensions, ext));
+        if (n != 0 && (first == 0 || n < first))
+            first = n;
+
+        // there are no such long extensions
+        if (nocase && len < sizeof (lower))
+        {
+            size_t i;
+
+            // extensions are compared case insensitively for ASCII letters only
+            for (i = 0; i <= len; i++)
+                lower[i] = g_ascii_tolower (ext[i]);
+
+            n = GPOINTER_TO_UINT (g_hash_table_lookup (index->extensions_nocase, lower));
+            if (n != 0 && (first == 0 || n < first))
+                first = n;
+        }
     }
 
-    return my_color ? mc_filter->color_pair_index : -1;
+    return first;
 }
 
 /* --------------------------------------------------------------------------------------------- */
+/**
+ * Find the first regexp filter that matches the file and precedes @first.
+ * Regexps are run in order of precedence, so regexps after @first aren't run at all.
+ *
+ * @return position of filter plus 1, or @first
+ */
 
-static int
-mc_fhl_get_color_regexp (const mc_fhl_filter_t *mc_filter, const mc_fhl_t *fhl,
-                         const file_entry_t *fe)
+static guint
+mc_fhl_get_first_regexp (const mc_fhl_t *fhl, const file_entry_t *fe, guint first)
 {
-    (void) fhl;
+    guint i;
 
-    if (mc_filter->search_condition == NULL)
-        return -1;
+    for (i = 0; i < fhl->index->regexps->len; i++)
+    {
+        const guint n = g_array_index (fhl->index->regexps, guint, i);
+        const mc_fhl_filter_t *mc_filter;
+
+        if (first != 0 && n > first)
+            break;
 
-    if (mc_search_run (mc_filter->search_condition, fe->fname->str, 0, fe->fname->len, NULL))
-        return mc_filter->color_pair_index;
+        mc_filter = (const mc_fhl_filter_t *) g_ptr_array_index (fhl->filters, n - 1);
+        if (mc_filter->search_condition != NULL
+            && mc_search_run (mc_filter->search_condition, fe->fname->str, 0, fe->fname->len,
+                              NULL))
+            return n;
+    }
 
-    return -1;
+    return first;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -278,35 +330,22 @@ mc_fhl_get_color_regexp (const mc_fhl_filter_t *mc_filter, const mc_fhl_t *fhl,
 int
 mc_fhl_get_color (const mc_fhl_t *fhl, const file_entry_t *fe)
 {
-    guint i;
-    int ret;
+    const mc_fhl_filter_t *mc_filter;
+    guint first;
 
-    if (fhl == NULL)
+    if (fhl == NULL || fhl->index == NULL)
         return NORMAL_COLOR;
 
-    for (i = 0; i < fhl->filters->len; i++)
-    {
-        mc_fhl_filter_t *mc_filter;
+    first = mc_fhl_get_first_file_type (fhl->index, fe);
+    first = mc_fhl_get_first_extension (fhl->index, fe, first);
+    first = mc_fhl_get_first_regexp (fhl, fe, first);
 
-        mc_filter = (mc_fhl_filter_t *) g_ptr_array_index (fhl->filters, i);
-        switch (mc_filter->type)
-        {
-        case MC_FLHGH_T_FTYPE:
-            ret = mc_fhl_get_color_filetype (mc_filter, fhl, fe);
-            if (ret > 0)
-                return -ret;
-            break;
-        case MC_FLHGH_T_EXT:
-        case MC_FLHGH_T_FREGEXP:
-            ret = mc_fhl_get_color_regexp (mc_filter, fhl, fe);
-            if (ret > 0)
-                return -ret;
-            break;
-        default:
-            break;
-        }
-    }
-    return NORMAL_COLOR;
+    if (first == 0)
+        return NORMAL_COLOR;
+
+    mc_filter = (const mc_fhl_filter_t *) g_ptr_array_index (fhl->filters, first - 1);
+
+    return -mc_filter->color_pair_index;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -29,7 +29,6 @@
 
 #include "lib/global.h"
 #include "lib/fileloc.h"
-#include "lib/strutil.h"
 #include "lib/skin.h"
 #include "lib/util.h"  // exist_file()
 
@@ -100,6 +99,9 @@ mc_fhl_parse_get_file_type_id (mc_fhl_t *fhl, const gchar *group_name)
 
     g_ptr_array_add (fhl->filters, (gpointer) mc_filter);
 
+    if (mc_filter->color_pair_index > 0 && fhl->index->file_types[i] == 0)
+        fhl->index->file_types[i] = fhl->filters->len;
+
     return TRUE;
 }
 
@@ -128,17 +130,26 @@ mc_fhl_parse_get_regexp (mc_fhl_t *fhl, const gchar *group_name)
     g_ptr_array_add (fhl->filters, (gpointer) mc_filter);
     g_free (regexp);
 
+    if (mc_filter->color_pair_index > 0)
+        g_array_append_val (fhl->index->regexps, fhl->filters->len);
+
     return TRUE;
 }
 
 /* --------------------------------------------------------------------------------------------- */
 
+/**
+ * Extensions aren't matched by regexp: they are put into hash tables to find the filter
+ * by extension of file name directly.
+ */
+
 static gboolean
 mc_fhl_parse_get_extensions (mc_fhl_t *fhl, const gchar *group_name)
 {
     mc_fhl_filter_t *mc_filter;
     gchar **exts, **exts_orig;
-    GString *buf;
+    gboolean case_sensitive;
+    GHashTable *extensions;
 
     exts_orig = mc_config_get_string_list (fhl->config, group_name, "extensions", NULL);
     if (exts_orig == NULL || exts_orig[0] == NULL)
@@ -147,34 +158,30 @@ mc_fhl_parse_get_extensions (mc_fhl_t *fhl, const gchar *group_name)
         return FALSE;
     }
 
-    buf = g_string_sized_new (64);
+    case_sensitive = mc_config_get_bool (fhl->config, group_name, "extensions_case", FALSE);
 
-    for (exts = exts_orig; *exts != NULL; exts++)
-    {
-        char *esc_ext;
+    mc_filter = g_new0 (mc_fhl_filter_t, 1);
+    mc_filter->type = MC_FLHGH_T_EXT;
 
-        esc_ext = str_regex_escape (*exts);
-        if (buf->len != 0)
-            g_string_append_c (buf, '|');
-        g_string_append (buf, esc_ext);
-        g_free (esc_ext);
-    }
+    mc_fhl_parse_fill_color_info (mc_filter, fhl, group_name);
+    g_ptr_array_add (fhl->filters, (gpointer) mc_filter);
 
-    g_strfreev (exts_orig);
+    extensions = case_sensitive ? fhl->index->extensions : fhl->index->extensions_nocase;
 
-    g_string_prepend (buf, ".*\\.(");
-    g_string_append (buf, ")$");
+    for (exts = exts_orig; mc_filter->color_pair_index > 0 && *exts != NULL; exts++)
+    {
+        char *ext;
 
-    mc_filter = g_new0 (mc_fhl_filter_t, 1);
-    mc_filter->type = MC_FLHGH_T_FREGEXP;
-    mc_filter->search_condition = mc_search_new_len (buf->str, buf->len, NULL);
-    mc_filter->search_condition->is_case_sensitive =
-        mc_config_get_bool (fhl->config, group_name, "extensions_case", FALSE);
-    mc_filter->search_condition->search_type = MC_SEARCH_T_REGEX;
+        ext = case_sensitive ? g_strdup (*exts) : g_ascii_strdown (*exts, -1);
 
-    mc_fhl_parse_fill_color_info (mc_filter, fhl, group_name);
-    g_ptr_array_add (fhl->filters, (gpointer) mc_filter);
-    g_string_free (buf, TRUE);
+        // the first filter has precedence
+        if (g_hash_table_contains (extensions, ext))
+            g_free (ext);
+        else
+            g_hash_table_insert (extensions, ext, GUINT_TO_POINTER (fhl->filters->len));
+    }
+
+    g_strfreev (exts_orig);
 
     return TRUE;
 }
@@ -236,6 +243,7 @@ mc_fhl_parse_ini_file (mc_fhl_t *fhl)
 
     mc_fhl_array_free (fhl);
     fhl->filters = g_ptr_array_new_with_free_func (mc_fhl_filter_free);
+    fhl->index = mc_fhl_index_new ();
 
     orig_group_names = mc_config_get_groups (fhl->config, NULL);
     ok = (*orig_group_names != NULL);
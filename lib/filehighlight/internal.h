@@ -33,6 +33,8 @@ typedef enum
     MC_FLHGH_FTYPE_T_SPECIAL_DOOR,
 } mc_flhgh_ftype_type;
 
+#define MC_FLHGH_FTYPE_T_NUM (MC_FLHGH_FTYPE_T_SPECIAL_DOOR + 1)
+
 /*** structures declarations (and typedefs of structures)*****************************************/
 
 typedef struct mc_fhl_filter_struct
@@ -47,6 +49,19 @@ typedef struct mc_fhl_filter_struct
 
 } mc_fhl_filter_t;
 
+/*
+ * Filters compiled to find the first matching filter without running all of them.
+ * All values are positions of filters in mc_fhl_t::filters plus 1, 0 means no filter.
+ * Filters without color aren't compiled: they never match.
+ */
+typedef struct mc_fhl_index_struct
+{
+    GHashTable *extensions;                  // extension -> the first filter with this extension
+    GHashTable *extensions_nocase;           // the same for case insensitive filters
+    guint file_types[MC_FLHGH_FTYPE_T_NUM];  // file type -> the first filter of this type
+    GArray *regexps;                         // regexp filters in order of precedence
+} mc_fhl_index_t;
+
 /*** global variables defined in .c file *********************************************************/
 
 /*** declarations of public functions ************************************************************/
@@ -54,6 +69,9 @@ typedef struct mc_fhl_filter_struct
 void mc_fhl_filter_free (gpointer data);
 void mc_fhl_array_free (mc_fhl_t *fhl);
 
+mc_fhl_index_t *mc_fhl_index_new (void);
+void mc_fhl_index_free (mc_fhl_index_t *index);
+
 gboolean mc_fhl_init_from_standard_files (mc_fhl_t *fhl);
 
 /*** inline functions ****************************************************************************/
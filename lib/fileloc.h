@@ -49,6 +49,7 @@
 #define VFS_SHELL_INFO_FILE     "info"
 
 #define MC_EXTFS_DIR            "extfs.d"
+#define MC_VFS_DIRCACHE_DIR     "vfsdircache"
 
 #define MC_BASHRC_FILE          "bashrc"
 #define MC_ZSHRC_FILE           ".zshrc"
@@ -150,6 +150,7 @@ struct str_class
     /*I*/ char *(*create_key_for_filename) (const char *text, gboolean case_sen);
     /*I*/ int (*key_collate) (const char *t1, const char *t2, gboolean case_sen);
     /*I*/ void (*release_key) (char *key, gboolean case_sen);
+    /*I*/ gboolean (*key_is_binary) (gboolean case_sen);
 };
 
 /*** global variables defined in .c file *********************************************************/
@@ -524,6 +525,12 @@ int str_key_collate (const char *t1, const char *t2, gboolean case_sen);
  */
 void str_release_key (char *key, gboolean case_sen);
 
+/* return TRUE if str_key_collate compares keys bytewise like strcmp,
+ * so keys can be ordered by their first bytes
+ * I
+ */
+gboolean str_key_is_binary (gboolean case_sen);
+
 /* return TRUE if codeset_name is utf8 or utf-8
  * I
  */
@@ -713,6 +713,14 @@ str_ascii_release_key (char *key, gboolean case_sen)
 
 /* --------------------------------------------------------------------------------------------- */
 
+static gboolean
+str_ascii_key_is_binary (gboolean case_sen)
+{
+    return case_sen;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static int
 str_ascii_prefix (const char *text, const char *prefix)
 {
@@ -796,6 +804,7 @@ str_ascii_init (void)
     result.create_key_for_filename = str_ascii_create_key;
     result.key_collate = str_ascii_key_collate;
     result.release_key = str_ascii_release_key;
+    result.key_is_binary = str_ascii_key_is_binary;
 
     return result;
 }
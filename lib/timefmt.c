@@ -51,8 +51,20 @@ char *user_old_timeformat = NULL;     // time format string for older dates
 
 /*** file scope macro definitions ****************************************************************/
 
+#define SECONDS_PER_DAY       (24L * 60L * 60L)
+
+/* number of days which broken-down local dates are cached for */
+#define LOCAL_DAY_CACHE_SIZE 64
+
 /*** file scope type declarations ****************************************************************/
 
+/* broken-down local date of the day which starts at 'start' */
+typedef struct
+{
+    time_t start;  // local midnight, 0 if the slot is unused
+    struct tm tm;  // date at local midnight
+} local_day_t;
+
 /*** forward declarations (file scope functions) *************************************************/
 
 /*** file scope variables ************************************************************************/
@@ -64,8 +76,83 @@ char *user_old_timeformat = NULL;     // time format string for older dates
  */
 static size_t i18n_timelength_cache = MAX_I18NTIMELENGTH + 1;
 
+/* Recently used days. Slot is selected by the UTC day number of time */
+static local_day_t local_day_cache[LOCAL_DAY_CACHE_SIZE];
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Convert time to local broken-down time like localtime() does.
+ *
+ * localtime() is expensive (time zone rules are checked and applied on every call), and panel
+ * calls it for every visible file on every redraw. Date of day is calculated once and cached,
+ * time of day is derived from the offset from local midnight then. Days with a DST transition
+ * are not cached because the offset doesn't match the time of day there.
+ *
+ * @param when time to convert
+ * @param tm   storage for result
+ *
+ * @return FALSE if time cannot be converted, TRUE otherwise
+ */
+
+static gboolean
+file_date_localtime (time_t when, struct tm *tm)
+{
+    local_day_t *day;
+    struct tm *lt;
+    struct tm day_tm;
+    time_t start, next;
+    long secs;
+
+    day = &local_day_cache[(guint64) when / SECONDS_PER_DAY % LOCAL_DAY_CACHE_SIZE];
+
+    if (day->start != 0 && when >= day->start && when - day->start < SECONDS_PER_DAY)
+    {
+        secs = (long) (when - day->start);
+
+        *tm = day->tm;
+        tm->tm_hour = (int) (secs / (60L * 60L));
+        tm->tm_min = (int) (secs / 60L % 60L);
+        tm->tm_sec = (int) (secs % 60L);
+
+        return TRUE;
+    }
+
+    lt = localtime (&when);
+    if (lt == NULL)
+        return FALSE;
+
+    *tm = *lt;
+
+    // Cache the day if it is exactly 24 hours long and starts at expected time
+    start = when - (tm->tm_hour * 60L * 60L + tm->tm_min * 60L + tm->tm_sec);
+    if (start == 0)
+        return TRUE;
+
+    // Midnight may not exist if DST starts at it, then the day starts at another time
+    day_tm = *tm;
+    day_tm.tm_hour = day_tm.tm_min = day_tm.tm_sec = 0;
+    day_tm.tm_isdst = -1;
+    if (mktime (&day_tm) != start || day_tm.tm_hour != 0 || day_tm.tm_mday != tm->tm_mday)
+        return TRUE;
+
+    day_tm = *tm;
+    day_tm.tm_hour = day_tm.tm_min = day_tm.tm_sec = 0;
+    day_tm.tm_mday++;
+    day_tm.tm_isdst = -1;
+    next = mktime (&day_tm);
+
+    if (next == start + SECONDS_PER_DAY)
+    {
+        day->start = start;
+        day->tm = *tm;
+        day->tm.tm_hour = day->tm.tm_min = day->tm.tm_sec = 0;
+    }
+
+    return TRUE;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 /* --------------------------------------------------------------------------------------------- */
@@ -134,6 +221,7 @@ file_date (time_t when)
     static char timebuf[MB_LEN_MAX * MAX_I18NTIMELENGTH + 1];
     time_t current_time = time (NULL);
     const char *fmt;
+    struct tm whentm;
 
     if (current_time > when + 6L * 30L * 24L * 60L * 60L  // Old.
         || current_time < when - 60L * 60L)               // In the future.
@@ -148,7 +236,10 @@ file_date (time_t when)
     else
         fmt = user_recent_timeformat;
 
-    FMT_LOCALTIME (timebuf, sizeof (timebuf), fmt, when);
+    if (!file_date_localtime (when, &whentm))
+        return INVALID_TIME_TEXT;
+
+    strftime (timebuf, sizeof (timebuf), fmt, &whentm);
 
     return timebuf;
 }
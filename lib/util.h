@@ -11,6 +11,7 @@
 #include <unistd.h>
 
 #include "lib/global.h"  // include <glib.h>
+#include "lib/hook.h"
 
 #include "lib/vfs/vfs.h"
 
@@ -153,6 +154,8 @@ typedef void (*sighandler_t) (int);
 
 extern struct sigaction startup_handler;
 
+extern hook_t *uid_gid_resolved_hook;
+
 /*** declarations of public functions ************************************************************/
 
 int is_printable (int c);
@@ -211,6 +214,8 @@ int get_user_permissions (struct stat *buf);
 void init_uid_gid_cache (void);
 const char *get_group (gid_t gid);
 const char *get_owner (uid_t uid);
+const char *get_group_nowait (gid_t gid);
+const char *get_owner_nowait (uid_t uid);
 
 /* Returns a copy of *s until a \n is found and is below top */
 const char *extract_line (const char *s, const char *top, size_t *len);
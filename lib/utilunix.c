@@ -54,11 +54,13 @@
 #include <sys/select.h>
 #endif
 #include <sys/wait.h>
+#include <fcntl.h>
 #include <pwd.h>
 #include <grp.h>
 
 #include "lib/global.h"
 
+#include "lib/tty/key.h"  // add_select_channel()
 #include "lib/unixcompat.h"
 #include "lib/vfs/vfs.h"  // VFS_ENCODING_PREFIX
 #include "lib/strutil.h"  // str_move(), str_tokenize()
@@ -71,18 +73,32 @@
 
 struct sigaction startup_handler;
 
+/* called in the main thread when names requested by get_owner_nowait() and get_group_nowait()
+   are got */
+hook_t *uid_gid_resolved_hook = NULL;
+
 /*** file scope macro definitions ****************************************************************/
 
-#define UID_CACHE_SIZE 200
-#define GID_CACHE_SIZE 30
+/* user and group names are reread after this time, us */
+#define ID_CACHE_TTL (10 * 60 * G_USEC_PER_SEC)
 
 /*** file scope type declarations ****************************************************************/
 
+/* cached user or group name */
 typedef struct
 {
-    int index;
-    char *string;
-} int_cache;
+    char *name;        // name or id as string if there is no such user or group
+    gint64 expires;    // monotonic time when name should be reread
+    gboolean pending;  // name is being got in the resolver thread
+} id_cache_entry_t;
+
+/* request to or result of the resolver thread */
+typedef struct
+{
+    gboolean is_group;
+    guint id;
+    char *name;  // NULL if there is no such user or group
+} id_request_t;
 
 typedef enum
 {
@@ -102,33 +118,252 @@ typedef struct
 
 /*** file scope variables ************************************************************************/
 
-static int_cache uid_cache[UID_CACHE_SIZE];
-static int_cache gid_cache[GID_CACHE_SIZE];
+static GHashTable *uid_cache = NULL;
+static GHashTable *gid_cache = NULL;
+
+/* names are got in another thread to not block the main one */
+static struct
+{
+    GThreadPool *pool;
+    GAsyncQueue *results;
+    int pipe[2];  // wakes the main thread up when results are ready
+} id_resolver = { NULL, NULL, { -1, -1 } };
 
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
 
+static void
+id_cache_entry_free (gpointer data)
+{
+    id_cache_entry_t *entry = (id_cache_entry_t *) data;
+
+    g_free (entry->name);
+    g_free (entry);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static GHashTable *
+id_cache_get (gboolean is_group)
+{
+    GHashTable **cache = is_group ? &gid_cache : &uid_cache;
+
+    if (*cache == NULL)
+        *cache = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, id_cache_entry_free);
+
+    return *cache;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Store name in the cache. If there is no user or group with such id, the id itself is stored
+ * to not look for it again.
+ *
+ * @return stored name
+ */
+
+static const char *
+id_cache_set (gboolean is_group, guint id, const char *name)
+{
+    GHashTable *cache;
+    id_cache_entry_t *entry;
+
+    cache = id_cache_get (is_group);
+
+    entry = (id_cache_entry_t *) g_hash_table_lookup (cache, GUINT_TO_POINTER (id));
+    if (entry == NULL)
+    {
+        entry = g_new0 (id_cache_entry_t, 1);
+        g_hash_table_insert (cache, GUINT_TO_POINTER (id), entry);
+    }
+    else
+        g_free (entry->name);
+
+    entry->name = name != NULL ? g_strdup (name) : g_strdup_printf ("%d", (int) id);
+    entry->expires = g_get_monotonic_time () + ID_CACHE_TTL;
+    entry->pending = FALSE;
+
+    return entry->name;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get user or group name in the current thread.
+ *
+ * @return newly allocated name, or NULL if there is no such user or group
+ */
+
 static char *
-i_cache_match (int id, int_cache *cache, int size)
+id_resolve (gboolean is_group, guint id)
 {
-    int i;
+    char *name = NULL;
+    char *buf;
+    size_t buf_size = 1024;
+    int ret;
 
-    for (i = 0; i < size; i++)
-        if (cache[i].index == id)
-            return cache[i].string;
-    return 0;
+    while (TRUE)
+    {
+        buf = g_malloc (buf_size);
+
+        if (is_group)
+        {
+            struct group grp, *result = NULL;
+
+            ret = getgrgid_r ((gid_t) id, &grp, buf, buf_size, &result);
+            if (ret == 0 && result != NULL)
+                name = g_strdup (grp.gr_name);
+        }
+        else
+        {
+            struct passwd pwd, *result = NULL;
+
+            ret = getpwuid_r ((uid_t) id, &pwd, buf, buf_size, &result);
+            if (ret == 0 && result != NULL)
+                name = g_strdup (pwd.pw_name);
+        }
+
+        g_free (buf);
+
+        if (ret != ERANGE || buf_size >= 1024 * 1024)
+            break;
+
+        buf_size *= 2;
+    }
+
+    return name;
 }
 
 /* --------------------------------------------------------------------------------------------- */
+/** Resolver thread function */
 
 static void
-i_cache_add (int id, int_cache *cache, int size, char *text, int *last)
+id_resolver_run (gpointer data, gpointer user_data)
+{
+    id_request_t *req = (id_request_t *) data;
+
+    (void) user_data;
+
+    req->name = id_resolve (req->is_group, req->id);
+    g_async_queue_push (id_resolver.results, req);
+
+    // wake the main thread up once for a bunch of results
+    if (g_async_queue_length (id_resolver.results) == 1)
+    {
+        ssize_t ret;
+
+        ret = write (id_resolver.pipe[1], "", 1);
+        (void) ret;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Select channel callback: take results of the resolver thread */
+
+static int
+id_resolver_done (int fd, void *info)
+{
+    char buf[64];
+    id_request_t *req;
+
+    (void) info;
+
+    while (read (fd, buf, sizeof (buf)) > 0)
+        ;
+
+    while ((req = (id_request_t *) g_async_queue_try_pop (id_resolver.results)) != NULL)
+    {
+        (void) id_cache_set (req->is_group, req->id, req->name);
+        g_free (req->name);
+        g_free (req);
+    }
+
+    execute_hooks (uid_gid_resolved_hook);
+
+    return 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+id_resolver_init (void)
+{
+    if (id_resolver.pool != NULL)
+        return TRUE;
+
+    if (pipe (id_resolver.pipe) != 0)
+        return FALSE;
+
+    (void) fcntl (id_resolver.pipe[0], F_SETFL, O_NONBLOCK);
+    (void) fcntl (id_resolver.pipe[1], F_SETFL, O_NONBLOCK);
+    (void) fcntl (id_resolver.pipe[0], F_SETFD, FD_CLOEXEC);
+    (void) fcntl (id_resolver.pipe[1], F_SETFD, FD_CLOEXEC);
+
+    id_resolver.results = g_async_queue_new ();
+    // one thread: name service lookups are serialized anyway
+    id_resolver.pool = g_thread_pool_new (id_resolver_run, NULL, 1, FALSE, NULL);
+    add_select_channel (id_resolver.pipe[0], id_resolver_done, NULL);
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get cached user or group name.
+ *
+ * @param is_group TRUE for group, FALSE for user
+ * @param id user or group id
+ * @param wait if TRUE, get unknown or outdated name right now, otherwise request it from
+ *             the resolver thread
+ *
+ * @return name, id as string if there is no such user or group or name is being got yet
+ */
+
+static const char *
+id_cache_lookup (gboolean is_group, guint id, gboolean wait)
 {
-    g_free (cache[*last].string);
-    cache[*last].string = g_strdup (text);
-    cache[*last].index = id;
-    *last = ((*last) + 1) % size;
+    id_cache_entry_t *entry;
+    char *name;
+    const char *ret;
+
+    entry = (id_cache_entry_t *) g_hash_table_lookup (id_cache_get (is_group),
+                                                      GUINT_TO_POINTER (id));
+
+    if (entry != NULL && !entry->pending && entry->expires > g_get_monotonic_time ())
+        return entry->name;
+
+    if (!wait)
+    {
+        if (entry != NULL && entry->pending)
+            return entry->name;
+
+        if (id_resolver_init ())
+        {
+            id_request_t *req;
+
+            // show outdated name or id while actual name is being got
+            if (entry == NULL)
+            {
+                (void) id_cache_set (is_group, id, NULL);
+                entry = (id_cache_entry_t *) g_hash_table_lookup (id_cache_get (is_group),
+                                                                  GUINT_TO_POINTER (id));
+            }
+            entry->pending = TRUE;
+
+            req = g_new0 (id_request_t, 1);
+            req->is_group = is_group;
+            req->id = id;
+            g_thread_pool_push (id_resolver.pool, req, NULL);
+
+            return entry->name;
+        }
+    }
+
+    name = id_resolve (is_group, id);
+    ret = id_cache_set (is_group, id, name);
+    g_free (name);
+
+    return ret;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -267,27 +502,7 @@ mc_pread_stream (mc_pipe_stream_t *ps, const fd_set *fds)
 const char *
 get_owner (uid_t uid)
 {
-    struct passwd *pwd;
-    char *name;
-    static uid_t uid_last;
-
-    name = i_cache_match ((int) uid, uid_cache, UID_CACHE_SIZE);
-    if (name != NULL)
-        return name;
-
-    pwd = getpwuid (uid);
-    if (pwd != NULL)
-    {
-        i_cache_add ((int) uid, uid_cache, UID_CACHE_SIZE, pwd->pw_name, (int *) &uid_last);
-        return pwd->pw_name;
-    }
-    else
-    {
-        static char ibuf[10];
-
-        g_snprintf (ibuf, sizeof (ibuf), "%d", (int) uid);
-        return ibuf;
-    }
+    return id_cache_lookup (FALSE, (guint) uid, TRUE);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -295,27 +510,29 @@ get_owner (uid_t uid)
 const char *
 get_group (gid_t gid)
 {
-    struct group *grp;
-    char *name;
-    static gid_t gid_last;
+    return id_cache_lookup (TRUE, (guint) gid, TRUE);
+}
 
-    name = i_cache_match ((int) gid, gid_cache, GID_CACHE_SIZE);
-    if (name != NULL)
-        return name;
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get user name without waiting for name service. If name isn't cached yet, it is requested
+ * in another thread and uid as string is returned. uid_gid_resolved_hook is called when
+ * requested names are got.
+ */
 
-    grp = getgrgid (gid);
-    if (grp != NULL)
-    {
-        i_cache_add ((int) gid, gid_cache, GID_CACHE_SIZE, grp->gr_name, (int *) &gid_last);
-        return grp->gr_name;
-    }
-    else
-    {
-        static char gbuf[10];
+const char *
+get_owner_nowait (uid_t uid)
+{
+    return id_cache_lookup (FALSE, (guint) uid, FALSE);
+}
 
-        g_snprintf (gbuf, sizeof (gbuf), "%d", (int) gid);
-        return gbuf;
-    }
+/* --------------------------------------------------------------------------------------------- */
+/** Get group name without waiting for name service, see get_owner_nowait() */
+
+const char *
+get_group_nowait (gid_t gid)
+{
+    return id_cache_lookup (TRUE, (guint) gid, FALSE);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,430 @@
+/*
+   Virtual File System: persistent cache of remote directory listings.
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ * \brief Source: Virtual File System: persistent cache of remote directory listings
+ *
+ * Listings of directories of remote VFSs (ftpfs, shell) are kept in the cache directory
+ * of mc as compact binary snapshots.  When a directory that is not in the memory cache
+ * is visited again (e.g. in a new session), the snapshot is shown at once instead of
+ * waiting for the remote listing.  Such a listing expires soon, so the next access reads
+ * the directory from the remote host again and refreshes the snapshot.
+ *
+ * A snapshot is used only if it is not too old and, if the parent directory is known,
+ * the modification time of the directory is unchanged since the snapshot was saved.
+ */
+
+#include <config.h>
+
+#include <string.h>  // memcpy(), strcmp()
+#include <sys/stat.h>
+#include <unistd.h>  // unlink()
+
+#include "lib/global.h"
+#include "lib/fileloc.h"
+#include "lib/mcconfig.h"  // mc_config_get_cache_path()
+
+#include "vfs.h"
+#include "utilvfs.h"
+#include "xdirentry.h"
+
+/*** global variables ****************************************************************************/
+
+gboolean vfs_persistent_dircache = FALSE;
+
+/*** file scope macro definitions ****************************************************************/
+
+#define DIRCACHE_MAGIC   "MCDC"
+#define DIRCACHE_VERSION 1
+
+/* snapshots older than this are never used, in seconds */
+#define DIRCACHE_MAX_AGE (7 * 24 * 60 * 60)
+
+/* listing loaded from snapshot is reread from the remote host after this time, in seconds */
+#define DIRCACHE_REVALIDATE_TIMEOUT 5
+
+/*** file scope type declarations ****************************************************************/
+
+typedef struct
+{
+    const guint8 *data;
+    gsize len;
+    gsize pos;
+} dircache_reader_t;
+
+/*** forward declarations (file scope functions) *************************************************/
+
+/*** file scope variables ************************************************************************/
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+static char *
+dircache_get_key (struct vfs_class *me, const struct vfs_s_inode *root, const char *path)
+{
+    GString *url;
+    char *key;
+
+    if (root->super->path_element == NULL)
+        return NULL;
+
+    // password is not the part of key: it must not be stored on disk
+    url = vfs_path_build_url_params_str (root->super->path_element, FALSE);
+    key = g_strconcat (me->name, "://", url != NULL ? url->str : "", PATH_SEP_STR, path,
+                       (char *) NULL);
+    if (url != NULL)
+        g_string_free (url, TRUE);
+
+    return key;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static char *
+dircache_get_filename (const char *key)
+{
+    char *checksum;
+    char *filename;
+
+    checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA1, key, -1);
+    filename = g_build_filename (mc_config_get_cache_path (), MC_VFS_DIRCACHE_DIR, checksum,
+                                 (char *) NULL);
+    g_free (checksum);
+
+    return filename;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get modification time of directory from the memory cache of its parent directory.
+ *
+ * @return TRUE if parent directory is cached and contains @path, FALSE otherwise
+ */
+
+static gboolean
+dircache_get_mtime (const struct vfs_s_inode *root, const char *path, time_t *mtime)
+{
+    const char *name;
+    char *dirname;
+    GList *iter;
+
+    name = strrchr (path, PATH_SEP);
+    if (name == NULL || name[1] == '\0')
+        return FALSE;
+
+    dirname = g_path_get_dirname (path);
+    iter = g_queue_find_custom (root->subdir, dirname, (GCompareFunc) vfs_s_entry_compare);
+    g_free (dirname);
+
+    if (iter == NULL)
+        return FALSE;
+
+    iter = g_queue_find_custom (VFS_ENTRY (iter->data)->ino->subdir, name + 1,
+                                (GCompareFunc) vfs_s_entry_compare);
+    if (iter == NULL)
+        return FALSE;
+
+    *mtime = VFS_ENTRY (iter->data)->ino->st.st_mtime;
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+dircache_put_u32 (GByteArray *buf, guint32 value)
+{
+    g_byte_array_append (buf, (const guint8 *) &value, sizeof (value));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+dircache_put_i64 (GByteArray *buf, gint64 value)
+{
+    g_byte_array_append (buf, (const guint8 *) &value, sizeof (value));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+dircache_put_str (GByteArray *buf, const char *str)
+{
+    const guint32 len = str == NULL ? 0 : (guint32) strlen (str);
+
+    dircache_put_u32 (buf, len);
+    if (len != 0)
+        g_byte_array_append (buf, (const guint8 *) str, len);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+dircache_get (dircache_reader_t *r, void *value, gsize size)
+{
+    if (r->len - r->pos < size)
+        return FALSE;
+
+    memcpy (value, r->data + r->pos, size);
+    r->pos += size;
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Read string from snapshot. Empty string is returned as NULL.
+ *
+ * @return FALSE if data is truncated, TRUE otherwise
+ */
+
+static gboolean
+dircache_get_str (dircache_reader_t *r, char **str)
+{
+    guint32 len;
+
+    *str = NULL;
+
+    if (!dircache_get (r, &len, sizeof (len)) || r->len - r->pos < len)
+        return FALSE;
+
+    if (len != 0)
+    {
+        *str = g_strndup ((const char *) r->data + r->pos, len);
+        r->pos += len;
+    }
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+dircache_get_entry (struct vfs_class *me, dircache_reader_t *r, struct vfs_s_inode *dir)
+{
+    char *name, *linkname = NULL;
+    guint32 mode, nlink, uid, gid;
+    gint64 size, mtime, atime, ctime, rdev;
+    struct vfs_s_entry *ent;
+    struct stat *st;
+
+    if (!dircache_get_str (r, &name) || name == NULL)
+        return FALSE;
+
+    if (!dircache_get_str (r, &linkname) || !dircache_get (r, &mode, sizeof (mode))
+        || !dircache_get (r, &nlink, sizeof (nlink)) || !dircache_get (r, &uid, sizeof (uid))
+        || !dircache_get (r, &gid, sizeof (gid)) || !dircache_get (r, &size, sizeof (size))
+        || !dircache_get (r, &mtime, sizeof (mtime)) || !dircache_get (r, &atime, sizeof (atime))
+        || !dircache_get (r, &ctime, sizeof (ctime)) || !dircache_get (r, &rdev, sizeof (rdev)))
+    {
+        g_free (name);
+        g_free (linkname);
+        return FALSE;
+    }
+
+    ent = vfs_s_generate_entry (me, name, dir, (mode_t) mode);
+    g_free (name);
+
+    st = &ent->ino->st;
+    st->st_mode = (mode_t) mode;
+    st->st_uid = (uid_t) uid;
+    st->st_gid = (gid_t) gid;
+    st->st_size = (off_t) size;
+    st->st_mtime = (time_t) mtime;
+    st->st_atime = (time_t) atime;
+    st->st_ctime = (time_t) ctime;
+#ifdef HAVE_STRUCT_STAT_ST_RDEV
+    st->st_rdev = (dev_t) rdev;
+#else
+    (void) rdev;
+#endif
+    vfs_adjust_stat (st);
+    ent->ino->linkname = linkname;
+
+    vfs_s_insert_entry (me, dir, ent);
+    // link count as it was after the remote listing had been read
+    st->st_nlink = (nlink_t) nlink;
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Fill directory @dir from the snapshot of remote directory @path.
+ *
+ * @return TRUE if valid snapshot was found and loaded, FALSE otherwise.
+ *         In case of FALSE @dir is left empty.
+ */
+
+gboolean
+vfs_s_dircache_load (struct vfs_class *me, struct vfs_s_inode *root, struct vfs_s_inode *dir,
+                     const char *path)
+{
+    char *key, *filename;
+    gchar *contents = NULL;
+    gsize len = 0;
+    dircache_reader_t r;
+    char magic[sizeof (DIRCACHE_MAGIC) - 1];
+    guint32 version, count = 0;
+    char *stored_key = NULL;
+    gint64 dir_mtime, saved;
+    time_t mtime;
+    gint64 now;
+    gboolean ok;
+
+    if (!vfs_persistent_dircache)
+        return FALSE;
+
+    key = dircache_get_key (me, root, path);
+    if (key == NULL)
+        return FALSE;
+
+    filename = dircache_get_filename (key);
+    ok = g_file_get_contents (filename, &contents, &len, NULL);
+
+    if (ok)
+    {
+        r.data = (const guint8 *) contents;
+        r.len = len;
+        r.pos = 0;
+
+        ok = dircache_get (&r, magic, sizeof (magic))
+            && memcmp (magic, DIRCACHE_MAGIC, sizeof (magic)) == 0
+            && dircache_get (&r, &version, sizeof (version)) && version == DIRCACHE_VERSION
+            && dircache_get_str (&r, &stored_key) && stored_key != NULL
+            && strcmp (stored_key, key) == 0 && dircache_get (&r, &dir_mtime, sizeof (dir_mtime))
+            && dircache_get (&r, &saved, sizeof (saved))
+            && dircache_get (&r, &count, sizeof (count));
+        g_free (stored_key);
+    }
+
+    if (ok)
+    {
+        now = g_get_real_time () / G_USEC_PER_SEC;
+        ok = saved <= now && now - saved < DIRCACHE_MAX_AGE;
+    }
+
+    // directory was changed since snapshot was saved
+    if (ok && dircache_get_mtime (root, path, &mtime))
+        ok = (gint64) mtime == dir_mtime;
+
+    if (ok)
+    {
+        guint32 i;
+
+        vfs_print_message (_ ("%s: reading directory %s from local cache"), me->name, path);
+
+        for (i = 0; ok && i < count; i++)
+            ok = dircache_get_entry (me, &r, dir);
+
+        if (!ok)
+            while (!g_queue_is_empty (dir->subdir))
+            {
+                struct vfs_s_entry *ent;
+
+                ent = VFS_ENTRY (g_queue_peek_head (dir->subdir));
+                ent->ino->st.st_nlink = 1;
+                vfs_s_free_entry (me, ent);
+            }
+    }
+
+    if (ok)
+        dir->timestamp = g_get_monotonic_time () + DIRCACHE_REVALIDATE_TIMEOUT * G_USEC_PER_SEC;
+    else if (contents != NULL)
+        (void) unlink (filename);
+
+    g_free (contents);
+    g_free (filename);
+    g_free (key);
+
+    return ok;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Save snapshot of remote directory @path that has just been read to @dir.
+ */
+
+void
+vfs_s_dircache_save (struct vfs_class *me, struct vfs_s_inode *root, struct vfs_s_inode *dir,
+                     const char *path)
+{
+    char *key, *filename, *dirname;
+    time_t mtime = 0;
+    GByteArray *buf;
+    GList *iter;
+
+    if (!vfs_persistent_dircache)
+        return;
+
+    key = dircache_get_key (me, root, path);
+    if (key == NULL)
+        return;
+
+    (void) dircache_get_mtime (root, path, &mtime);
+
+    buf = g_byte_array_sized_new (64 + 64 * g_queue_get_length (dir->subdir));
+    g_byte_array_append (buf, (const guint8 *) DIRCACHE_MAGIC, sizeof (DIRCACHE_MAGIC) - 1);
+    dircache_put_u32 (buf, DIRCACHE_VERSION);
+    dircache_put_str (buf, key);
+    dircache_put_i64 (buf, (gint64) mtime);
+    dircache_put_i64 (buf, g_get_real_time () / G_USEC_PER_SEC);
+    dircache_put_u32 (buf, g_queue_get_length (dir->subdir));
+
+    for (iter = g_queue_peek_head_link (dir->subdir); iter != NULL; iter = g_list_next (iter))
+    {
+        const struct vfs_s_entry *ent = VFS_ENTRY (iter->data);
+        const struct stat *st = &ent->ino->st;
+
+        dircache_put_str (buf, ent->name);
+        dircache_put_str (buf, ent->ino->linkname);
+        dircache_put_u32 (buf, (guint32) st->st_mode);
+        dircache_put_u32 (buf, (guint32) st->st_nlink);
+        dircache_put_u32 (buf, (guint32) st->st_uid);
+        dircache_put_u32 (buf, (guint32) st->st_gid);
+        dircache_put_i64 (buf, (gint64) st->st_size);
+        dircache_put_i64 (buf, (gint64) st->st_mtime);
+        dircache_put_i64 (buf, (gint64) st->st_atime);
+        dircache_put_i64 (buf, (gint64) st->st_ctime);
+#ifdef HAVE_STRUCT_STAT_ST_RDEV
+        dircache_put_i64 (buf, (gint64) st->st_rdev);
+#else
+        dircache_put_i64 (buf, 0);
+#endif
+    }
+
+    filename = dircache_get_filename (key);
+    dirname = g_path_get_dirname (filename);
+
+    // listings of remote hosts are private
+    if (g_mkdir_with_parents (dirname, 0700) == 0)
+        (void) g_file_set_contents (filename, (const gchar *) buf->data, (gssize) buf->len, NULL);
+
+    g_free (dirname);
+    g_free (filename);
+    g_byte_array_free (buf, TRUE);
+    g_free (key);
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -243,6 +243,9 @@ vfs_s_find_entry_linear (struct vfs_class *me, struct vfs_s_inode *root, const c
     struct vfs_s_entry *ent = NULL;
     char *const path = g_strdup (a_path);
     GList *iter;
+#ifdef ENABLE_VFS_NET
+    gboolean expired = FALSE;
+#endif
 
     if (root->super->root != root)
         vfs_die ("We have to use _real_ root. Always. Sorry.");
@@ -275,6 +278,9 @@ vfs_s_find_entry_linear (struct vfs_class *me, struct vfs_s_inode *root, const c
 #endif
         vfs_s_free_entry (me, ent);
         ent = NULL;
+#ifdef ENABLE_VFS_NET
+        expired = TRUE;
+#endif
     }
 
     if (ent == NULL)
@@ -283,11 +289,20 @@ vfs_s_find_entry_linear (struct vfs_class *me, struct vfs_s_inode *root, const c
 
         ino = vfs_s_new_inode (me, root->super, vfs_s_default_stat (me, S_IFDIR | 0755));
         ent = vfs_s_new_entry (me, path, ino);
-        if (VFS_SUBCLASS (me)->dir_load (me, ino, path) == -1)
+#ifdef ENABLE_VFS_NET
+        // expired or flushed listing must be reread from the remote host
+        if (expired || me->flush || !vfs_s_dircache_load (me, root, ino, path))
+#endif
         {
-            vfs_s_free_entry (me, ent);
-            g_free (path);
-            return NULL;
+            if (VFS_SUBCLASS (me)->dir_load (me, ino, path) == -1)
+            {
+                vfs_s_free_entry (me, ent);
+                g_free (path);
+                return NULL;
+            }
+#ifdef ENABLE_VFS_NET
+            vfs_s_dircache_save (me, root, ino, path);
+#endif
         }
 
         vfs_s_insert_entry (me, root, ent);
@@ -635,6 +650,27 @@ vfs_s_lseek (void *fh, off_t offset, int whence)
     case SEEK_END:
         offset += size;
         break;
+#ifdef SEEK_DATA
+    case SEEK_DATA:
+    case SEEK_HOLE:
+    {
+        struct vfs_class *me = VFS_FILE_HANDLER_SUPER (fh)->me;
+
+        if (offset < 0 || offset >= size)
+            ERRNOR (ENXIO, -1);
+
+        if (VFS_SUBCLASS (me)->fh_seek_data != NULL)
+        {
+            offset = VFS_SUBCLASS (me)->fh_seek_data (me, file, offset, whence);
+            if (offset == -1)
+                return (-1);
+        }
+        else if (whence == SEEK_HOLE)
+            // file without holes
+            offset = size;
+        break;
+    }
+#endif
     default:
         break;
     }
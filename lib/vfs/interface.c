@@ -68,12 +68,17 @@ extern struct vfs_dirent *mc_readdir_result;
 
 /*** file scope macro definitions ****************************************************************/
 
+#define vfs_call_count(call) g_atomic_int_inc (&vfs_calls[call])
+
 /*** file scope type declarations ****************************************************************/
 
 /*** forward declarations (file scope functions) *************************************************/
 
 /*** file scope variables ************************************************************************/
 
+/* calls are counted from the main thread and from the threads reading files */
+static gint vfs_calls[VFS_CALL_COUNT];
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -197,6 +202,8 @@ mc_open (const vfs_path_t *vpath, int flags, ...)
     if (vpath == NULL)
         return (-1);
 
+    vfs_call_count (VFS_CALL_OPEN);
+
     // Get the mode flag
     if ((flags & O_CREAT) != 0)
     {
@@ -239,6 +246,8 @@ mc_open (const vfs_path_t *vpath, int flags, ...)
         if (vpath == NULL)                                                                         \
             return (-1);                                                                           \
                                                                                                    \
+        vfs_call_count (VFS_CALL_OTHER);                                                           \
+                                                                                                   \
         me = VFS_CLASS (vfs_path_get_last_path_vfs (vpath));                                       \
         if (me == NULL)                                                                            \
             return (-1);                                                                           \
@@ -271,6 +280,8 @@ mc_symlink (const vfs_path_t *vpath1, const vfs_path_t *vpath2)
     {
         struct vfs_class *me;
 
+        vfs_call_count (VFS_CALL_OTHER);
+
         me = VFS_CLASS (vfs_path_get_last_path_vfs (vpath2));
         if (me != NULL)
         {
@@ -284,7 +295,7 @@ mc_symlink (const vfs_path_t *vpath1, const vfs_path_t *vpath2)
 
 /* --------------------------------------------------------------------------------------------- */
 
-#define MC_HANDLEOP(rettype, name, inarg, callarg)                                                 \
+#define MC_HANDLEOP(rettype, name, inarg, callarg, call)                                           \
     rettype mc_##name inarg                                                                        \
     {                                                                                              \
         struct vfs_class *vfs;                                                                     \
@@ -294,6 +305,8 @@ mc_symlink (const vfs_path_t *vpath1, const vfs_path_t *vpath2)
         if (handle == -1)                                                                          \
             return (-1);                                                                           \
                                                                                                    \
+        vfs_call_count (call);                                                                     \
+                                                                                                   \
         vfs = vfs_class_find_by_handle (handle, &fsinfo);                                          \
         if (vfs == NULL)                                                                           \
             return (-1);                                                                           \
@@ -304,9 +317,11 @@ mc_symlink (const vfs_path_t *vpath1, const vfs_path_t *vpath2)
         return result;                                                                             \
     }
 
-MC_HANDLEOP (ssize_t, read, (int handle, void *buf, size_t count), (fsinfo, buf, count))
-MC_HANDLEOP (ssize_t, write, (int handle, const void *buf, size_t count), (fsinfo, buf, count))
-MC_HANDLEOP (int, fstat, (int handle, struct stat *buf), (fsinfo, buf))
+MC_HANDLEOP (ssize_t, read, (int handle, void *buf, size_t count), (fsinfo, buf, count),
+             VFS_CALL_READ)
+MC_HANDLEOP (ssize_t, write, (int handle, const void *buf, size_t count), (fsinfo, buf, count),
+             VFS_CALL_WRITE)
+MC_HANDLEOP (int, fstat, (int handle, struct stat *buf), (fsinfo, buf), VFS_CALL_STAT)
 
 /* --------------------------------------------------------------------------------------------- */
 
@@ -319,6 +334,8 @@ MC_HANDLEOP (int, fstat, (int handle, struct stat *buf), (fsinfo, buf))
         if (vpath1 == NULL || vpath2 == NULL)                                                      \
             return (-1);                                                                           \
                                                                                                    \
+        vfs_call_count (VFS_CALL_OTHER);                                                           \
+                                                                                                   \
         me1 = VFS_CLASS (vfs_path_get_last_path_vfs (vpath1));                                     \
         me2 = VFS_CLASS (vfs_path_get_last_path_vfs (vpath2));                                     \
                                                                                                    \
@@ -380,6 +397,8 @@ mc_close (int handle)
     if (handle == -1)
         return (-1);
 
+    vfs_call_count (VFS_CALL_OTHER);
+
     vfs = vfs_class_find_by_handle (handle, &fsinfo);
     if (vfs == NULL || fsinfo == NULL)
         return (-1);
@@ -409,6 +428,8 @@ mc_opendir (const vfs_path_t *vpath)
     if (vpath == NULL)
         return NULL;
 
+    vfs_call_count (VFS_CALL_DIR);
+
     path_element = (vfs_path_element_t *) vfs_path_get_by_index (vpath, -1);
     if (!vfs_path_element_valid (path_element))
     {
@@ -457,6 +478,8 @@ mc_readdir (DIR *dirp)
 
     handle = *(int *) dirp;
 
+    vfs_call_count (VFS_CALL_DIR);
+
     vfs = vfs_class_find_by_handle (handle, &fsinfo);
     if (vfs == NULL || fsinfo == NULL)
         return NULL;
@@ -491,6 +514,8 @@ mc_closedir (DIR *dirp)
     if (dirp == NULL)
         return result;
 
+    vfs_call_count (VFS_CALL_DIR);
+
     handle = *(int *) dirp;
 
     vfs = vfs_class_find_by_handle (handle, &fsinfo);
@@ -523,6 +548,8 @@ mc_closedir (DIR *dirp)
         if (vpath == NULL)                                                                         \
             return (-1);                                                                           \
                                                                                                    \
+        vfs_call_count (VFS_CALL_STAT);                                                            \
+                                                                                                   \
         me = VFS_CLASS (vfs_path_get_last_path_vfs (vpath));                                       \
         if (me != NULL)                                                                            \
         {                                                                                          \
@@ -687,6 +714,8 @@ mc_lseek (int fd, off_t offset, int whence)
     if (fd == -1)
         return (-1);
 
+    vfs_call_count (VFS_CALL_OTHER);
+
     vfs = vfs_class_find_by_handle (fd, &fsinfo);
     if (vfs == NULL)
         return (-1);
@@ -799,3 +828,20 @@ mc_tmpdir (void)
 }
 
 /* --------------------------------------------------------------------------------------------- */
+/**
+ * Get numbers of VFS calls since start of the program.  Calls of a file operation are
+ * the difference between the numbers got after and before the operation.
+ *
+ * @param calls array to store numbers of calls, indexed by vfs_call_t
+ */
+
+void
+vfs_calls_get (guint calls[VFS_CALL_COUNT])
+{
+    int i;
+
+    for (i = 0; i < VFS_CALL_COUNT; i++)
+        calls[i] = (guint) g_atomic_int_get (&vfs_calls[i]);
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -44,6 +44,7 @@
 #include <config.h>
 
 #include <errno.h>
+#include <fcntl.h>  // F_DUPFD_CLOEXEC
 #include <stdlib.h>
 
 #ifdef __linux__
@@ -53,7 +54,11 @@
 #ifdef HAVE_SYS_IOCTL_H
 #include <sys/ioctl.h>
 #endif
+#ifdef HAVE_SYS_SENDFILE_H
+#include <sys/sendfile.h>
 #endif
+#endif
+#include <unistd.h>  // copy_file_range()
 
 #include "lib/global.h"
 #include "lib/strutil.h"
@@ -760,3 +765,177 @@ vfs_clone_file (int dest_vfs_fd, int src_vfs_fd)
 }
 
 /* --------------------------------------------------------------------------------------------- */
+/**
+ * Copy up to @count bytes from current position of source file to current position of
+ * destination file without passing the data through user space.  Both files must be local.
+ *
+ * @method is the method to try.  If it is not supported for these files, the next one is tried
+ * and @method is updated, so that the following calls don't try unsupported methods again.
+ * VFS_COPY_DATA_NONE means that the data must be copied using mc_read() and mc_write().
+ *
+ * @return number of copied bytes, 0 at end of source file, -1 on error.
+ *         Note: some filesystems (e.g. procfs) return 0 even if the file has data,
+ *         so end of file should be confirmed by mc_read().
+ */
+
+ssize_t
+vfs_copy_data (int dest_vfs_fd, int src_vfs_fd, size_t count, vfs_copy_data_t *method)
+{
+    void *dest_fd = NULL;
+    void *src_fd = NULL;
+    struct vfs_class *dest_class;
+    struct vfs_class *src_class;
+
+    if (*method == VFS_COPY_DATA_NONE)
+    {
+        errno = ENOTSUP;
+        return (-1);
+    }
+
+    dest_class = vfs_class_find_by_handle (dest_vfs_fd, &dest_fd);
+    src_class = vfs_class_find_by_handle (src_vfs_fd, &src_fd);
+    if (dest_class == NULL || (dest_class->flags & VFSF_LOCAL) == 0 || dest_fd == NULL
+        || src_class == NULL || (src_class->flags & VFSF_LOCAL) == 0 || src_fd == NULL)
+    {
+        *method = VFS_COPY_DATA_NONE;
+        errno = ENOTSUP;
+        return (-1);
+    }
+
+#ifdef HAVE_COPY_FILE_RANGE
+    if (*method == VFS_COPY_DATA_RANGE)
+    {
+        ssize_t ret;
+
+        ret = copy_file_range (*(int *) src_fd, NULL, *(int *) dest_fd, NULL, count, 0);
+        if (ret >= 0)
+            return ret;
+
+        // not supported for these files: different filesystems on old kernels, O_APPEND, etc
+        if (errno != ENOSYS && errno != EXDEV && errno != EINVAL && errno != EBADF
+            && errno != EOPNOTSUPP && errno != ENOTSUP)
+            return (-1);
+    }
+#endif
+
+#if defined(__linux__) && defined(HAVE_SYS_SENDFILE_H)
+    if (*method != VFS_COPY_DATA_NONE)
+    {
+        ssize_t ret;
+
+        *method = VFS_COPY_DATA_SENDFILE;
+
+        ret = sendfile (*(int *) dest_fd, *(int *) src_fd, NULL, count);
+        if (ret >= 0)
+            return ret;
+
+        if (errno != ENOSYS && errno != EINVAL && errno != EOPNOTSUPP && errno != ENOTSUP)
+            return (-1);
+    }
+#else
+    (void) count;
+#endif
+
+    *method = VFS_COPY_DATA_NONE;
+    errno = ENOTSUP;
+    return (-1);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Move current positions of source and destination files over the hole of source file, if any.
+ * The hole is not written, so the destination file is sparse as well.  The source file can be
+ * on any VFS which supports SEEK_DATA and SEEK_HOLE, the destination file must be local.
+ *
+ * @param data_len size of data at new position of source file, 0 at end of file
+ *
+ * @return size of skipped hole, -1 on error
+ */
+
+off_t
+vfs_skip_hole (int dest_vfs_fd, int src_vfs_fd, off_t *data_len)
+{
+#ifdef SEEK_DATA
+    void *dest_fd = NULL;
+    struct vfs_class *dest_class;
+    off_t pos, data, hole;
+
+    dest_class = vfs_class_find_by_handle (dest_vfs_fd, &dest_fd);
+    if (dest_class == NULL || (dest_class->flags & VFSF_LOCAL) == 0 || dest_fd == NULL)
+    {
+        errno = ENOTSUP;
+        return (-1);
+    }
+
+    pos = mc_lseek (src_vfs_fd, 0, SEEK_CUR);
+    if (pos == -1)
+        return (-1);
+
+    data = mc_lseek (src_vfs_fd, pos, SEEK_DATA);
+    if (data != -1)
+        hole = mc_lseek (src_vfs_fd, data, SEEK_HOLE);
+    else
+    {
+        struct stat st;
+
+        // no data until end of file
+        if (errno != ENXIO || mc_fstat (src_vfs_fd, &st) != 0)
+            return (-1);
+
+        data = hole = MAX (st.st_size, pos);
+    }
+
+    // SEEK_HOLE moves the position
+    if (hole == -1 || mc_lseek (src_vfs_fd, data, SEEK_SET) != data)
+        return (-1);
+
+    if (data != pos)
+    {
+        off_t dest_pos;
+
+        dest_pos = lseek (*(int *) dest_fd, data - pos, SEEK_CUR);
+        if (dest_pos == -1)
+            return (-1);
+
+        // hole at end of file: set the size without writing
+        if (data == hole && ftruncate (*(int *) dest_fd, dest_pos) != 0)
+            return (-1);
+    }
+
+    *data_len = hole - data;
+    return data - pos;
+#else
+    (void) dest_vfs_fd;
+    (void) src_vfs_fd;
+    (void) data_len;
+
+    errno = ENOTSUP;
+    return (-1);
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Duplicate descriptor of local file, e.g. to read the file with pread() after it is closed.
+ * The new descriptor is not inherited by executed programs.
+ *
+ * VFS functions must be called from the main thread only.  Other threads can access local
+ * files by descriptors got here.
+ *
+ * @return new descriptor to be closed with close(), -1 if the file is not local
+ */
+
+int
+vfs_dup_local_fd (int vfs_fd)
+{
+    void *fd = NULL;
+    struct vfs_class *class;
+
+    class = vfs_class_find_by_handle (vfs_fd, &fd);
+    if (class == NULL || (class->flags & VFSF_LOCAL) == 0 || fd == NULL)
+        return (-1);
+
+    return fcntl (*(int *) fd, F_DUPFD_CLOEXEC, 0);
+}
+
+/* --------------------------------------------------------------------------------------------- */
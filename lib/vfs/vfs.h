@@ -133,6 +133,26 @@ enum
     VFS_SETCTL_STALE_DATA
 };
 
+/* Methods of in-kernel copy of file data, see vfs_copy_data() */
+typedef enum
+{
+    VFS_COPY_DATA_RANGE = 0,  // copy_file_range()
+    VFS_COPY_DATA_SENDFILE,   // sendfile()
+    VFS_COPY_DATA_NONE        // not supported, use mc_read() and mc_write()
+} vfs_copy_data_t;
+
+/* Calls of VFS interface counted to measure file operations, see vfs_calls_get() */
+typedef enum
+{
+    VFS_CALL_OPEN = 0,  // mc_open()
+    VFS_CALL_READ,      // mc_read()
+    VFS_CALL_WRITE,     // mc_write()
+    VFS_CALL_STAT,      // mc_stat(), mc_lstat(), mc_fstat()
+    VFS_CALL_DIR,       // mc_opendir(), mc_readdir(), mc_closedir()
+    VFS_CALL_OTHER,     // mc_close(), mc_lseek(), mc_unlink(), mc_mkdir() and other calls
+    VFS_CALL_COUNT
+} vfs_call_t;
+
 /*** structures declarations (and typedefs of structures)*****************************************/
 
 typedef struct vfs_class
@@ -227,6 +247,7 @@ extern int vfs_timeout;
 
 #ifdef ENABLE_VFS_NET
 extern int use_netrc;
+extern gboolean vfs_persistent_dircache;
 #endif
 
 /*** declarations of public functions ************************************************************/
@@ -301,6 +322,9 @@ char *vfs_get_cwd (void);
 int vfs_preallocate (int dest_desc, off_t src_fsize, off_t dest_fsize);
 
 int vfs_clone_file (int dest_vfs_fd, int src_vfs_fd);
+ssize_t vfs_copy_data (int dest_vfs_fd, int src_vfs_fd, size_t count, vfs_copy_data_t *method);
+off_t vfs_skip_hole (int dest_vfs_fd, int src_vfs_fd, off_t *data_len);
+int vfs_dup_local_fd (int vfs_fd);
 
 /**
  * Interface functions described in interface.c
@@ -340,6 +364,8 @@ int mc_mkstemps (vfs_path_t **pname_vpath, const char *prefix, const char *suffi
 /* Creating temporary files safely */
 const char *mc_tmpdir (void);
 
+void vfs_calls_get (guint calls[VFS_CALL_COUNT]);
+
 /*** inline functions ****************************************************************************/
 
 #endif
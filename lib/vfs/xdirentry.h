@@ -141,6 +141,9 @@ struct vfs_s_subclass
     int (*fh_open) (struct vfs_class *me, vfs_file_handler_t *fh, int flags, mode_t mode);
     int (*fh_close) (struct vfs_class *me, vfs_file_handler_t *fh);
     void (*fh_free) (vfs_file_handler_t *fh);
+    // optional: SEEK_DATA and SEEK_HOLE in files with holes, offset is inside the file
+    off_t (*fh_seek_data) (struct vfs_class *me, vfs_file_handler_t *fh, off_t offset,
+                           int whence);
 
     struct vfs_s_entry *(*find_entry) (struct vfs_class *me, struct vfs_s_inode *root,
                                        const char *path, int follow, int flags);
@@ -182,6 +185,14 @@ const char *vfs_s_get_path (const vfs_path_t *vpath, struct vfs_s_super **archiv
 struct vfs_s_super *vfs_get_super_by_vpath (const vfs_path_t *vpath);
 
 void vfs_s_invalidate (struct vfs_class *me, struct vfs_s_super *super);
+
+#ifdef ENABLE_VFS_NET
+/* lib/vfs/dircache.c: */
+gboolean vfs_s_dircache_load (struct vfs_class *me, struct vfs_s_inode *root,
+                              struct vfs_s_inode *dir, const char *path);
+void vfs_s_dircache_save (struct vfs_class *me, struct vfs_s_inode *root, struct vfs_s_inode *dir,
+                          const char *path);
+#endif
 char *vfs_s_fullpath (struct vfs_class *me, struct vfs_s_inode *ino);
 
 void vfs_s_init_fh (vfs_file_handler_t *fh, struct vfs_s_inode *ino, gboolean changed);
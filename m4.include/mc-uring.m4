@@ -0,0 +1,45 @@
+dnl
+dnl Support for batched file operations using io_uring on Linux
+dnl
+dnl if --enable-uring is specified and the library is not found, configure fails.
+dnl If --enable-uring is not specified and the library is not found, configure continues silently.
+
+AC_DEFUN([mc_URING],
+[
+    URING_MIN_VERSION="2.0"
+
+    AC_ARG_ENABLE([uring],
+        AS_HELP_STRING([--enable-uring],
+        [Batch deletion of local files using io_uring @<:@yes@:>@]),
+        [
+            if test "x$enableval" = xno; then
+                enable_uring=no
+            else
+                enable_uring=yes
+            fi
+        ],
+        [enable_uring=auto])
+
+    case "x$enable_uring" in
+        xyes|xauto)
+            PKG_CHECK_MODULES(URING, [liburing >= $URING_MIN_VERSION], [found_uring=yes], [:])
+
+            if test x"$found_uring" = "xyes"; then
+                uring_msg="yes"
+                AC_DEFINE(ENABLE_URING, 1, [Define to enable batched file operations using io_uring])
+                MCLIBS="$MCLIBS $URING_LIBS"
+                CPPFLAGS="$CPPFLAGS $URING_CFLAGS"
+            else
+                if test "x$enable_uring" = "xyes"; then
+                    AC_MSG_ERROR([liburing not found or version too old ($URING_MIN_VERSION or higher is required)])
+                fi
+                uring_msg="no"
+            fi
+            ;;
+        *)
+            uring_msg="no"
+            ;;
+    esac
+
+    AM_CONDITIONAL(ENABLE_URING, [test "x$uring_msg" = "xyes"])
+])
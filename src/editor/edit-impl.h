@@ -41,9 +41,6 @@
 #define EDIT_TOP_EXTREME            0
 #define EDIT_BOTTOM_EXTREME         0
 
-/* Initial size of the undo stack, in bytes */
-#define START_STACK_SIZE 32
-
 /* Some codes that may be pushed onto or returned from the undo stack */
 #define CURS_LEFT       601
 #define CURS_RIGHT      602
@@ -61,6 +58,10 @@
 #define MARK_CURS       1000000000
 #define KEY_PRESS       1500000000
 
+/* Actions whose bytes are kept in the undo log */
+#define INSERT_BYTES       0
+#define INSERT_AHEAD_BYTES 256
+
 /* Tabs spaces: (sofar only HALF_TAB_SIZE is used: */
 #define TAB_SIZE      option_tab_spacing
 #define HALF_TAB_SIZE ((int) option_tab_spacing / 2)
@@ -144,14 +145,17 @@ gboolean edit_block_delete_cmd (WEdit *edit);
 void edit_delete_line (WEdit *edit);
 
 int edit_delete (WEdit *edit, gboolean byte_delete);
+void edit_delete_bytes (WEdit *edit, off_t len, char *bytes);
+void edit_backspace_bytes (WEdit *edit, off_t len);
 int edit_backspace (WEdit *edit, gboolean byte_delete);
 void edit_insert (WEdit *edit, int c);
+void edit_insert_bytes (WEdit *edit, const char *s, off_t len);
 void edit_insert_over (WEdit *edit);
 void edit_cursor_move (WEdit *edit, off_t increment);
 void edit_push_undo_action (WEdit *edit, long c);
-void edit_push_redo_action (WEdit *edit, long c);
 void edit_push_key_press (WEdit *edit);
 void edit_insert_ahead (WEdit *edit, int c);
+void edit_insert_ahead_bytes (WEdit *edit, const char *s, off_t len);
 off_t edit_write_stream (WEdit *edit, FILE *f);
 char *edit_get_write_filter (const vfs_path_t *write_name_vpath, const vfs_path_t *filename_vpath);
 gboolean edit_save_confirm_cmd (WEdit *edit);
@@ -269,11 +269,15 @@ edit_get_filter (const vfs_path_t *filename_vpath)
 static off_t
 edit_insert_stream (WEdit *edit, FILE *f)
 {
-    int c;
-    off_t i;
+    char buf[TEMP_BUF_LEN];
+    size_t n;
+    off_t i = 0;
 
-    for (i = 0; (c = fgetc (f)) >= 0; i++)
-        edit_insert (edit, c);
+    while ((n = fread (buf, 1, sizeof (buf), f)) > 0)
+    {
+        edit_insert_bytes (edit, buf, (off_t) n);
+        i += (off_t) n;
+    }
 
     return i;
 }
@@ -446,6 +450,8 @@ edit_load_file (WEdit *edit)
                 return FALSE;
             }
             edit->undo_stack_disable = 0;
+            // actions of loading are not redone
+            edit_undo_log_reset (&edit->redo_log);
         }
     }
     edit->lb = LB_ASIS;
@@ -525,73 +531,43 @@ edit_purge_widget (WEdit *edit)
 
 /* --------------------------------------------------------------------------------------------- */
 
-/*
-   TODO: if the user undos until the stack bottom, and the stack has not wrapped,
-   then the file should be as it was when he loaded up. Then set edit->modified to 0.
+/**
+ * Get the log which actions are pushed onto: the redo log while actions are undone.
  */
 
-static long
-edit_pop_undo_action (WEdit *edit)
+static edit_undo_log_t *
+edit_get_undo_log (WEdit *edit)
 {
-    long c;
-    unsigned long sp = edit->undo_stack_pointer;
-
-    if (sp == edit->undo_stack_bottom)
-        return STACK_BOTTOM;
-
-    sp = (sp - 1) & edit->undo_stack_size_mask;
-    c = edit->undo_stack[sp];
-    if (c >= 0)
-    {
-        //      edit->undo_stack[sp] = '@';
-        edit->undo_stack_pointer = (edit->undo_stack_pointer - 1) & edit->undo_stack_size_mask;
-        return c;
-    }
-
-    if (sp == edit->undo_stack_bottom)
-        return STACK_BOTTOM;
+    if (edit->undo_stack_disable)
+        return &edit->redo_log;
 
-    c = edit->undo_stack[(sp - 1) & edit->undo_stack_size_mask];
-    if (edit->undo_stack[sp] == -2)
-    {
-        //      edit->undo_stack[sp] = '@';
-        edit->undo_stack_pointer = sp;
-    }
-    else
-        edit->undo_stack[sp]++;
+    if (edit->redo_stack_reset)
+        edit_undo_log_reset (&edit->redo_log);
 
-    return c;
+    return &edit->undo_log;
 }
 
 /* --------------------------------------------------------------------------------------------- */
 
-static long
-edit_pop_redo_action (WEdit *edit)
+static void
+edit_push_undo_actions (WEdit *edit, long c, off_t count)
 {
-    long c;
-    unsigned long sp = edit->redo_stack_pointer;
-
-    if (sp == edit->redo_stack_bottom)
-        return STACK_BOTTOM;
-
-    sp = (sp - 1) & edit->redo_stack_size_mask;
-    c = edit->redo_stack[sp];
-    if (c >= 0)
-    {
-        edit->redo_stack_pointer = (edit->redo_stack_pointer - 1) & edit->redo_stack_size_mask;
-        return c;
-    }
-
-    if (sp == edit->redo_stack_bottom)
-        return STACK_BOTTOM;
+    edit_undo_log_push (edit_get_undo_log (edit), c, count);
+}
 
-    c = edit->redo_stack[(sp - 1) & edit->redo_stack_size_mask];
-    if (edit->redo_stack[sp] == -2)
-        edit->redo_stack_pointer = sp;
-    else
-        edit->redo_stack[sp]++;
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Push bytes to be inserted by undo.
+ *
+ * @param c INSERT_BYTES or INSERT_AHEAD_BYTES
+ * @param s bytes in the order edit_insert() or edit_insert_ahead() should be called for them
+ * @param len number of bytes
+ */
 
-    return c;
+static void
+edit_push_undo_bytes (WEdit *edit, long c, const char *s, off_t len)
+{
+    edit_undo_log_push_bytes (edit_get_undo_log (edit), c, s, len);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -599,22 +575,11 @@ edit_pop_redo_action (WEdit *edit)
 static long
 get_prev_undo_action (WEdit *edit)
 {
-    long c;
-    unsigned long sp = edit->undo_stack_pointer;
-
-    if (sp == edit->undo_stack_bottom)
-        return STACK_BOTTOM;
-
-    sp = (sp - 1) & edit->undo_stack_size_mask;
-    c = edit->undo_stack[sp];
-    if (c >= 0)
-        return c;
+    const edit_undo_record_t *record;
 
-    if (sp == edit->undo_stack_bottom)
-        return STACK_BOTTOM;
+    record = edit_undo_log_last (&edit->undo_log);
 
-    c = edit->undo_stack[(sp - 1) & edit->undo_stack_size_mask];
-    return c;
+    return record == NULL ? STACK_BOTTOM : record->action;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -623,8 +588,6 @@ get_prev_undo_action (WEdit *edit)
 static void
 edit_modification (WEdit *edit)
 {
-    edit->caches_valid = FALSE;
-
     // raise lock when file modified
     if (edit->modified == 0 && edit->delete_file == 0)
         edit->locked = lock_file (edit->filename_vpath);
@@ -686,51 +649,7 @@ is_blank (const edit_buffer_t *buf, off_t offset)
 static off_t
 edit_find_line (WEdit *edit, long line)
 {
-    long i;
-    long j = 0;
-    long m = 2000000000;  // what is the magic number?
-
-    if (!edit->caches_valid)
-    {
-        memset (edit->line_numbers, 0, sizeof (edit->line_numbers));
-        memset (edit->line_offsets, 0, sizeof (edit->line_offsets));
-        // three offsets that we *know* are line 0 at 0 and these two:
-        edit->line_numbers[1] = edit->buffer.curs_line;
-        edit->line_offsets[1] = edit_buffer_get_current_bol (&edit->buffer);
-        edit->line_numbers[2] = edit->buffer.lines;
-        edit->line_offsets[2] = edit_buffer_get_bol (&edit->buffer, edit->buffer.size);
-        edit->caches_valid = TRUE;
-    }
-    if (line >= edit->buffer.lines)
-        return edit->line_offsets[2];
-    if (line <= 0)
-        return 0;
-    // find the closest known point
-    for (i = 0; i < N_LINE_CACHES; i++)
-    {
-        long n;
-
-        n = labs (edit->line_numbers[i] - line);
-        if (n < m)
-        {
-            m = n;
-            j = i;
-        }
-    }
-    if (m == 0)
-        return edit->line_offsets[j];  // know the offset exactly
-    if (m == 1 && j >= 3)
-        i = j;  // one line different - caller might be looping, so stay in this cache
-    else
-        i = 3 + (rand () % (N_LINE_CACHES - 3));
-    if (line > edit->line_numbers[j])
-        edit->line_offsets[i] = edit_buffer_get_forward_offset (
-            &edit->buffer, edit->line_offsets[j], line - edit->line_numbers[j], 0);
-    else
-        edit->line_offsets[i] = edit_buffer_get_backward_offset (
-            &edit->buffer, edit->line_offsets[j], edit->line_numbers[j] - line);
-    edit->line_numbers[i] = line;
-    return edit->line_offsets[i];
+    return edit_buffer_get_line_offset (&edit->buffer, line);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -1145,175 +1064,167 @@ edit_left_delete_word (WEdit *edit)
 }
 
 /* --------------------------------------------------------------------------------------------- */
-/**
-   the start column position is not recorded, and hence does not
-   undo as it happed. But who would notice.
- */
+/** insert bytes pushed for undo by edit_backspace(): the last one is the first in the text */
 
 static void
-edit_do_undo (WEdit *edit)
+edit_insert_pushed_bytes (WEdit *edit, const char *s, off_t len)
 {
-    long ac;
-    long count = 0;
-
-    edit->undo_stack_disable = 1;  // don't record undo's onto undo stack!
-    edit->over_col = 0;
+    char chunk[TEMP_BUF_LEN];
 
-    while ((ac = edit_pop_undo_action (edit)) < KEY_PRESS)
+    while (len > 0)
     {
-        off_t b;
+        off_t n, i;
 
-        switch ((int) ac)
-        {
-        case STACK_BOTTOM:
-            goto done_undo;
-        case CURS_RIGHT:
-            edit_cursor_move (edit, 1);
-            break;
-        case CURS_LEFT:
-            edit_cursor_move (edit, -1);
-            break;
-        case BACKSPACE:
-        case BACKSPACE_BR:
-            edit_backspace (edit, TRUE);
-            break;
-        case DELCHAR:
-        case DELCHAR_BR:
-            edit_delete (edit, TRUE);
-            break;
-        case COLUMN_ON:
-            edit->column_highlight = 1;
-            break;
-        case COLUMN_OFF:
-            edit->column_highlight = 0;
-            break;
-        default:
-            break;
-        }
-        if (ac >= 256 && ac < 512)
-            edit_insert_ahead (edit, ac - 256);
-        if (ac >= 0 && ac < 256)
-            edit_insert (edit, ac);
+        n = MIN (len, TEMP_BUF_LEN);
+        for (i = 0; i < n; i++)
+            chunk[i] = s[len - 1 - i];
 
-        if (ac >= MARK_1 - 2 && ac < MARK_2 - 2)
-        {
-            edit->mark1 = ac - MARK_1;
-            b = edit_buffer_get_bol (&edit->buffer, edit->mark1);
-            edit->column1 = (long) edit_move_forward3 (edit, b, 0, edit->mark1);
-        }
-        if (ac >= MARK_2 - 2 && ac < MARK_CURS - 2)
-        {
-            edit->mark2 = ac - MARK_2;
-            b = edit_buffer_get_bol (&edit->buffer, edit->mark2);
-            edit->column2 = (long) edit_move_forward3 (edit, b, 0, edit->mark2);
-        }
-        else if (ac >= MARK_CURS - 2 && ac < KEY_PRESS)
-        {
-            edit->end_mark_curs = ac - MARK_CURS;
-        }
-        if (count++)
-            edit->force |= REDRAW_PAGE;  // more than one pop usually means something big
+        edit_insert_bytes (edit, chunk, n);
+        len -= n;
     }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+edit_apply_undo_record (WEdit *edit, const edit_undo_record_t *record, const char *bytes)
+{
+    const long ac = record->action;
+    off_t b;
 
-    if (edit->start_display > ac - KEY_PRESS)
+    if (record->bytes)
     {
-        edit->start_line -=
-            edit_buffer_count_lines (&edit->buffer, ac - KEY_PRESS, edit->start_display);
-        edit->force |= REDRAW_PAGE;
+        if (ac == INSERT_AHEAD_BYTES)
+            edit_insert_ahead_bytes (edit, bytes, record->count);
+        else
+            edit_insert_pushed_bytes (edit, bytes, record->count);
+        return;
     }
-    else if (edit->start_display < ac - KEY_PRESS)
+
+    switch ((int) ac)
     {
-        edit->start_line +=
-            edit_buffer_count_lines (&edit->buffer, edit->start_display, ac - KEY_PRESS);
-        edit->force |= REDRAW_PAGE;
+    case CURS_RIGHT:
+        edit_cursor_move (edit, record->count);
+        break;
+    case CURS_LEFT:
+        edit_cursor_move (edit, -record->count);
+        break;
+    case BACKSPACE:
+    case BACKSPACE_BR:
+        edit_backspace_bytes (edit, record->count);
+        break;
+    case DELCHAR:
+    case DELCHAR_BR:
+        edit_delete_bytes (edit, record->count, NULL);
+        break;
+    case COLUMN_ON:
+        edit->column_highlight = 1;
+        break;
+    case COLUMN_OFF:
+        edit->column_highlight = 0;
+        break;
+    default:
+        break;
     }
-    edit->start_display = ac - KEY_PRESS;  // see push and pop above
-    edit_update_curs_row (edit);
 
-done_undo:
-    edit->undo_stack_disable = 0;
+    if (ac >= MARK_1 - 2 && ac < MARK_2 - 2)
+    {
+        edit->mark1 = ac - MARK_1;
+        b = edit_buffer_get_bol (&edit->buffer, edit->mark1);
+        edit->column1 = (long) edit_move_forward3 (edit, b, 0, edit->mark1);
+    }
+    else if (ac >= MARK_2 - 2 && ac < MARK_CURS - 2)
+    {
+        edit->mark2 = ac - MARK_2;
+        b = edit_buffer_get_bol (&edit->buffer, edit->mark2);
+        edit->column2 = (long) edit_move_forward3 (edit, b, 0, edit->mark2);
+    }
+    else if (ac >= MARK_CURS - 2 && ac < KEY_PRESS)
+        edit->end_mark_curs = ac - MARK_CURS;
 }
 
 /* --------------------------------------------------------------------------------------------- */
+/**
+ * Apply records popped from undo or redo log up to the record of key press.
+ */
 
 static void
-edit_do_redo (WEdit *edit)
+edit_apply_undo_log (WEdit *edit, edit_undo_log_t *log)
 {
-    long ac;
-    long count = 0;
+    edit_undo_record_t record;
+    const char *bytes;
+    off_t count = 0;
+    off_t start_display;
 
-    if (edit->redo_stack_reset)
-        return;
-
-    edit->over_col = 0;
-
-    while ((ac = edit_pop_redo_action (edit)) < KEY_PRESS)
+    while (TRUE)
     {
-        off_t b;
+        if (!edit_undo_log_pop (log, &record, &bytes))
+            return;
 
-        switch ((int) ac)
-        {
-        case STACK_BOTTOM:
-            goto done_redo;
-        case CURS_RIGHT:
-            edit_cursor_move (edit, 1);
-            break;
-        case CURS_LEFT:
-            edit_cursor_move (edit, -1);
-            break;
-        case BACKSPACE:
-            edit_backspace (edit, TRUE);
-            break;
-        case DELCHAR:
-            edit_delete (edit, TRUE);
-            break;
-        case COLUMN_ON:
-            edit->column_highlight = 1;
-            break;
-        case COLUMN_OFF:
-            edit->column_highlight = 0;
-            break;
-        default:
+        if (record.action >= KEY_PRESS)
             break;
-        }
-        if (ac >= 256 && ac < 512)
-            edit_insert_ahead (edit, ac - 256);
-        if (ac >= 0 && ac < 256)
-            edit_insert (edit, ac);
 
-        if (ac >= MARK_1 - 2 && ac < MARK_2 - 2)
-        {
-            edit->mark1 = ac - MARK_1;
-            b = edit_buffer_get_bol (&edit->buffer, edit->mark1);
-            edit->column1 = (long) edit_move_forward3 (edit, b, 0, edit->mark1);
-        }
-        else if (ac >= MARK_2 - 2 && ac < KEY_PRESS)
-        {
-            edit->mark2 = ac - MARK_2;
-            b = edit_buffer_get_bol (&edit->buffer, edit->mark2);
-            edit->column2 = (long) edit_move_forward3 (edit, b, 0, edit->mark2);
-        }
-        // more than one pop usually means something big
-        if (count++ != 0)
+        edit_apply_undo_record (edit, &record, bytes);
+
+        // more than one action usually means something big
+        count += record.count;
+        if (count > 1)
             edit->force |= REDRAW_PAGE;
     }
 
-    if (edit->start_display > ac - KEY_PRESS)
+    start_display = record.action - KEY_PRESS;
+
+    if (edit->start_display > start_display)
     {
         edit->start_line -=
-            edit_buffer_count_lines (&edit->buffer, ac - KEY_PRESS, edit->start_display);
+            edit_buffer_count_lines (&edit->buffer, start_display, edit->start_display);
         edit->force |= REDRAW_PAGE;
     }
-    else if (edit->start_display < ac - KEY_PRESS)
+    else if (edit->start_display < start_display)
     {
         edit->start_line +=
-            edit_buffer_count_lines (&edit->buffer, edit->start_display, ac - KEY_PRESS);
+            edit_buffer_count_lines (&edit->buffer, edit->start_display, start_display);
         edit->force |= REDRAW_PAGE;
     }
-    edit->start_display = ac - KEY_PRESS;  // see push and pop above
+    edit->start_display = start_display;  // see edit_push_undo_action()
     edit_update_curs_row (edit);
+}
 
-done_redo:;
+/* --------------------------------------------------------------------------------------------- */
+/**
+   the start column position is not recorded, and hence does not
+   undo as it happed. But who would notice.
+ */
+
+static void
+edit_do_undo (WEdit *edit)
+{
+    edit->over_col = 0;
+
+    if (edit_undo_log_last (&edit->undo_log) == NULL)
+        return;
+
+    // redo of the actions below restores the display as it is now
+    edit_undo_log_push (&edit->redo_log, KEY_PRESS + edit->start_display, 1);
+
+    edit->undo_stack_disable = 1;  // don't record undo's onto undo stack!
+
+    edit_apply_undo_log (edit, &edit->undo_log);
+
+    edit->undo_stack_disable = 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+edit_do_redo (WEdit *edit)
+{
+    if (edit->redo_stack_reset)
+        return;
+
+    edit->over_col = 0;
+
+    edit_apply_undo_log (edit, &edit->redo_log);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -2034,13 +1945,8 @@ edit_insert_file (WEdit *edit, const vfs_path_t *filename_vpath)
         }
         else
         {
-            off_t i;
-
             while ((blocklen = mc_read (file, (char *) buf, TEMP_BUF_LEN)) > 0)
-            {
-                for (i = 0; i < blocklen; i++)
-                    edit_insert (edit, buf[i]);
-            }
+                edit_insert_bytes (edit, buf, blocklen);
             // highlight inserted text then not persistent blocks
             if (!edit_options.persistent_selections && edit->modified != 0)
             {
@@ -2146,13 +2052,8 @@ edit_init (WEdit *edit, const WRect *r, const edit_arg_t *arg)
         line = 0;
     }
 
-    edit->undo_stack_size = START_STACK_SIZE;
-    edit->undo_stack_size_mask = START_STACK_SIZE - 1;
-    edit->undo_stack = g_malloc0 ((edit->undo_stack_size + 10) * sizeof (long));
-
-    edit->redo_stack_size = START_STACK_SIZE;
-    edit->redo_stack_size_mask = START_STACK_SIZE - 1;
-    edit->redo_stack = g_malloc0 ((edit->redo_stack_size + 10) * sizeof (long));
+    edit_undo_log_init (&edit->undo_log, KEY_PRESS, (guint) MAX (max_undo, 256));
+    edit_undo_log_init (&edit->redo_log, KEY_PRESS, (guint) MAX (max_undo, 256));
 
     edit->utf8 = FALSE;
     edit->converter = str_cnv_from_term;
@@ -2217,8 +2118,8 @@ edit_clean (WEdit *edit)
 
     edit_buffer_clean (&edit->buffer);
 
-    g_free (edit->undo_stack);
-    g_free (edit->redo_stack);
+    edit_undo_log_clean (&edit->undo_log);
+    edit_undo_log_clean (&edit->redo_log);
     vfs_path_free (edit->filename_vpath, TRUE);
     vfs_path_free (edit->dir_vpath, TRUE);
     edit_search_deinit (edit);
@@ -2294,35 +2195,22 @@ edit_set_codeset (WEdit *edit)
 /* --------------------------------------------------------------------------------------------- */
 
 /**
- * Recording stack for undo:
- * The following is an implementation of a compressed stack. Identical
- * pushes are recorded by a negative prefix indicating the number of times the
- * same char was pushed. This saves space for repeated curs-left or curs-right
- * delete etc.
- *
- * eg:
+ * Recording log for undo:
+ * The log is a stack of records, see editundo.c. Identical pushes are
+ * recorded by one record with the number of times the same action was
+ * pushed. This saves space for repeated curs-left or curs-right delete etc.
  *
- * pushed:       stored:
- *
- * a
- * b             a
- * b            -3
- * b             b
- * c  -->       -4
- * c             c
- * c             d
- * c
- * d
- *
- * If the stack long int is 0-255 it represents a normal insert (from a backspace),
- * 256-512 is an insert ahead (from a delete), If it is between 600 and 700 it is one
- * of the cursor functions define'd in edit-impl.h. 1000 through 700'000'000 is to
- * set edit->mark1 position. 700'000'000 through 1400'000'000 is to set edit->mark2
- * position.
+ * If the action is 0-255 it represents a normal insert (from a backspace),
+ * 256-512 is an insert ahead (from a delete). Bytes to be inserted are kept
+ * in the log and their record is INSERT_BYTES or INSERT_AHEAD_BYTES. If it
+ * is between 600 and 700 it is one of the cursor functions define'd in
+ * edit-impl.h. MARK_1 through MARK_2 is to set edit->mark1 position, MARK_2
+ * through MARK_CURS is to set edit->mark2 position, MARK_CURS through
+ * KEY_PRESS is to set edit->end_mark_curs position.
  *
  * The only way the cursor moves or the buffer is changed is through the routines:
  * insert, backspace, insert_ahead, delete, and cursor_move.
- * These record the reverse undo movements onto the stack each time they are
+ * These record the reverse undo movements onto the log each time they are
  * called.
  *
  * Each key press results in a set of actions (insert; delete ...). So each time
@@ -2331,7 +2219,7 @@ edit_set_codeset (WEdit *edit)
  * over KEY_PRESS. We then assign this number less KEY_PRESS to start_display. So undo
  * tracks scrolling and key actions exactly. (KEY_PRESS is about (2^31) * (2/3) = 1400'000'000)
  *
- *
+ * While actions are undone, their reverse actions are recorded onto the redo log.
  *
  * @param edit editor object
  * @param c code of the action
@@ -2340,173 +2228,14 @@ edit_set_codeset (WEdit *edit)
 void
 edit_push_undo_action (WEdit *edit, long c)
 {
-    unsigned long sp = edit->undo_stack_pointer;
-    unsigned long spm1;
-
-    // first enlarge the stack if necessary
-    if (sp > edit->undo_stack_size - 10)
-    {  // say
-        if (max_undo < 256)
-            max_undo = 256;
-        if (edit->undo_stack_size < (unsigned long) max_undo)
-        {
-            long *t;
-
-            t = g_realloc (edit->undo_stack, (edit->undo_stack_size * 2 + 10) * sizeof (long));
-            if (t != NULL)
-            {
-                edit->undo_stack = t;
-                edit->undo_stack_size <<= 1;
-                edit->undo_stack_size_mask = edit->undo_stack_size - 1;
-            }
-        }
-    }
-    spm1 = (edit->undo_stack_pointer - 1) & edit->undo_stack_size_mask;
-    if (edit->undo_stack_disable)
-    {
-        edit_push_redo_action (edit, KEY_PRESS);
-        edit_push_redo_action (edit, c);
-        return;
-    }
-
-    if (edit->redo_stack_reset)
-        edit->redo_stack_bottom = edit->redo_stack_pointer = 0;
-
-    if (edit->undo_stack_bottom != sp && spm1 != edit->undo_stack_bottom
-        && ((sp - 2) & edit->undo_stack_size_mask) != edit->undo_stack_bottom)
-    {
-        long d;
-
-        if (edit->undo_stack[spm1] < 0)
-        {
-            d = edit->undo_stack[(sp - 2) & edit->undo_stack_size_mask];
-            if (d == c && edit->undo_stack[spm1] > -1000000000)
-            {
-                if (c < KEY_PRESS)  // --> no need to push multiple do-nothings
-                    edit->undo_stack[spm1]--;
-                return;
-            }
-        }
-        else
-        {
-            d = edit->undo_stack[spm1];
-            if (d == c)
-            {
-                if (c >= KEY_PRESS)
-                    return;  // --> no need to push multiple do-nothings
-                edit->undo_stack[sp] = -2;
-                goto check_bottom;
-            }
-        }
-    }
-    edit->undo_stack[sp] = c;
-
-check_bottom:
-    edit->undo_stack_pointer = (edit->undo_stack_pointer + 1) & edit->undo_stack_size_mask;
-
-    /* if the sp wraps round and catches the undo_stack_bottom then erase
-     * the first set of actions on the stack to make space - by moving
-     * undo_stack_bottom forward one "key press" */
-    c = (edit->undo_stack_pointer + 2) & edit->undo_stack_size_mask;
-    if ((unsigned long) c == edit->undo_stack_bottom
-        || (((unsigned long) c + 1) & edit->undo_stack_size_mask) == edit->undo_stack_bottom)
-        do
-        {
-            edit->undo_stack_bottom = (edit->undo_stack_bottom + 1) & edit->undo_stack_size_mask;
-        }
-        while (edit->undo_stack[edit->undo_stack_bottom] < KEY_PRESS
-               && edit->undo_stack_bottom != edit->undo_stack_pointer);
-
-    // If a single key produced enough pushes to wrap all the way round then we would notice that
-    // the [undo_stack_bottom] does not contain KEY_PRESS. The stack is then initialised:
-    if (edit->undo_stack_pointer != edit->undo_stack_bottom
-        && edit->undo_stack[edit->undo_stack_bottom] < KEY_PRESS)
-    {
-        edit->undo_stack_bottom = edit->undo_stack_pointer = 0;
-    }
-}
-
-/* --------------------------------------------------------------------------------------------- */
-
-void
-edit_push_redo_action (WEdit *edit, long c)
-{
-    unsigned long sp = edit->redo_stack_pointer;
-    unsigned long spm1;
-    // first enlarge the stack if necessary
-    if (sp > edit->redo_stack_size - 10)
-    {  // say
-        if (max_undo < 256)
-            max_undo = 256;
-        if (edit->redo_stack_size < (unsigned long) max_undo)
-        {
-            long *t;
-
-            t = g_realloc (edit->redo_stack, (edit->redo_stack_size * 2 + 10) * sizeof (long));
-            if (t != NULL)
-            {
-                edit->redo_stack = t;
-                edit->redo_stack_size <<= 1;
-                edit->redo_stack_size_mask = edit->redo_stack_size - 1;
-            }
-        }
-    }
-    spm1 = (edit->redo_stack_pointer - 1) & edit->redo_stack_size_mask;
-
-    if (edit->redo_stack_bottom != sp && spm1 != edit->redo_stack_bottom
-        && ((sp - 2) & edit->redo_stack_size_mask) != edit->redo_stack_bottom)
+    if (c >= 0 && c < 512)
     {
-        long d;
+        const char b = (char) (c & 0xff);
 
-        if (edit->redo_stack[spm1] < 0)
-        {
-            d = edit->redo_stack[(sp - 2) & edit->redo_stack_size_mask];
-            if (d == c && edit->redo_stack[spm1] > -1000000000)
-            {
-                if (c < KEY_PRESS)  // --> no need to push multiple do-nothings
-                    edit->redo_stack[spm1]--;
-                return;
-            }
-        }
-        else
-        {
-            d = edit->redo_stack[spm1];
-            if (d == c)
-            {
-                if (c >= KEY_PRESS)
-                    return;  // --> no need to push multiple do-nothings
-                edit->redo_stack[sp] = -2;
-                goto redo_check_bottom;
-            }
-        }
+        edit_push_undo_bytes (edit, c < 256 ? INSERT_BYTES : INSERT_AHEAD_BYTES, &b, 1);
     }
-    edit->redo_stack[sp] = c;
-
-redo_check_bottom:
-    edit->redo_stack_pointer = (edit->redo_stack_pointer + 1) & edit->redo_stack_size_mask;
-
-    /* if the sp wraps round and catches the redo_stack_bottom then erase
-     * the first set of actions on the stack to make space - by moving
-     * redo_stack_bottom forward one "key press" */
-    c = (edit->redo_stack_pointer + 2) & edit->redo_stack_size_mask;
-    if ((unsigned long) c == edit->redo_stack_bottom
-        || (((unsigned long) c + 1) & edit->redo_stack_size_mask) == edit->redo_stack_bottom)
-        do
-        {
-            edit->redo_stack_bottom = (edit->redo_stack_bottom + 1) & edit->redo_stack_size_mask;
-        }
-        while (edit->redo_stack[edit->redo_stack_bottom] < KEY_PRESS
-               && edit->redo_stack_bottom != edit->redo_stack_pointer);
-
-    /*
-     * If a single key produced enough pushes to wrap all the way round then
-     * we would notice that the [redo_stack_bottom] does not contain KEY_PRESS.
-     * The stack is then initialised:
-     */
-
-    if (edit->redo_stack_pointer != edit->redo_stack_bottom
-        && edit->redo_stack[edit->redo_stack_bottom] < KEY_PRESS)
-        edit->redo_stack_bottom = edit->redo_stack_pointer = 0;
+    else
+        edit_push_undo_actions (edit, c, 1);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -2584,6 +2313,104 @@ edit_insert_ahead (WEdit *edit, int c)
     edit_buffer_insert_ahead (&edit->buffer, c);
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/** same as edit_insert for every byte */
+
+void
+edit_insert_bytes (WEdit *edit, const char *s, off_t len)
+{
+    off_t i, j;
+    long lines = 0;
+
+    if (len <= 0)
+        return;
+
+    if (edit->loading_done != 0)
+        edit_modification (edit);
+
+    // runs of ordinary chars and of spaces
+    for (i = 0; i < len; i = j)
+    {
+        const gboolean ordinary = (unsigned char) s[i] > 32;
+
+        for (j = i; j < len && ((unsigned char) s[j] > 32) == ordinary; j++)
+            if (s[j] == '\n')
+            {
+                book_mark_inc (edit, edit->buffer.curs_line + lines);
+                lines++;
+            }
+
+        edit_push_undo_actions (edit, ordinary ? BACKSPACE : BACKSPACE_BR, j - i);
+    }
+
+    if (edit->buffer.curs1 < edit->start_display)
+    {
+        edit->start_display += len;
+        edit->start_line += lines;
+    }
+
+    if (lines != 0)
+    {
+        edit->buffer.curs_line += lines;
+        edit->buffer.lines += lines;
+        edit->force |= REDRAW_LINE_ABOVE | REDRAW_AFTER_CURSOR;
+    }
+
+    edit->mark1 += (edit->mark1 > edit->buffer.curs1) ? len : 0;
+    edit->mark2 += (edit->mark2 > edit->buffer.curs1) ? len : 0;
+    edit->last_get_rule += (edit->last_get_rule > edit->buffer.curs1) ? len : 0;
+
+    edit_buffer_insert_bytes (&edit->buffer, s, len);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** same as edit_insert_ahead for every byte from the last one to the first one */
+
+void
+edit_insert_ahead_bytes (WEdit *edit, const char *s, off_t len)
+{
+    off_t i, j;
+    long lines = 0;
+
+    if (len <= 0)
+        return;
+
+    edit_modification (edit);
+
+    // runs of ordinary chars and of spaces from the last one
+    for (i = len; i > 0; i = j)
+    {
+        const gboolean ordinary = (unsigned char) s[i - 1] > 32;
+
+        for (j = i; j > 0 && ((unsigned char) s[j - 1] > 32) == ordinary; j--)
+            if (s[j - 1] == '\n')
+            {
+                book_mark_inc (edit, edit->buffer.curs_line);
+                lines++;
+            }
+
+        edit_push_undo_actions (edit, ordinary ? DELCHAR : DELCHAR_BR, i - j);
+    }
+
+    if (edit->buffer.curs1 < edit->start_display)
+    {
+        edit->start_display += len;
+        edit->start_line += lines;
+    }
+
+    if (lines != 0)
+    {
+        edit->buffer.lines += lines;
+        edit->force |= REDRAW_AFTER_CURSOR;
+    }
+
+    edit->mark1 += (edit->mark1 >= edit->buffer.curs1) ? len : 0;
+    edit->mark2 += (edit->mark2 >= edit->buffer.curs1) ? len : 0;
+    edit->last_get_rule += (edit->last_get_rule >= edit->buffer.curs1) ? len : 0;
+
+    edit_buffer_insert_ahead_bytes (&edit->buffer, s, len);
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 void
@@ -2654,6 +2481,71 @@ edit_delete (WEdit *edit, gboolean byte_delete)
     return p;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Same as edit_delete (edit, TRUE) for every byte.
+ *
+ * @param bytes buffer for deleted bytes in order of the text, or NULL
+ */
+
+void
+edit_delete_bytes (WEdit *edit, off_t len, char *bytes)
+{
+    char chunk[TEMP_BUF_LEN];
+
+    len = MIN (len, edit->buffer.curs2);
+    if (len <= 0)
+        return;
+
+    if (edit->mark2 != edit->mark1)
+        edit_push_markers (edit);
+
+    while (len > 0)
+    {
+        char *p;
+        off_t n, d, display, i;
+        long lines = 0, display_lines = 0;
+
+        p = bytes != NULL ? bytes : chunk;
+        n = edit_buffer_delete_bytes (&edit->buffer, p, MIN (len, TEMP_BUF_LEN));
+
+        // bytes between the cursor and the display window move the window
+        display = MAX (MIN (n, edit->start_display - edit->buffer.curs1), 0);
+
+        for (i = 0; i < n; i++)
+            if (p[i] == '\n')
+            {
+                book_mark_dec (edit, edit->buffer.curs_line);
+                lines++;
+                if (i < display)
+                    display_lines++;
+            }
+
+        edit_push_undo_bytes (edit, INSERT_AHEAD_BYTES, p, n);
+
+        d = MAX (MIN (n, edit->mark1 - edit->buffer.curs1), 0);
+        edit->mark1 -= d;
+        edit->end_mark_curs -= d;
+        edit->mark2 -= MAX (MIN (n, edit->mark2 - edit->buffer.curs1), 0);
+        edit->last_get_rule -= MAX (MIN (n, edit->last_get_rule - edit->buffer.curs1), 0);
+
+        if (lines != 0)
+        {
+            edit->buffer.lines -= lines;
+            edit->force |= REDRAW_AFTER_CURSOR;
+        }
+
+        edit->start_display -= display;
+        edit->start_line -= display_lines;
+
+        if (bytes != NULL)
+            bytes += n;
+        len -= n;
+    }
+
+    edit_modification (edit);
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 int
@@ -2712,45 +2604,102 @@ edit_backspace (WEdit *edit, gboolean byte_delete)
 }
 
 /* --------------------------------------------------------------------------------------------- */
-/** moves the cursor right or left: increment positive or negative respectively */
+/** same as edit_backspace (edit, TRUE) for every byte */
 
 void
-edit_cursor_move (WEdit *edit, off_t increment)
+edit_backspace_bytes (WEdit *edit, off_t len)
 {
-    if (increment < 0)
+    char chunk[TEMP_BUF_LEN];
+
+    len = MIN (len, edit->buffer.curs1);
+    if (len <= 0)
+        return;
+
+    if (edit->mark2 != edit->mark1)
+        edit_push_markers (edit);
+
+    while (len > 0)
     {
-        for (; increment < 0 && edit->buffer.curs1 != 0; increment++)
+        off_t n, d, display, i;
+        long lines = 0, display_lines = 0;
+
+        n = edit_buffer_backspace_bytes (&edit->buffer, chunk, MIN (len, TEMP_BUF_LEN));
+
+        // bytes between the display window and the cursor move the window
+        display = MAX (MIN (n, edit->start_display - edit->buffer.curs1), 0);
+
+        // from the cursor backwards and with reverse order in the undo log like edit_backspace()
+        for (i = 0; i < n / 2; i++)
         {
-            int c;
+            const char c = chunk[i];
 
-            edit_push_undo_action (edit, CURS_RIGHT);
+            chunk[i] = chunk[n - 1 - i];
+            chunk[n - 1 - i] = c;
+        }
 
-            c = edit_buffer_get_previous_byte (&edit->buffer);
-            edit_buffer_insert_ahead (&edit->buffer, c);
-            c = edit_buffer_backspace (&edit->buffer);
-            if (c == '\n')
+        for (i = 0; i < n; i++)
+            if (chunk[i] == '\n')
             {
-                edit->buffer.curs_line--;
-                edit->force |= REDRAW_LINE_BELOW;
+                book_mark_dec (edit, edit->buffer.curs_line - lines);
+                lines++;
+                if (i >= n - display)
+                    display_lines++;
             }
+
+        edit_push_undo_bytes (edit, INSERT_BYTES, chunk, n);
+
+        d = MAX (MIN (n, edit->mark1 - edit->buffer.curs1), 0);
+        edit->mark1 -= d;
+        edit->end_mark_curs -= d;
+        edit->mark2 -= MAX (MIN (n, edit->mark2 - edit->buffer.curs1), 0);
+        edit->last_get_rule -= MAX (MIN (n, edit->last_get_rule - edit->buffer.curs1), 0);
+
+        if (lines != 0)
+        {
+            edit->buffer.curs_line -= lines;
+            edit->buffer.lines -= lines;
+            edit->force |= REDRAW_AFTER_CURSOR;
         }
+
+        edit->start_display -= display;
+        edit->start_line -= display_lines;
+
+        len -= n;
     }
+
+    edit_modification (edit);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** moves the cursor right or left: increment positive or negative respectively */
+
+void
+edit_cursor_move (WEdit *edit, off_t increment)
+{
+    long lines;
+
+    if (increment < 0)
+        increment = -MIN (-increment, edit->buffer.curs1);
     else
-    {
-        for (; increment > 0 && edit->buffer.curs2 != 0; increment--)
-        {
-            int c;
+        increment = MIN (increment, edit->buffer.curs2);
+
+    if (increment == 0)
+        return;
 
-            edit_push_undo_action (edit, CURS_LEFT);
+    edit_push_undo_actions (edit, increment < 0 ? CURS_RIGHT : CURS_LEFT, ABS (increment));
 
-            c = edit_buffer_get_current_byte (&edit->buffer);
-            edit_buffer_insert (&edit->buffer, c);
-            c = edit_buffer_delete (&edit->buffer);
-            if (c == '\n')
-            {
-                edit->buffer.curs_line++;
-                edit->force |= REDRAW_LINE_ABOVE;
-            }
+    lines = edit_buffer_move_cursor (&edit->buffer, increment);
+    if (lines != 0)
+    {
+        if (increment < 0)
+        {
+            edit->buffer.curs_line -= lines;
+            edit->force |= REDRAW_LINE_BELOW;
+        }
+        else
+        {
+            edit->buffer.curs_line += lines;
+            edit->force |= REDRAW_LINE_ABOVE;
         }
     }
 }
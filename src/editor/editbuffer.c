@@ -32,9 +32,12 @@
 #include <config.h>
 
 #include <ctype.h>  // isdigit()
+#include <errno.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>  // pread()
 
 #include "lib/global.h"
 
@@ -96,10 +99,19 @@
 /* Buffer mask (used to find cursor position relative to the buffer) */
 #define M_EDIT_BUF_SIZE (EDIT_BUF_SIZE - 1)
 
+/* Lines are looked up in the line index rather than scanned if there are more lines than that.
+   The lookup scans up to two buffers which is about that number of lines of text. */
+#define EDIT_LINES_SCAN_MAX 1024
+
+/* Buffers of local files of this size and bigger are read when they are accessed first time */
+#define EDIT_LAZY_SIZE_MIN (1024 * EDIT_BUF_SIZE)
+
 /*** file scope type declarations ****************************************************************/
 
 /*** forward declarations (file scope functions) *************************************************/
 
+static char *edit_buffer_get_b2_page (const edit_buffer_t *buf, guint page);
+
 /*** file scope variables ************************************************************************/
 
 /* --------------------------------------------------------------------------------------------- */
@@ -126,7 +138,7 @@ edit_buffer_get_byte_ptr (const edit_buffer_t *buf, off_t byte_index)
         off_t p;
 
         p = buf->curs1 + buf->curs2 - byte_index - 1;
-        b = g_ptr_array_index (buf->b2, p >> S_EDIT_BUF_SIZE);
+        b = edit_buffer_get_b2_page (buf, (guint) (p >> S_EDIT_BUF_SIZE));
         return (char *) b + EDIT_BUF_SIZE - 1 - (p & M_EDIT_BUF_SIZE);
     }
 
@@ -134,6 +146,338 @@ edit_buffer_get_byte_ptr (const edit_buffer_t *buf, off_t byte_index)
     return (char *) b + (byte_index & M_EDIT_BUF_SIZE);
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get pointer to the run of contiguous bytes which starts at specified index.
+ *
+ * Both in b1 and b2 bytes of file are contiguous in memory within one buffer, so the run ends
+ * at the end of buffer or at the cursor.
+ *
+ * @param buf pointer to editor buffer
+ * @param byte_index byte index
+ * @param len length of run
+ *
+ * @return NULL if byte_index is negative or larger than file size; pointer to byte otherwise.
+ */
+static const char *
+edit_buffer_get_run_forward (const edit_buffer_t *buf, off_t byte_index, off_t *len)
+{
+    const char *p;
+
+    p = edit_buffer_get_byte_ptr (buf, byte_index);
+
+    if (p == NULL)
+        *len = 0;
+    else if (byte_index >= buf->curs1)
+        *len = ((buf->curs1 + buf->curs2 - byte_index - 1) & M_EDIT_BUF_SIZE) + 1;
+    else
+        *len = MIN (EDIT_BUF_SIZE - (byte_index & M_EDIT_BUF_SIZE), buf->curs1 - byte_index);
+
+    return p;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get pointer to the run of contiguous bytes which ends at specified index.
+ *
+ * @param buf pointer to editor buffer
+ * @param byte_index byte index
+ * @param len length of run, i.e. the run starts at (returned pointer - len + 1)
+ *
+ * @return NULL if byte_index is negative or larger than file size; pointer to byte otherwise.
+ */
+static const char *
+edit_buffer_get_run_backward (const edit_buffer_t *buf, off_t byte_index, off_t *len)
+{
+    const char *p;
+
+    p = edit_buffer_get_byte_ptr (buf, byte_index);
+
+    if (p == NULL)
+        *len = 0;
+    else if (byte_index >= buf->curs1)
+    {
+        off_t i;
+
+        i = buf->curs1 + buf->curs2 - byte_index - 1;
+        *len = MIN (EDIT_BUF_SIZE - (i & M_EDIT_BUF_SIZE), buf->curs2 - i);
+    }
+    else
+        *len = (byte_index & M_EDIT_BUF_SIZE) + 1;
+
+    return p;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Count newlines in memory area using memchr() which is vectorized in the C library.
+ */
+
+static long
+edit_buffer_count_newlines (const char *s, off_t len)
+{
+    const char *end = s + len;
+    long lines = 0;
+
+    for (; s < end && (s = memchr (s, '\n', (size_t) (end - s))) != NULL; s++)
+        lines++;
+
+    return lines;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Find last newline in memory area.
+ */
+
+static const char *
+edit_buffer_find_last_newline (const char *s, off_t len)
+{
+#ifdef HAVE_MEMRCHR
+    return memrchr (s, '\n', (size_t) len);
+#else
+    while (len-- > 0)
+        if (s[len] == '\n')
+            return s + len;
+
+    return NULL;
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get number of newlines in buffers 0...page-1 of b1 or b2.
+ */
+
+static long
+edit_buffer_lines_before (const GArray *lines, guint page)
+{
+    return page == 0 ? 0 : g_array_index (lines, long, page - 1);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Add newlines to the last buffer of b1 or b2.
+ */
+
+static void
+edit_buffer_lines_add (GArray *lines, long n)
+{
+    g_array_index (lines, long, lines->len - 1) += n;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Find first buffer of b1 or b2 so that buffers 0...page contain at least n newlines.
+ */
+
+static guint
+edit_buffer_lines_find (const GArray *lines, long n)
+{
+    guint lo = 0;
+    guint hi = lines->len;
+
+    while (lo < hi)
+    {
+        guint mid;
+
+        mid = lo + (hi - lo) / 2;
+        if (g_array_index (lines, long, mid) < n)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Add new buffer to b1 or b2.
+ */
+
+static void
+edit_buffer_add_page (GPtrArray *b, GArray *lines)
+{
+    long n;
+
+    g_ptr_array_add (b, g_malloc0 (EDIT_BUF_SIZE));
+    n = edit_buffer_lines_before (lines, lines->len);
+    g_array_append_val (lines, n);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Read buffer of b2 from the file.  Buffer of index @page holds EDIT_BUF_SIZE bytes of the file
+ * which end at EDIT_BUF_SIZE * @page bytes before the end of file.  The file may be changed
+ * by someone else: missing data is filled with zeros.
+ *
+ * @return number of newlines in buffer
+ */
+
+static long
+edit_buffer_read_page (const edit_buffer_t *buf, guint page, char *b)
+{
+    off_t offset;
+    size_t done = 0;
+
+    offset = buf->file_size - ((off_t) (page + 1) << S_EDIT_BUF_SIZE);
+
+    while (done < EDIT_BUF_SIZE)
+    {
+        ssize_t n;
+
+        n = pread (buf->file_fd, b + done, EDIT_BUF_SIZE - done, offset + (off_t) done);
+        if (n > 0)
+            done += (size_t) n;
+        else if (n == 0 || errno != EINTR)
+            break;
+    }
+
+    memset (b + done, 0, EDIT_BUF_SIZE - done);
+
+    return edit_buffer_count_newlines (b, EDIT_BUF_SIZE);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get buffer of b2, read it from the file if it is not read yet.  Buffers which are not read
+ * are full and not changed, so they keep their places in b2.
+ *
+ * If the file has been changed by someone else since it was loaded, the line index is fixed
+ * according to the read data.  Only numbers of lines are changed: the text of buffer is
+ * the same logically.
+ */
+
+static char *
+edit_buffer_get_b2_page (const edit_buffer_t *buf, guint page)
+{
+    char *b;
+    long lines;
+
+    b = g_ptr_array_index (buf->b2, page);
+    if (b != NULL)
+        return b;
+
+    b = g_malloc (EDIT_BUF_SIZE);
+    g_ptr_array_index (buf->b2, page) = b;
+
+    lines = edit_buffer_read_page (buf, page, b);
+    lines -= g_array_index (buf->b2_lines, long, page)
+        - edit_buffer_lines_before (buf->b2_lines, page);
+
+    if (lines != 0)
+    {
+        guint i;
+
+        for (i = page; i < buf->b2_lines->len; i++)
+            g_array_index (buf->b2_lines, long, i) += lines;
+
+        ((edit_buffer_t *) buf)->lines += lines;
+    }
+
+    return b;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Load local file into editor buffer lazily.  Only lines are counted: the full buffers of b2
+ * are read from the file when they are accessed first time, see edit_buffer_get_b2_page().
+ * The first buffer of file, which is not full, is read.
+ *
+ * @param buf pointer to editor buffer
+ * @param fd descriptor of local file to read buffers from, closed by edit_buffer_clean()
+ * @param vfs_fd VFS descriptor of the same file
+ * @param size file size
+ *
+ * @return number of read bytes, -1 if loading is aborted
+ */
+
+static off_t
+edit_buffer_read_file_lazily (edit_buffer_t *buf, int fd, int vfs_fd, off_t size,
+                              edit_buffer_read_file_status_msg_t *sm, gboolean *aborted)
+{
+    status_msg_t *s = STATUS_MSG (sm);
+    unsigned short update_cnt = 0;
+    guint i, pages;
+    off_t ret, data_size;
+    long lines;
+    char *b;
+
+    buf->file_fd = fd;
+    buf->file_size = size;
+
+    pages = (guint) (size >> S_EDIT_BUF_SIZE);
+    data_size = size & M_EDIT_BUF_SIZE;
+
+    g_ptr_array_set_size (buf->b2, (gint) (pages + (data_size != 0 ? 1 : 0)));
+    g_array_set_size (buf->b2_lines, buf->b2->len);
+
+    if (data_size != 0)
+    {
+        b = g_malloc0 (EDIT_BUF_SIZE);
+        g_ptr_array_index (buf->b2, pages) = b;
+        b += EDIT_BUF_SIZE - data_size;
+
+        ret = mc_read (vfs_fd, b, data_size);
+        if (ret != data_size)
+            return ret;
+
+        g_array_index (buf->b2_lines, long, pages) = edit_buffer_count_newlines (b, data_size);
+    }
+
+    ret = data_size;
+    b = g_malloc (EDIT_BUF_SIZE);
+
+    // other buffers are read to count lines only
+    for (i = pages; i > 0; i--)
+    {
+        off_t sz;
+
+        sz = mc_read (vfs_fd, b, EDIT_BUF_SIZE);
+        if (sz > 0)
+            ret += sz;
+        if (sz != EDIT_BUF_SIZE)
+            break;
+
+        g_array_index (buf->b2_lines, long, i - 1) = edit_buffer_count_newlines (b, EDIT_BUF_SIZE);
+
+        if (s != NULL && s->update != NULL)
+        {
+            update_cnt = (update_cnt + 1) & 0xf;
+            if (update_cnt == 0)
+            {
+                if (sm->buf == NULL)
+                    sm->buf = buf;
+
+                sm->loaded = ret;
+                if (s->update (s) == B_CANCEL)
+                {
+                    *aborted = TRUE;
+                    ret = -1;
+                    break;
+                }
+            }
+        }
+    }
+
+    g_free (b);
+
+    if (ret != size)
+        return ret;
+
+    // make the line index
+    for (i = 0, lines = 0; i < buf->b2_lines->len; i++)
+    {
+        lines += g_array_index (buf->b2_lines, long, i);
+        g_array_index (buf->b2_lines, long, i) = lines;
+    }
+
+    buf->lines = lines;
+
+    return ret;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /*** public functions ****************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -148,12 +492,17 @@ edit_buffer_init (edit_buffer_t *buf, off_t size)
 {
     buf->b1 = g_ptr_array_new_full (32, g_free);
     buf->b2 = g_ptr_array_new_full (32, g_free);
+    buf->b1_lines = g_array_sized_new (FALSE, FALSE, sizeof (long), 32);
+    buf->b2_lines = g_array_sized_new (FALSE, FALSE, sizeof (long), 32);
 
     buf->curs1 = 0;
     buf->curs2 = 0;
 
     buf->size = size;
     buf->lines = 0;
+
+    buf->file_fd = -1;
+    buf->file_size = 0;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -171,6 +520,18 @@ edit_buffer_clean (edit_buffer_t *buf)
 
     if (buf->b2 != NULL)
         g_ptr_array_free (buf->b2, TRUE);
+
+    if (buf->file_fd != -1)
+    {
+        close (buf->file_fd);
+        buf->file_fd = -1;
+    }
+
+    if (buf->b1_lines != NULL)
+        g_array_free (buf->b1_lines, TRUE);
+
+    if (buf->b2_lines != NULL)
+        g_array_free (buf->b2_lines, TRUE);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -328,9 +689,22 @@ edit_buffer_count_lines (const edit_buffer_t *buf, off_t first, off_t last)
     first = MAX (first, 0);
     last = MIN (last, buf->size);
 
+    if (last - first > 2 * EDIT_BUF_SIZE)
+        return edit_buffer_get_line (buf, last) - edit_buffer_get_line (buf, first);
+
     while (first < last)
-        if (edit_buffer_get_byte (buf, first++) == '\n')
-            lines++;
+    {
+        const char *p;
+        off_t len;
+
+        p = edit_buffer_get_run_forward (buf, first, &len);
+        if (p == NULL)
+            break;
+
+        len = MIN (len, last - first);
+        lines += edit_buffer_count_newlines (p, len);
+        first += len;
+    }
 
     return lines;
 }
@@ -351,8 +725,21 @@ edit_buffer_get_bol (const edit_buffer_t *buf, off_t current)
     if (current <= 0)
         return 0;
 
-    for (; edit_buffer_get_byte (buf, current - 1) != '\n'; current--)
-        ;
+    while (current > 0)
+    {
+        const char *p, *nl;
+        off_t len;
+
+        p = edit_buffer_get_run_backward (buf, current - 1, &len);
+        if (p == NULL)
+            break;
+
+        nl = edit_buffer_find_last_newline (p - len + 1, len);
+        if (nl != NULL)
+            return current - (p - nl);
+
+        current -= len;
+    }
 
     return current;
 }
@@ -373,12 +760,137 @@ edit_buffer_get_eol (const edit_buffer_t *buf, off_t current)
     if (current >= buf->size)
         return buf->size;
 
-    for (; edit_buffer_get_byte (buf, current) != '\n'; current++)
-        ;
+    while (TRUE)
+    {
+        const char *p, *nl;
+        off_t len;
+
+        p = edit_buffer_get_run_forward (buf, current, &len);
+        if (p == NULL)
+            break;
+
+        nl = memchr (p, '\n', (size_t) len);
+        if (nl != NULL)
+            return current + (nl - p);
+
+        current += len;
+    }
 
     return current;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get number of line contained specified byte offset using the line index.
+ *
+ * @param buf editor buffer
+ * @param byte_index byte offset
+ *
+ * @return number of newlines before byte_index
+ */
+
+long
+edit_buffer_get_line (const edit_buffer_t *buf, off_t byte_index)
+{
+    guint page;
+    off_t len;
+    const char *b;
+    long lines;
+
+    byte_index = CLAMP (byte_index, 0, buf->curs1 + buf->curs2);
+
+    if (byte_index <= buf->curs1)
+    {
+        page = (guint) (byte_index >> S_EDIT_BUF_SIZE);
+        lines = edit_buffer_lines_before (buf->b1_lines, page);
+
+        len = byte_index & M_EDIT_BUF_SIZE;
+        if (len != 0)
+            lines += edit_buffer_count_newlines (g_ptr_array_index (buf->b1, page), len);
+
+        return lines;
+    }
+
+    len = buf->curs1 + buf->curs2 - byte_index;
+    page = (guint) (len >> S_EDIT_BUF_SIZE);
+    len &= M_EDIT_BUF_SIZE;
+
+    // read buffer before the line index is used
+    b = len != 0 ? edit_buffer_get_b2_page (buf, page) : NULL;
+
+    // count newlines from byte_index to the end of file and subtract them from total
+    lines = edit_buffer_lines_before (buf->b1_lines, buf->b1_lines->len)
+        + edit_buffer_lines_before (buf->b2_lines, buf->b2_lines->len);
+    lines -= edit_buffer_lines_before (buf->b2_lines, page);
+
+    if (b != NULL)
+        lines -= edit_buffer_count_newlines (b + EDIT_BUF_SIZE - len, len);
+
+    return lines;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get offset of specified line using the line index.
+ *
+ * @param buf editor buffer
+ * @param line line number
+ *
+ * @return index of first char of line; offset of last line if line is out of range
+ */
+
+off_t
+edit_buffer_get_line_offset (const edit_buffer_t *buf, long line)
+{
+    long lines1, lines2;
+    guint page;
+    const char *b, *start, *p;
+    off_t len;
+
+    lines1 = edit_buffer_lines_before (buf->b1_lines, buf->b1_lines->len);
+    lines2 = edit_buffer_lines_before (buf->b2_lines, buf->b2_lines->len);
+    line = CLAMP (line, 0, lines1 + lines2);
+
+    if (line == 0)
+        return 0;
+
+    if (line <= lines1)
+    {
+        // find line-th newline in b1
+        page = edit_buffer_lines_find (buf->b1_lines, line);
+        line -= edit_buffer_lines_before (buf->b1_lines, page);
+
+        b = g_ptr_array_index (buf->b1, page);
+        len = MIN (EDIT_BUF_SIZE, buf->curs1 - ((off_t) page << S_EDIT_BUF_SIZE));
+
+        for (p = b - 1; line != 0; line--)
+            p = memchr (p + 1, '\n', (size_t) (b + len - p - 1));
+
+        return ((off_t) page << S_EDIT_BUF_SIZE) + (p - b) + 1;
+    }
+
+    // find newline in b2 counting from the end of file
+    line = lines1 + lines2 - line + 1;
+    page = edit_buffer_lines_find (buf->b2_lines, line);
+    line -= edit_buffer_lines_before (buf->b2_lines, page);
+
+    // if the file has been changed, reading of buffer fixes the line index, then the buffer
+    // can contain less lines than found: return the end of buffer
+    b = edit_buffer_get_b2_page (buf, page);
+    if (line > g_array_index (buf->b2_lines, long, page)
+                   - edit_buffer_lines_before (buf->b2_lines, page))
+        return buf->curs1 + buf->curs2 - ((off_t) page << S_EDIT_BUF_SIZE);
+
+    len = MIN (EDIT_BUF_SIZE, buf->curs2 - ((off_t) page << S_EDIT_BUF_SIZE));
+    start = b + EDIT_BUF_SIZE - len;
+
+    for (p = b + EDIT_BUF_SIZE; line != 0; line--)
+        p = edit_buffer_find_last_newline (start, p - start);
+
+    return buf->curs1 + buf->curs2 - ((off_t) page << S_EDIT_BUF_SIZE) - EDIT_BUF_SIZE + (p - b)
+        + 1;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /**
  * Get word from specified offset.
@@ -495,12 +1007,15 @@ edit_buffer_insert (edit_buffer_t *buf, int c)
 
     // add a new buffer if we've reached the end of the last one
     if (i == 0)
-        g_ptr_array_add (buf->b1, g_malloc0 (EDIT_BUF_SIZE));
+        edit_buffer_add_page (buf->b1, buf->b1_lines);
 
     // perform the insertion
     b = g_ptr_array_index (buf->b1, buf->curs1 >> S_EDIT_BUF_SIZE);
     *((unsigned char *) b + i) = (unsigned char) c;
 
+    if (c == '\n')
+        edit_buffer_lines_add (buf->b1_lines, 1);
+
     // update cursor position
     buf->curs1++;
 
@@ -527,12 +1042,15 @@ edit_buffer_insert_ahead (edit_buffer_t *buf, int c)
 
     // add a new buffer if we've reached the end of the last one
     if (i == 0)
-        g_ptr_array_add (buf->b2, g_malloc0 (EDIT_BUF_SIZE));
+        edit_buffer_add_page (buf->b2, buf->b2_lines);
 
     // perform the insertion
-    b = g_ptr_array_index (buf->b2, buf->curs2 >> S_EDIT_BUF_SIZE);
+    b = edit_buffer_get_b2_page (buf, (guint) (buf->curs2 >> S_EDIT_BUF_SIZE));
     *((unsigned char *) b + EDIT_BUF_SIZE - 1 - i) = (unsigned char) c;
 
+    if (c == '\n')
+        edit_buffer_lines_add (buf->b2_lines, 1);
+
     // update cursor position
     buf->curs2++;
 
@@ -559,17 +1077,20 @@ edit_buffer_delete (edit_buffer_t *buf)
 
     prev = buf->curs2 - 1;
 
-    b = g_ptr_array_index (buf->b2, prev >> S_EDIT_BUF_SIZE);
+    b = edit_buffer_get_b2_page (buf, (guint) (prev >> S_EDIT_BUF_SIZE));
     i = prev & M_EDIT_BUF_SIZE;
     c = *((unsigned char *) b + EDIT_BUF_SIZE - 1 - i);
 
+    if (c == '\n')
+        edit_buffer_lines_add (buf->b2_lines, -1);
+
     if (i == 0)
     {
         guint j;
 
         j = buf->b2->len - 1;
-        b = g_ptr_array_index (buf->b2, j);
         g_ptr_array_remove_index (buf->b2, j);
+        g_array_set_size (buf->b2_lines, j);
     }
 
     buf->curs2 = prev;
@@ -603,6 +1124,9 @@ edit_buffer_backspace (edit_buffer_t *buf)
     i = prev & M_EDIT_BUF_SIZE;
     c = *((unsigned char *) b + i);
 
+    if (c == '\n')
+        edit_buffer_lines_add (buf->b1_lines, -1);
+
     if (i == 0)
     {
         guint j;
@@ -610,6 +1134,7 @@ edit_buffer_backspace (edit_buffer_t *buf)
         j = buf->b1->len - 1;
         b = g_ptr_array_index (buf->b1, j);
         g_ptr_array_remove_index (buf->b1, j);
+        g_array_set_size (buf->b1_lines, j);
     }
 
     buf->curs1 = prev;
@@ -620,6 +1145,231 @@ edit_buffer_backspace (edit_buffer_t *buf)
     return c;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Insert bytes at the cursor position and move right.  Same as edit_buffer_insert() for
+ * every byte, but whole spans are copied into buffers.
+ *
+ * @param buf pointer to editor buffer
+ * @param s bytes to insert
+ * @param len number of bytes
+ */
+
+void
+edit_buffer_insert_bytes (edit_buffer_t *buf, const char *s, off_t len)
+{
+    while (len > 0)
+    {
+        char *b;
+        off_t i, n;
+
+        i = buf->curs1 & M_EDIT_BUF_SIZE;
+
+        // add a new buffer if we've reached the end of the last one
+        if (i == 0)
+            edit_buffer_add_page (buf->b1, buf->b1_lines);
+
+        b = g_ptr_array_index (buf->b1, buf->curs1 >> S_EDIT_BUF_SIZE);
+        n = MIN (len, EDIT_BUF_SIZE - i);
+        memcpy (b + i, s, (size_t) n);
+        edit_buffer_lines_add (buf->b1_lines, edit_buffer_count_newlines (s, n));
+
+        buf->curs1 += n;
+        buf->size += n;
+        s += n;
+        len -= n;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Insert bytes at the cursor position, the cursor stays before them.  Same as
+ * edit_buffer_insert_ahead() for every byte from the last one to the first one.
+ *
+ * @param buf pointer to editor buffer
+ * @param s bytes to insert
+ * @param len number of bytes
+ */
+
+void
+edit_buffer_insert_ahead_bytes (edit_buffer_t *buf, const char *s, off_t len)
+{
+    while (len > 0)
+    {
+        char *b;
+        off_t i, n;
+
+        i = buf->curs2 & M_EDIT_BUF_SIZE;
+
+        // add a new buffer if we've reached the end of the last one
+        if (i == 0)
+            edit_buffer_add_page (buf->b2, buf->b2_lines);
+
+        // b2 is filled from the end of buffer
+        b = edit_buffer_get_b2_page (buf, (guint) (buf->curs2 >> S_EDIT_BUF_SIZE));
+        n = MIN (len, EDIT_BUF_SIZE - i);
+        len -= n;
+        memcpy (b + EDIT_BUF_SIZE - i - n, s + len, (size_t) n);
+        edit_buffer_lines_add (buf->b2_lines, edit_buffer_count_newlines (s + len, n));
+
+        buf->curs2 += n;
+        buf->size += n;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Delete bytes at the cursor position.  Same as edit_buffer_delete() for every byte.
+ *
+ * @param buf pointer to editor buffer
+ * @param bytes buffer for deleted bytes in order of the text, or NULL
+ * @param len number of bytes
+ *
+ * @return number of deleted bytes
+ */
+
+off_t
+edit_buffer_delete_bytes (edit_buffer_t *buf, char *bytes, off_t len)
+{
+    off_t ret;
+
+    len = MIN (len, buf->curs2);
+    ret = len;
+
+    while (len > 0)
+    {
+        char *b;
+        off_t prev, i, n;
+        guint j;
+
+        prev = buf->curs2 - 1;
+        j = (guint) (prev >> S_EDIT_BUF_SIZE);
+        i = prev & M_EDIT_BUF_SIZE;
+
+        b = edit_buffer_get_b2_page (buf, j);
+        n = MIN (len, i + 1);
+        b += EDIT_BUF_SIZE - 1 - i;
+
+        if (bytes != NULL)
+        {
+            memcpy (bytes, b, (size_t) n);
+            bytes += n;
+        }
+
+        edit_buffer_lines_add (buf->b2_lines, -edit_buffer_count_newlines (b, n));
+
+        if (n == i + 1)
+        {
+            g_ptr_array_remove_index (buf->b2, j);
+            g_array_set_size (buf->b2_lines, j);
+        }
+
+        buf->curs2 -= n;
+        buf->size -= n;
+        len -= n;
+    }
+
+    return ret;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Delete bytes before the cursor position and move left.  Same as edit_buffer_backspace() for
+ * every byte.
+ *
+ * @param buf pointer to editor buffer
+ * @param bytes buffer for deleted bytes in order of the text, or NULL
+ * @param len number of bytes
+ *
+ * @return number of deleted bytes
+ */
+
+off_t
+edit_buffer_backspace_bytes (edit_buffer_t *buf, char *bytes, off_t len)
+{
+    off_t ret;
+
+    len = MIN (len, buf->curs1);
+    ret = len;
+
+    while (len > 0)
+    {
+        char *b;
+        off_t prev, i, n;
+        guint j;
+
+        prev = buf->curs1 - 1;
+        j = (guint) (prev >> S_EDIT_BUF_SIZE);
+        i = prev & M_EDIT_BUF_SIZE;
+
+        b = g_ptr_array_index (buf->b1, j);
+        n = MIN (len, i + 1);
+        b += i + 1 - n;
+        len -= n;
+
+        if (bytes != NULL)
+            memcpy (bytes + len, b, (size_t) n);
+
+        edit_buffer_lines_add (buf->b1_lines, -edit_buffer_count_newlines (b, n));
+
+        if (n == i + 1)
+        {
+            g_ptr_array_remove_index (buf->b1, j);
+            g_array_set_size (buf->b1_lines, j);
+        }
+
+        buf->curs1 -= n;
+        buf->size -= n;
+    }
+
+    return ret;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Move the cursor.  Text is moved between b1 and b2 by whole spans.
+ *
+ * @param buf pointer to editor buffer
+ * @param increment number of bytes to move right if positive, left if negative
+ *
+ * @return number of newlines which the cursor has been moved over
+ */
+
+long
+edit_buffer_move_cursor (edit_buffer_t *buf, off_t increment)
+{
+    long lines = 0;
+
+    while (increment > 0 && buf->curs2 != 0)
+    {
+        const char *p;
+        off_t len;
+
+        p = edit_buffer_get_run_forward (buf, buf->curs1, &len);
+        len = MIN (len, increment);
+        lines += edit_buffer_count_newlines (p, len);
+        edit_buffer_insert_bytes (buf, p, len);
+        edit_buffer_delete_bytes (buf, NULL, len);
+        increment -= len;
+    }
+
+    while (increment < 0 && buf->curs1 != 0)
+    {
+        const char *p;
+        off_t len;
+
+        p = edit_buffer_get_run_backward (buf, buf->curs1 - 1, &len);
+        len = MIN (len, -increment);
+        p -= len - 1;
+        lines += edit_buffer_count_newlines (p, len);
+        edit_buffer_insert_ahead_bytes (buf, p, len);
+        edit_buffer_backspace_bytes (buf, NULL, len);
+        increment += len;
+    }
+
+    return lines;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /**
  * Calculate forward offset with specified number of lines.
@@ -642,6 +1392,18 @@ edit_buffer_get_forward_offset (const edit_buffer_t *buf, off_t current, long li
 
     lines = MAX (lines, 0);
 
+    if (lines > EDIT_LINES_SCAN_MAX)
+    {
+        long line, line2;
+
+        line = edit_buffer_get_line (buf, current);
+        line2 = edit_buffer_get_line (buf, buf->size);
+        if (line < line2)
+            current = edit_buffer_get_line_offset (buf, MIN (line + lines, line2));
+
+        return current;
+    }
+
     while (lines-- != 0)
     {
         long next;
@@ -670,6 +1432,10 @@ off_t
 edit_buffer_get_backward_offset (const edit_buffer_t *buf, off_t current, long lines)
 {
     lines = MAX (lines, 0);
+
+    if (lines > EDIT_LINES_SCAN_MAX)
+        return edit_buffer_get_line_offset (buf, edit_buffer_get_line (buf, current) - lines);
+
     current = edit_buffer_get_bol (buf, current);
 
     while (lines-- != 0 && current != 0)
@@ -694,8 +1460,9 @@ edit_buffer_read_file (edit_buffer_t *buf, int fd, off_t size,
                        edit_buffer_read_file_status_msg_t *sm, gboolean *aborted)
 {
     off_t ret = 0;
-    off_t i, j;
+    off_t i;
     off_t data_size;
+    long lines;
     void *b;
     status_msg_t *s = STATUS_MSG (sm);
     unsigned short update_cnt = 0;
@@ -704,6 +1471,16 @@ edit_buffer_read_file (edit_buffer_t *buf, int fd, off_t size,
 
     buf->lines = 0;
     buf->curs2 = size;
+
+    if (size >= EDIT_LAZY_SIZE_MIN)
+    {
+        int file_fd;
+
+        file_fd = vfs_dup_local_fd (fd);
+        if (file_fd != -1)
+            return edit_buffer_read_file_lazily (buf, file_fd, fd, size, sm, aborted);
+    }
+
     i = buf->curs2 >> S_EDIT_BUF_SIZE;
 
     // fill last part of b2
@@ -716,9 +1493,9 @@ edit_buffer_read_file (edit_buffer_t *buf, int fd, off_t size,
         ret = mc_read (fd, b, data_size);
 
         // count lines
-        for (j = 0; j < ret; j++)
-            if (*((char *) b + j) == '\n')
-                buf->lines++;
+        lines = edit_buffer_count_newlines (b, ret);
+        g_array_append_val (buf->b2_lines, lines);
+        buf->lines += lines;
 
         if (ret < 0 || ret != data_size)
             return ret;
@@ -737,9 +1514,9 @@ edit_buffer_read_file (edit_buffer_t *buf, int fd, off_t size,
             ret += sz;
 
         // count lines
-        for (j = 0; j < sz; j++)
-            if (*((char *) b + j) == '\n')
-                buf->lines++;
+        lines = edit_buffer_count_newlines (b, sz);
+        g_array_append_val (buf->b2_lines, lines);
+        buf->lines += lines;
 
         if (s != NULL && s->update != NULL)
         {
@@ -775,6 +1552,11 @@ edit_buffer_read_file (edit_buffer_t *buf, int fd, off_t size,
         *b1 = *b2;
         *b2 = b;
 
+        lines = g_array_index (buf->b2_lines, long, i);
+        g_array_index (buf->b2_lines, long, i) =
+            g_array_index (buf->b2_lines, long, buf->b2_lines->len - 1 - i);
+        g_array_index (buf->b2_lines, long, buf->b2_lines->len - 1 - i) = lines;
+
         if (s != NULL && s->update != NULL)
         {
             update_cnt = (update_cnt + 1) & 0xf;
@@ -790,6 +1572,10 @@ edit_buffer_read_file (edit_buffer_t *buf, int fd, off_t size,
         }
     }
 
+    // make the line index
+    for (i = 1; i < (off_t) buf->b2_lines->len; i++)
+        g_array_index (buf->b2_lines, long, i) += g_array_index (buf->b2_lines, long, i - 1);
+
     return ret;
 }
 
@@ -810,6 +1596,7 @@ edit_buffer_write_file (edit_buffer_t *buf, int fd)
     off_t i;
     off_t data_size, sz;
     void *b;
+    char *page = NULL;
 
     // write all fulfilled parts of b1 from begin to end
     if (buf->b1->len != 0)
@@ -837,36 +1624,75 @@ edit_buffer_write_file (edit_buffer_t *buf, int fd)
             return ret;
     }
 
-    // write b2 from end to begin, if b2 contains some data
-    if (buf->b2->len != 0)
+    // write b2 from end to begin: last partially filled part, then fulfilled parts
+    data_size = ((buf->curs2 - 1) & M_EDIT_BUF_SIZE) + 1;
+    for (i = (off_t) buf->b2->len - 1; i >= 0; i--, data_size = EDIT_BUF_SIZE)
     {
-        // write last partially filled part of b2
-        i = buf->b2->len - 1;
         b = g_ptr_array_index (buf->b2, i);
-        data_size = ((buf->curs2 - 1) & M_EDIT_BUF_SIZE) + 1;
-        sz = mc_write (fd, (char *) b + EDIT_BUF_SIZE - data_size, data_size);
-        if (sz >= 0)
-            ret += sz;
 
-        if (sz == data_size)
+        // buffers which are not read yet are not kept in memory
+        if (b == NULL)
         {
-            // write other fulfilled parts of b2 from end to begin
-            data_size = EDIT_BUF_SIZE;
-            while (--i >= 0)
-            {
-                b = g_ptr_array_index (buf->b2, i);
-                sz = mc_write (fd, b, data_size);
-                if (sz >= 0)
-                    ret += sz;
-                if (sz != data_size)
-                    break;
-            }
+            if (page == NULL)
+                page = g_malloc (EDIT_BUF_SIZE);
+            (void) edit_buffer_read_page (buf, (guint) i, page);
+            b = page;
         }
+
+        sz = mc_write (fd, (char *) b + EDIT_BUF_SIZE - data_size, data_size);
+        if (sz >= 0)
+            ret += sz;
+        if (sz != data_size)
+            break;
     }
 
+    g_free (page);
+
     return ret;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Check if buffers can be read from specified file, then the file must not be overwritten.
+ *
+ * @param buf pointer to editor buffer
+ * @param st status of file
+ *
+ * @return TRUE if buffers are read from the file, FALSE otherwise
+ */
+
+gboolean
+edit_buffer_is_read_from (const edit_buffer_t *buf, const struct stat *st)
+{
+    struct stat file_st;
+
+    return buf->file_fd != -1 && fstat (buf->file_fd, &file_st) == 0
+        && file_st.st_dev == st->st_dev && file_st.st_ino == st->st_ino;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Read all buffers which are not read yet and close the file.  This should be done before
+ * the file is overwritten.
+ *
+ * @param buf pointer to editor buffer
+ */
+
+void
+edit_buffer_read_all (edit_buffer_t *buf)
+{
+    guint i;
+
+    if (buf->file_fd == -1)
+        return;
+
+    for (i = 0; i < buf->b2->len; i++)
+        (void) edit_buffer_get_b2_page (buf, i);
+
+    close (buf->file_fd);
+    buf->file_fd = -1;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /**
  * Calculate percentage of specified character offset
@@ -13,13 +13,17 @@
 
 typedef struct edit_buffer_struct
 {
-    off_t curs1;     // position of the cursor from the beginning of the file.
-    off_t curs2;     // position from the end of the file
-    GPtrArray *b1;   // all data up to curs1
-    GPtrArray *b2;   // all data from end of file down to curs2
-    off_t size;      // file size
-    long lines;      // total lines in the file
-    long curs_line;  // line number of the cursor.
+    off_t curs1;       // position of the cursor from the beginning of the file.
+    off_t curs2;       // position from the end of the file
+    GPtrArray *b1;     // all data up to curs1
+    GPtrArray *b2;     // all data from end of file down to curs2
+    GArray *b1_lines;  // numbers of newlines in b1[0]...b1[i]
+    GArray *b2_lines;  // numbers of newlines in b2[0]...b2[i]
+    off_t size;        // file size
+    long lines;        // total lines in the file
+    long curs_line;    // line number of the cursor.
+    int file_fd;       // file which buffers of b2 are read from, see edit_buffer_read_file()
+    off_t file_size;   // size of that file
 } edit_buffer_t;
 
 typedef struct edit_buffer_read_file_status_msg_struct
@@ -44,6 +48,8 @@ int edit_buffer_get_prev_utf (const edit_buffer_t *buf, off_t byte_index, int *c
 long edit_buffer_count_lines (const edit_buffer_t *buf, off_t first, off_t last);
 off_t edit_buffer_get_bol (const edit_buffer_t *buf, off_t current);
 off_t edit_buffer_get_eol (const edit_buffer_t *buf, off_t current);
+long edit_buffer_get_line (const edit_buffer_t *buf, off_t byte_index);
+off_t edit_buffer_get_line_offset (const edit_buffer_t *buf, long line);
 GString *edit_buffer_get_word_from_pos (const edit_buffer_t *buf, off_t start_pos, off_t *start,
                                         gsize *cut);
 gboolean edit_buffer_find_word_start (const edit_buffer_t *buf, off_t *word_start, gsize *word_len);
@@ -52,6 +58,11 @@ void edit_buffer_insert (edit_buffer_t *buf, int c);
 void edit_buffer_insert_ahead (edit_buffer_t *buf, int c);
 int edit_buffer_delete (edit_buffer_t *buf);
 int edit_buffer_backspace (edit_buffer_t *buf);
+void edit_buffer_insert_bytes (edit_buffer_t *buf, const char *s, off_t len);
+void edit_buffer_insert_ahead_bytes (edit_buffer_t *buf, const char *s, off_t len);
+off_t edit_buffer_delete_bytes (edit_buffer_t *buf, char *bytes, off_t len);
+off_t edit_buffer_backspace_bytes (edit_buffer_t *buf, char *bytes, off_t len);
+long edit_buffer_move_cursor (edit_buffer_t *buf, off_t increment);
 
 off_t edit_buffer_get_forward_offset (const edit_buffer_t *buf, off_t current, long lines,
                                       off_t upto);
@@ -60,6 +71,8 @@ off_t edit_buffer_get_backward_offset (const edit_buffer_t *buf, off_t current,
 off_t edit_buffer_read_file (edit_buffer_t *buf, int fd, off_t size,
                              edit_buffer_read_file_status_msg_t *sm, gboolean *aborted);
 off_t edit_buffer_write_file (edit_buffer_t *buf, int fd);
+gboolean edit_buffer_is_read_from (const edit_buffer_t *buf, const struct stat *st);
+void edit_buffer_read_all (edit_buffer_t *buf);
 
 int edit_buffer_calc_percent (const edit_buffer_t *buf, off_t offset);
 
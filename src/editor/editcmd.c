@@ -202,6 +202,15 @@ edit_save_file (WEdit *edit, const vfs_path_t *filename_vpath)
                 return -1;
             }
         }
+
+        // The buffer can be read from the file: don't overwrite it.
+        if (this_save_mode == EDIT_QUICK_SAVE && edit_buffer_is_read_from (&edit->buffer, &sb))
+        {
+            if (sb.st_nlink > 1)
+                edit_buffer_read_all (&edit->buffer);  // keep hard links
+            else
+                this_save_mode = EDIT_SAFE_SAVE;
+        }
     }
 
     if (this_save_mode == EDIT_QUICK_SAVE)
@@ -503,14 +512,6 @@ edit_block_delete (WEdit *edit, off_t start_mark, off_t end_mark)
     if (edit->column_highlight && edit->mark2 < 0)
         edit_mark_cmd (edit, FALSE);
 
-    // Warning message with a query to continue or cancel the operation
-    if ((end_mark - start_mark) > max_undo / 2
-        && edit_query_dialog2 (_ ("Warning"),
-                               ("Block is large, you may not be able to undo this action"),
-                               _ ("C&ontinue"), _ ("&Cancel"))
-            != 0)
-        return FALSE;
-
     c1 = MIN (edit->column1, edit->column2);
     c2 = MAX (edit->column1, edit->column2);
     edit->column1 = c1;
@@ -547,10 +548,7 @@ edit_block_delete (WEdit *edit, off_t start_mark, off_t end_mark)
         }
         else
         {
-            off_t count;
-
-            for (count = start_mark; count < end_mark; count++)
-                edit_delete (edit, TRUE);
+            edit_delete_bytes (edit, end_mark - start_mark, NULL);
         }
     }
 
@@ -1300,14 +1298,11 @@ edit_block_copy_cmd (WEdit *edit)
     }
     else
     {
-        int size_orig = size;
-
-        while (size-- != 0)
-            edit_insert_ahead (edit, copy_buf[size]);
+        edit_insert_ahead_bytes (edit, (char *) copy_buf, size);
 
         // Place cursor at the end of text selection
         if (edit_options.cursor_after_inserted_block)
-            edit_cursor_move (edit, size_orig);
+            edit_cursor_move (edit, size);
     }
 
     g_free (copy_buf);
@@ -1393,7 +1388,6 @@ edit_block_move_cmd (WEdit *edit)
     }
     else
     {
-        off_t count, count_orig;
         off_t x;
 
         current = edit->buffer.curs1;
@@ -1401,23 +1395,20 @@ edit_block_move_cmd (WEdit *edit)
         edit_cursor_move (edit, start_mark - edit->buffer.curs1);
         edit_scroll_screen_over_cursor (edit);
 
-        for (count = start_mark; count < end_mark; count++)
-            copy_buf[end_mark - count - 1] = edit_delete (edit, TRUE);
+        edit_delete_bytes (edit, end_mark - start_mark, (char *) copy_buf);
 
         edit_scroll_screen_over_cursor (edit);
         x = current > edit->buffer.curs1 ? end_mark - start_mark : 0;
         edit_cursor_move (edit, current - edit->buffer.curs1 - x);
         edit_scroll_screen_over_cursor (edit);
-        count_orig = count;
-        while (count-- > start_mark)
-            edit_insert_ahead (edit, copy_buf[end_mark - count - 1]);
+        edit_insert_ahead_bytes (edit, (char *) copy_buf, end_mark - start_mark);
 
         edit_set_markers (edit, edit->buffer.curs1, edit->buffer.curs1 + end_mark - start_mark, 0,
                           0);
 
         // Place cursor at the end of text selection
         if (edit_options.cursor_after_inserted_block)
-            edit_cursor_move (edit, count_orig - start_mark);
+            edit_cursor_move (edit, end_mark - start_mark);
     }
 
     edit_scroll_screen_over_cursor (edit);
@@ -0,0 +1,454 @@
+/*
+   Editor undo and redo log.
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** \file
+ *  \brief Source: editor undo and redo log.
+ *
+ *  The log is a stack of records.  A record is an action code with a number of repeats, so runs
+ *  of cursor movements and deletions take one record.  Inserted bytes which are needed to undo
+ *  a deletion are kept in one array in the order they are pushed, and the record keeps their
+ *  number only.  Bytes of records are found from the end of the array down since records are
+ *  popped from the top of the stack.
+ *
+ *  Records which start groups of actions (key presses) separate the log into groups.  When there
+ *  are too many records, the oldest groups are dropped.  When bytes take too much memory, they
+ *  are written to the spill file and read back when records are popped.  A record keeps at most
+ *  EDIT_UNDO_RECORD_MAX bytes, so bytes of a big action are kept by several records, and one
+ *  record at a time is read back and applied.
+ */
+
+#include <config.h>
+
+#include <errno.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "lib/global.h"
+
+#include "lib/vfs/vfs.h"  // mc_mkstemps()
+
+#include "editundo.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+/* Bytes are written to the spill file if there are more of them in memory */
+#ifndef EDIT_UNDO_MEMORY_MAX
+#define EDIT_UNDO_MEMORY_MAX (64 * 1024 * 1024)
+#endif
+
+/* Maximal number of bytes of one record */
+#ifndef EDIT_UNDO_RECORD_MAX
+#define EDIT_UNDO_RECORD_MAX (1024 * 1024)
+#endif
+
+/*** file scope type declarations ****************************************************************/
+
+/*** forward declarations (file scope functions) *************************************************/
+
+/*** file scope variables ************************************************************************/
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Write all bytes in memory to the spill file.
+ *
+ * @return TRUE on success, FALSE if the file cannot be created or written
+ */
+
+static gboolean
+edit_undo_log_spill (edit_undo_log_t *log)
+{
+    const char *p = (const char *) log->data->data;
+    off_t len = log->size - log->base;
+
+    if (!log->spill)
+        return FALSE;
+
+    if (log->fd == -1)
+    {
+        vfs_path_t *vpath;
+
+        log->fd = mc_mkstemps (&vpath, "mcundo", NULL);
+        if (log->fd == -1)
+        {
+            log->spill = FALSE;
+            return FALSE;
+        }
+
+        // the file is removed when it is closed
+        unlink (vfs_path_as_str (vpath));
+        vfs_path_free (vpath, TRUE);
+    }
+
+    if (lseek (log->fd, log->base, SEEK_SET) != log->base)
+    {
+        log->spill = FALSE;
+        return FALSE;
+    }
+
+    while (len > 0)
+    {
+        ssize_t n;
+
+        n = write (log->fd, p, (size_t) len);
+        if (n == -1)
+        {
+            if (errno == EINTR)
+                continue;
+
+            log->spill = FALSE;
+            return FALSE;
+        }
+
+        p += n;
+        len -= n;
+    }
+
+    g_byte_array_set_size (log->data, 0);
+    log->base = log->size;
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Read bytes from @offset up to the beginning of bytes in memory from the spill file.  Bytes
+ * after @offset are bytes of one record and bytes of records in memory, so their number fits
+ * into GByteArray.
+ *
+ * @return TRUE on success, FALSE if the file cannot be read
+ */
+
+static gboolean
+edit_undo_log_load (edit_undo_log_t *log, off_t offset)
+{
+    GByteArray *data;
+    char *p;
+    off_t len;
+
+    if (log->fd == -1 || lseek (log->fd, offset, SEEK_SET) != offset)
+        return FALSE;
+
+    len = log->base - offset;
+    data = g_byte_array_sized_new ((guint) (log->size - offset));
+    g_byte_array_set_size (data, (guint) len);
+    p = (char *) data->data;
+
+    while (len > 0)
+    {
+        ssize_t n;
+
+        n = read (log->fd, p, (size_t) len);
+        if (n == -1 && errno == EINTR)
+            continue;
+        if (n <= 0)
+        {
+            g_byte_array_free (data, TRUE);
+            return FALSE;
+        }
+
+        p += n;
+        len -= n;
+    }
+
+    g_byte_array_append (data, log->data->data, (guint) (log->size - log->base));
+    g_byte_array_free (log->data, TRUE);
+    log->data = data;
+    log->base = offset;
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Drop the oldest groups of records.  The last group is never dropped.
+ *
+ * @param count minimal number of records to drop
+ * @param len minimal number of bytes to drop
+ */
+
+static void
+edit_undo_log_drop (edit_undo_log_t *log, guint count, off_t len)
+{
+    guint i, n = 0;
+    off_t bytes = 0, dropped = 0;
+
+    for (i = 1; i <= log->last_group; i++)
+    {
+        const edit_undo_record_t *record;
+
+        record = &g_array_index (log->records, edit_undo_record_t, i - 1);
+        if (record->bytes)
+            bytes += record->count;
+
+        record = &g_array_index (log->records, edit_undo_record_t, i);
+        if (record->action >= log->group)
+        {
+            n = i;
+            dropped = bytes;
+
+            if (n >= count && dropped >= len)
+                break;
+        }
+    }
+
+    if (n == 0)
+        return;
+
+    g_array_remove_range (log->records, 0, n);
+    log->last_group -= n;
+    log->bottom += dropped;
+
+    if (log->bottom > log->base)
+    {
+        // bytes of popped records can be after the end
+        g_byte_array_set_size (log->data, (guint) (log->size - log->base));
+        g_byte_array_remove_range (log->data, 0, (guint) (log->bottom - log->base));
+        log->base = log->bottom;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+edit_undo_log_shrink (edit_undo_log_t *log)
+{
+    if (log->size - log->base > EDIT_UNDO_MEMORY_MAX && !edit_undo_log_spill (log))
+        edit_undo_log_drop (log, 0, (log->size - log->base) / 2);
+
+    if (log->records->len > log->limit)
+        edit_undo_log_drop (log, log->records->len - log->limit / 4 * 3, 0);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+edit_undo_log_append (edit_undo_log_t *log, long action, off_t count, gboolean bytes)
+{
+    edit_undo_record_t record = { action, count, bytes };
+
+    g_array_append_val (log->records, record);
+    if (action >= log->group)
+        log->last_group = log->records->len - 1;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Initialize undo log.
+ *
+ * @param log undo log
+ * @param group actions starting from that code start groups of actions
+ * @param limit maximal number of records kept besides the last group
+ */
+
+void
+edit_undo_log_init (edit_undo_log_t *log, long group, guint limit)
+{
+    log->records = g_array_new (FALSE, FALSE, sizeof (edit_undo_record_t));
+    log->group = group;
+    log->limit = limit;
+    log->last_group = 0;
+    log->data = g_byte_array_new ();
+    log->base = 0;
+    log->bottom = 0;
+    log->size = 0;
+    log->fd = -1;
+    log->spill = TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Clean undo log.
+ *
+ * @param log undo log
+ */
+
+void
+edit_undo_log_clean (edit_undo_log_t *log)
+{
+    // not initialized
+    if (log->records == NULL)
+        return;
+
+    g_array_free (log->records, TRUE);
+    log->records = NULL;
+    g_byte_array_free (log->data, TRUE);
+    log->data = NULL;
+
+    if (log->fd != -1)
+    {
+        close (log->fd);
+        log->fd = -1;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Remove all records from undo log.
+ *
+ * @param log undo log
+ */
+
+void
+edit_undo_log_reset (edit_undo_log_t *log)
+{
+    g_array_set_size (log->records, 0);
+    log->last_group = 0;
+    g_byte_array_set_size (log->data, 0);
+    log->base = 0;
+    log->bottom = 0;
+    log->size = 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Push action onto undo log.  The action is merged with the top record if it is the same.
+ *
+ * @param log undo log
+ * @param action code of action
+ * @param count number of repeats of action
+ */
+
+void
+edit_undo_log_push (edit_undo_log_t *log, long action, off_t count)
+{
+    edit_undo_record_t *last;
+
+    if (count <= 0)
+        return;
+
+    last = (edit_undo_record_t *) edit_undo_log_last (log);
+    if (last != NULL && !last->bytes && last->action == action)
+        last->count += count;
+    else
+    {
+        edit_undo_log_append (log, action, count, FALSE);
+        edit_undo_log_shrink (log);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Push action with bytes onto undo log.  Bytes are appended to the top record if its action
+ * is the same.  Records are added for bytes which do not fit into the top record: applying
+ * them one after another is the same as applying all bytes at once.
+ *
+ * @param log undo log
+ * @param action code of action
+ * @param bytes bytes of action
+ * @param len number of bytes
+ */
+
+void
+edit_undo_log_push_bytes (edit_undo_log_t *log, long action, const char *bytes, off_t len)
+{
+    while (len > 0)
+    {
+        edit_undo_record_t *last;
+        off_t n;
+
+        last = (edit_undo_record_t *) edit_undo_log_last (log);
+        if (last != NULL && last->bytes && last->action == action
+            && last->count < EDIT_UNDO_RECORD_MAX)
+        {
+            n = MIN (len, EDIT_UNDO_RECORD_MAX - last->count);
+            last->count += n;
+        }
+        else
+        {
+            n = MIN (len, EDIT_UNDO_RECORD_MAX);
+            edit_undo_log_append (log, action, n, TRUE);
+        }
+
+        // bytes of popped records are kept until now
+        g_byte_array_set_size (log->data, (guint) (log->size - log->base));
+        g_byte_array_append (log->data, (const guint8 *) bytes, (guint) n);
+        log->size += n;
+        bytes += n;
+        len -= n;
+
+        edit_undo_log_shrink (log);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Pop the top record from undo log.
+ *
+ * @param log undo log
+ * @param record popped record
+ * @param bytes bytes of the record in the order they were pushed, NULL if the record has
+ *              no bytes.  They are valid until the next push onto @log
+ *
+ * @return TRUE if a record is popped, FALSE if the log is empty
+ */
+
+gboolean
+edit_undo_log_pop (edit_undo_log_t *log, edit_undo_record_t *record, const char **bytes)
+{
+    off_t start;
+
+    if (log->records->len == 0)
+        return FALSE;
+
+    *record = *edit_undo_log_last (log);
+    g_array_set_size (log->records, log->records->len - 1);
+
+    // the last group is popped: find the previous one
+    if (log->last_group >= log->records->len)
+    {
+        guint i;
+
+        log->last_group = 0;
+
+        for (i = log->records->len; i > 0; i--)
+            if (g_array_index (log->records, edit_undo_record_t, i - 1).action >= log->group)
+            {
+                log->last_group = i - 1;
+                break;
+            }
+    }
+
+    *bytes = NULL;
+
+    if (!record->bytes)
+        return TRUE;
+
+    start = log->size - record->count;
+    if (start < log->base && !edit_undo_log_load (log, start))
+    {
+        edit_undo_log_reset (log);
+        return FALSE;
+    }
+
+    *bytes = (const char *) log->data->data + (start - log->base);
+    log->size = start;
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
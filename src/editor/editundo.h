@@ -0,0 +1,60 @@
+/** \file
+ *  \brief Header: undo and redo log for WEdit
+ */
+
+#ifndef MC__EDIT_UNDO_H
+#define MC__EDIT_UNDO_H
+
+/*** typedefs(not structures) and defined constants **********************************************/
+
+/*** enums ***************************************************************************************/
+
+/*** structures declarations (and typedefs of structures)*****************************************/
+
+typedef struct
+{
+    long action;     // code of action, see edit-impl.h
+    off_t count;     // number of repeats of action or number of bytes
+    gboolean bytes;  // TRUE if the log keeps @count bytes of action
+} edit_undo_record_t;
+
+typedef struct
+{
+    GArray *records;   // edit_undo_record_t, the last one is the top of the log
+    long group;        // records with action not less than that start groups of actions
+    guint limit;       // number of records which older groups are dropped after
+    guint last_group;  // index of the record which starts the last group
+    GByteArray *data;  // bytes of records from offset base up to size
+    off_t base;        // bytes before that are spilled to the file or dropped
+    off_t bottom;      // offset of bytes of the first record
+    off_t size;        // offset of the end of bytes of the last record
+    int fd;            // spill file, -1 if not created yet
+    gboolean spill;    // FALSE if the spill file cannot be used
+} edit_undo_log_t;
+
+/*** global variables defined in .c file *********************************************************/
+
+/*** declarations of public functions ************************************************************/
+
+void edit_undo_log_init (edit_undo_log_t *log, long group, guint limit);
+void edit_undo_log_clean (edit_undo_log_t *log);
+void edit_undo_log_reset (edit_undo_log_t *log);
+
+void edit_undo_log_push (edit_undo_log_t *log, long action, off_t count);
+void edit_undo_log_push_bytes (edit_undo_log_t *log, long action, const char *bytes, off_t len);
+gboolean edit_undo_log_pop (edit_undo_log_t *log, edit_undo_record_t *record, const char **bytes);
+
+/*** inline functions ****************************************************************************/
+
+static inline const edit_undo_record_t *
+edit_undo_log_last (const edit_undo_log_t *log)
+{
+    if (log->records->len == 0)
+        return NULL;
+
+    return &g_array_index (log->records, edit_undo_record_t, log->records->len - 1);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+#endif
@@ -12,11 +12,10 @@
 
 #include "edit-impl.h"
 #include "editbuffer.h"
+#include "editundo.h"
 
 /*** typedefs(not structures) and defined constants **********************************************/
 
-#define N_LINE_CACHES 32
-
 /*** enums ***************************************************************************************/
 
 /*** structures declarations (and typedefs of structures)*****************************************/
@@ -113,28 +112,15 @@ struct WEdit
     off_t bracket;        // position of a matching bracket
     off_t last_bracket;   // previous position of a matching bracket
 
-    // cache speedup for line lookups
-    gboolean caches_valid;
-    long line_numbers[N_LINE_CACHES];
-    off_t line_offsets[N_LINE_CACHES];
-
     edit_book_mark_t *book_mark;
     GArray *serialized_bookmarks;
 
-    // undo stack and pointers
-    unsigned long undo_stack_pointer;
-    long *undo_stack;
-    unsigned long undo_stack_size;
-    unsigned long undo_stack_size_mask;
-    unsigned long undo_stack_bottom;
-    unsigned int undo_stack_disable : 1;  // If not 0, don't save events in the undo stack
-
-    unsigned long redo_stack_pointer;
-    long *redo_stack;
-    unsigned long redo_stack_size;
-    unsigned long redo_stack_size_mask;
-    unsigned long redo_stack_bottom;
-    unsigned int redo_stack_reset : 1;  // If 1, need clear redo stack
+    // undo and redo logs
+    edit_undo_log_t undo_log;
+    unsigned int undo_stack_disable : 1;  // If not 0, don't save events in the undo log
+
+    edit_undo_log_t redo_log;
+    unsigned int redo_stack_reset : 1;  // If 1, need clear redo log
 
     struct stat stat1;    // Result of mc_fstat() on the file
     unsigned long attrs;  // Result of mc_fgetflags() on the file
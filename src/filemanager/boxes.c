@@ -719,6 +719,7 @@ panel_options_box (void)
                     QUICK_CHECKBOX (N_ ("Show &backup files"), &panels_options.show_backups, NULL),
                     QUICK_CHECKBOX (N_ ("Show &hidden files"), &panels_options.show_dot_files, NULL),
                     QUICK_CHECKBOX (N_ ("&Fast dir reload"), &panels_options.fast_reload, NULL),
+                    QUICK_CHECKBOX (N_ ("Watch dir &changes"), &panels_options.watch_dirs, NULL),
                     QUICK_CHECKBOX (N_ ("Ma&rk moves down"), &panels_options.mark_moves_down, NULL),
                     QUICK_CHECKBOX (N_ ("Re&verse files only"), &panels_options.reverse_files_only,
                                     NULL),
@@ -727,7 +728,6 @@ panel_options_box (void)
                                     NULL),
                     QUICK_SEPARATOR (FALSE),
                     QUICK_SEPARATOR (FALSE),
-                    QUICK_SEPARATOR (FALSE),
                 QUICK_STOP_GROUPBOX,
             QUICK_NEXT_COLUMN,
                 QUICK_START_GROUPBOX (N_ ("Navigation")),
@@ -1072,6 +1072,11 @@ configure_vfs_box (void)
             QUICK_CHECKBOX (N_ ("Use &passive mode"), &ftpfs_use_passive_connections, NULL),
             QUICK_CHECKBOX (N_ ("Use passive mode over pro&xy"),
                             &ftpfs_use_passive_connections_over_proxy, NULL),
+#endif
+#ifdef ENABLE_VFS_NET
+            QUICK_SEPARATOR (TRUE),
+            QUICK_CHECKBOX (N_ ("&Keep directory listings on disk"), &vfs_persistent_dircache,
+                            NULL),
 #endif
             QUICK_BUTTONS_OK_CANCEL,
             QUICK_END,
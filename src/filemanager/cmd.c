@@ -799,6 +799,12 @@ reread_cmd (void)
         && vfs_path_equal (current_panel->cwd_vpath, other_panel->cwd_vpath))
         flag = UP_OPTIMIZE;
 
+    // read directories again even if they are watched
+    if (get_current_type () == view_listing)
+        panel_watch_stop (current_panel);
+    if (flag == UP_OPTIMIZE)
+        panel_watch_stop (other_panel);
+
     update_panels (UP_RELOAD | flag, UP_KEEPSEL);
     repaint_screen ();
 }
@@ -940,6 +946,7 @@ edit_fhl_cmd (void)
     // refresh highlighting rules
     mc_fhl_free (&mc_filehighlight);
     mc_filehighlight = mc_fhl_new (TRUE);
+    panel_row_cache_invalidate ();
 }
 
 /* --------------------------------------------------------------------------------------------- */
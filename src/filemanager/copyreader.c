@@ -0,0 +1,271 @@
+/*
+   Reading of source file in background thread while copying.
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** \file copyreader.c
+ *  \brief Source: reading of source file in background thread while copying
+ *
+ *  If source and destination files are on different VFSs (e.g. local disk and sftp), their
+ *  latencies add up when source buffer is read and then written.  If the source file is local,
+ *  the copy reader reads it in background threads into the ring of buffers, so the main thread
+ *  writes one buffer while next ones are being read.  Memory usage is bounded by the size
+ *  of ring.
+ *
+ *  VFS is not thread-safe, so the threads don't call VFS functions: they read the local file
+ *  by pread() from the descriptor duplicated by vfs_dup_local_fd().  Every thread reads its own
+ *  buffer at its own offset, so COPY_READER_THREADS reads are in flight.
+ *
+ *  After short read, end of file or read error the reader waits until the buffer with result
+ *  is released by the main thread and then continues from the end of data.  So the main thread
+ *  can report the error and retry reading.
+ */
+
+#include <config.h>
+
+#include <errno.h>
+#include <unistd.h>
+
+#include "lib/global.h"
+
+#include "copyreader.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+#define COPY_READER_BUFFERS 8
+#define COPY_READER_THREADS 4
+
+/*** file scope type declarations ****************************************************************/
+
+typedef struct
+{
+    char *data;
+    off_t offset;      // offset of data in file
+    ssize_t len;       // result of pread()
+    int error;         // errno if len < 0
+    gboolean reading;  // buffer is being read
+} copy_reader_buffer_t;
+
+struct copy_reader_struct
+{
+    GThread *threads[COPY_READER_THREADS];
+    GMutex lock;
+    GCond cond;
+
+    int fd;
+    size_t bufsize;
+
+    copy_reader_buffer_t buffers[COPY_READER_BUFFERS];
+    int head;          // first buffer in order of file
+    int count;         // number of buffers being read or filled
+    int reading;       // number of buffers being read
+    off_t offset;      // offset of the next buffer to read
+    gboolean waiting;  // short read, end of file or error is read
+    gboolean stop;
+};
+
+/*** forward declarations (file scope functions) *************************************************/
+
+/*** file scope variables ************************************************************************/
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+static gpointer
+copy_reader_run (gpointer data)
+{
+    copy_reader_t *reader = (copy_reader_t *) data;
+
+    g_mutex_lock (&reader->lock);
+
+    while (!reader->stop)
+    {
+        copy_reader_buffer_t *b;
+
+        if (reader->waiting || reader->count == COPY_READER_BUFFERS)
+        {
+            g_cond_wait (&reader->cond, &reader->lock);
+            continue;
+        }
+
+        // free buffer is not accessed by the main thread and other threads
+        b = &reader->buffers[(reader->head + reader->count) % COPY_READER_BUFFERS];
+        b->offset = reader->offset;
+        b->reading = TRUE;
+        reader->offset += (off_t) reader->bufsize;
+        reader->count++;
+        reader->reading++;
+
+        g_mutex_unlock (&reader->lock);
+        do
+            b->len = pread (reader->fd, b->data, reader->bufsize, b->offset);
+        while (b->len < 0 && errno == EINTR);
+        b->error = b->len < 0 ? errno : 0;
+        g_mutex_lock (&reader->lock);
+
+        b->reading = FALSE;
+        reader->reading--;
+        // next buffers are not in order with this one
+        if (b->len != (ssize_t) reader->bufsize)
+            reader->waiting = TRUE;
+        g_cond_broadcast (&reader->cond);
+    }
+
+    g_mutex_unlock (&reader->lock);
+
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Start reading of local file.
+ *
+ * @param fd descriptor of file, e.g. got by vfs_dup_local_fd(), it is closed by the reader
+ * @param offset offset to start reading from
+ * @param bufsize size of buffers
+ *
+ * @return new reader, NULL if threads cannot be created
+ */
+
+copy_reader_t *
+copy_reader_new (int fd, off_t offset, size_t bufsize)
+{
+    copy_reader_t *reader;
+    int i;
+
+    reader = g_new0 (copy_reader_t, 1);
+    g_mutex_init (&reader->lock);
+    g_cond_init (&reader->cond);
+    reader->fd = fd;
+    reader->bufsize = bufsize;
+    reader->offset = offset;
+
+    for (i = 0; i < COPY_READER_BUFFERS; i++)
+        reader->buffers[i].data = g_malloc (bufsize);
+
+    for (i = 0; i < COPY_READER_THREADS; i++)
+    {
+        reader->threads[i] = g_thread_try_new ("copy-reader", copy_reader_run, reader, NULL);
+        if (reader->threads[i] == NULL)
+        {
+            copy_reader_free (reader);
+            return NULL;
+        }
+    }
+
+    return reader;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Stop reading and free the reader.  Waits for current pread() calls.
+ */
+
+void
+copy_reader_free (copy_reader_t *reader)
+{
+    int i;
+
+    if (reader == NULL)
+        return;
+
+    g_mutex_lock (&reader->lock);
+    reader->stop = TRUE;
+    g_cond_broadcast (&reader->cond);
+    g_mutex_unlock (&reader->lock);
+
+    for (i = 0; i < COPY_READER_THREADS && reader->threads[i] != NULL; i++)
+        g_thread_join (reader->threads[i]);
+
+    for (i = 0; i < COPY_READER_BUFFERS; i++)
+        g_free (reader->buffers[i].data);
+
+    close (reader->fd);
+    g_cond_clear (&reader->cond);
+    g_mutex_clear (&reader->lock);
+    g_free (reader);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Wait for next buffer.  Buffer is valid until copy_reader_release().
+ *
+ * @param buf   read data
+ * @param error errno of failed read
+ *
+ * @return the same as read(): size of data, 0 at end of file, -1 on error
+ */
+
+ssize_t
+copy_reader_get (copy_reader_t *reader, char **buf, int *error)
+{
+    const copy_reader_buffer_t *b = &reader->buffers[reader->head];
+
+    g_mutex_lock (&reader->lock);
+    while (reader->count == 0 || b->reading)
+        g_cond_wait (&reader->cond, &reader->lock);
+    g_mutex_unlock (&reader->lock);
+
+    *buf = b->data;
+    *error = b->error;
+
+    return b->len;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Return buffer got by copy_reader_get() to the reader.  If it is short or contains end of file
+ * or error, the buffers read after it are dropped and the file is read again from the end of
+ * its data.
+ */
+
+void
+copy_reader_release (copy_reader_t *reader)
+{
+    const copy_reader_buffer_t *b = &reader->buffers[reader->head];
+
+    g_mutex_lock (&reader->lock);
+    if (reader->count != 0)
+    {
+        if (b->len == (ssize_t) reader->bufsize)
+            reader->count--;
+        else
+        {
+            // buffers after this one can be being read yet
+            while (reader->reading != 0)
+                g_cond_wait (&reader->cond, &reader->lock);
+
+            reader->offset = b->offset + MAX (b->len, 0);
+            reader->count = 0;
+            reader->waiting = FALSE;
+        }
+
+        reader->head = (reader->head + 1) % COPY_READER_BUFFERS;
+        g_cond_broadcast (&reader->cond);
+    }
+    g_mutex_unlock (&reader->lock);
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,29 @@
+/** \file copyreader.h
+ *  \brief Header: reading of source file in background thread while copying
+ */
+
+#ifndef MC__COPYREADER_H
+#define MC__COPYREADER_H
+
+#include "lib/global.h"
+
+/*** typedefs(not structures) and defined constants **********************************************/
+
+typedef struct copy_reader_struct copy_reader_t;
+
+/*** enums ***************************************************************************************/
+
+/*** structures declarations (and typedefs of structures)*****************************************/
+
+/*** global variables defined in .c file *********************************************************/
+
+/*** declarations of public functions ************************************************************/
+
+copy_reader_t *copy_reader_new (int fd, off_t offset, size_t bufsize);
+void copy_reader_free (copy_reader_t *reader);
+ssize_t copy_reader_get (copy_reader_t *reader, char **buf, int *error);
+void copy_reader_release (copy_reader_t *reader);
+
+/*** inline functions ****************************************************************************/
+
+#endif
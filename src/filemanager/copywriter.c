@@ -0,0 +1,278 @@
+/*
+   Writing of target file in background thread while copying.
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** \file copywriter.c
+ *  \brief Source: writing of target file in background thread while copying
+ *
+ *  If source file is not local (e.g. sftp or archive) and target file is local, the main thread
+ *  reads the source file by mc_read() into the ring of buffers and the copy writer writes them
+ *  to the target file in background thread.  So the next buffer is read while the previous one
+ *  is being written.  Memory usage is bounded by the size of ring.
+ *
+ *  VFS is not thread-safe, so the thread doesn't call VFS functions: it writes the local file
+ *  by write() to the descriptor duplicated by vfs_dup_local_fd().  Buffers are written in order.
+ *
+ *  After write error the writer waits until the main thread reports it and either retries
+ *  writing of the rest of buffer or skips it.
+ */
+
+#include <config.h>
+
+#include <errno.h>
+#include <unistd.h>
+
+#include "lib/global.h"
+
+#include "copywriter.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+#define COPY_WRITER_BUFFERS 4
+
+/*** file scope type declarations ****************************************************************/
+
+typedef struct
+{
+    char *data;
+    size_t len;      // size of data
+    size_t written;  // size of written data
+} copy_writer_buffer_t;
+
+struct copy_writer_struct
+{
+    GThread *thread;
+    GMutex lock;
+    GCond cond;
+
+    int fd;
+    size_t bufsize;
+
+    copy_writer_buffer_t buffers[COPY_WRITER_BUFFERS];
+    int head;   // first filled buffer
+    int count;  // number of filled buffers
+    int error;  // errno of failed write of the first buffer, 0 if there is no error
+    gboolean stop;
+};
+
+/*** forward declarations (file scope functions) *************************************************/
+
+/*** file scope variables ************************************************************************/
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+static gpointer
+copy_writer_run (gpointer data)
+{
+    copy_writer_t *writer = (copy_writer_t *) data;
+
+    g_mutex_lock (&writer->lock);
+
+    while (!writer->stop)
+    {
+        copy_writer_buffer_t *b;
+        ssize_t n;
+
+        if (writer->error != 0 || writer->count == 0)
+        {
+            g_cond_wait (&writer->cond, &writer->lock);
+            continue;
+        }
+
+        // filled buffer is not accessed by the main thread
+        b = &writer->buffers[writer->head];
+
+        g_mutex_unlock (&writer->lock);
+        do
+            n = write (writer->fd, b->data + b->written, b->len - b->written);
+        while (n < 0 && errno == EINTR);
+        if (n > 0)
+            b->written += (size_t) n;
+        g_mutex_lock (&writer->lock);
+
+        if (n <= 0)
+            writer->error = n < 0 ? errno : ENOSPC;
+        else if (b->written == b->len)
+        {
+            writer->head = (writer->head + 1) % COPY_WRITER_BUFFERS;
+            writer->count--;
+        }
+
+        g_cond_broadcast (&writer->cond);
+    }
+
+    g_mutex_unlock (&writer->lock);
+
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Start writing of local file.
+ *
+ * @param fd descriptor of file, e.g. got by vfs_dup_local_fd(), it is closed by the writer
+ * @param bufsize size of buffers
+ *
+ * @return new writer, NULL if thread cannot be created
+ */
+
+copy_writer_t *
+copy_writer_new (int fd, size_t bufsize)
+{
+    copy_writer_t *writer;
+    int i;
+
+    writer = g_new0 (copy_writer_t, 1);
+    g_mutex_init (&writer->lock);
+    g_cond_init (&writer->cond);
+    writer->fd = fd;
+    writer->bufsize = bufsize;
+
+    for (i = 0; i < COPY_WRITER_BUFFERS; i++)
+        writer->buffers[i].data = g_malloc (bufsize);
+
+    writer->thread = g_thread_try_new ("copy-writer", copy_writer_run, writer, NULL);
+    if (writer->thread == NULL)
+    {
+        copy_writer_free (writer);
+        writer = NULL;
+    }
+
+    return writer;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Stop writing and free the writer.  Waits for current write() call, buffers which are not
+ * written yet are dropped.
+ */
+
+void
+copy_writer_free (copy_writer_t *writer)
+{
+    int i;
+
+    if (writer == NULL)
+        return;
+
+    if (writer->thread != NULL)
+    {
+        g_mutex_lock (&writer->lock);
+        writer->stop = TRUE;
+        g_cond_broadcast (&writer->cond);
+        g_mutex_unlock (&writer->lock);
+
+        g_thread_join (writer->thread);
+    }
+
+    for (i = 0; i < COPY_WRITER_BUFFERS; i++)
+        g_free (writer->buffers[i].data);
+
+    close (writer->fd);
+    g_cond_clear (&writer->cond);
+    g_mutex_clear (&writer->lock);
+    g_free (writer);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Wait for free buffer or for all buffers are written.
+ *
+ * @param all TRUE to wait for all buffers are written
+ *
+ * @return 0 on success, errno of failed write otherwise
+ */
+
+int
+copy_writer_wait (copy_writer_t *writer, gboolean all)
+{
+    int error;
+
+    g_mutex_lock (&writer->lock);
+    while (writer->error == 0 && (all ? writer->count != 0 : writer->count == COPY_WRITER_BUFFERS))
+        g_cond_wait (&writer->cond, &writer->lock);
+    error = writer->error;
+    g_mutex_unlock (&writer->lock);
+
+    return error;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get free buffer to fill.  copy_writer_wait() must return 0 before.
+ */
+
+char *
+copy_writer_get (copy_writer_t *writer)
+{
+    // free buffer is not accessed by the thread
+    return writer->buffers[(writer->head + writer->count) % COPY_WRITER_BUFFERS].data;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Queue buffer got by copy_writer_get() to write.
+ *
+ * @param len size of data in buffer
+ */
+
+void
+copy_writer_put (copy_writer_t *writer, size_t len)
+{
+    copy_writer_buffer_t *b;
+
+    g_mutex_lock (&writer->lock);
+    b = &writer->buffers[(writer->head + writer->count) % COPY_WRITER_BUFFERS];
+    b->len = len;
+    b->written = 0;
+    writer->count++;
+    g_cond_broadcast (&writer->cond);
+    g_mutex_unlock (&writer->lock);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Continue writing after error reported by copy_writer_wait().
+ *
+ * @param skip TRUE to drop the rest of buffer which cannot be written, FALSE to retry writing
+ */
+
+void
+copy_writer_continue (copy_writer_t *writer, gboolean skip)
+{
+    g_mutex_lock (&writer->lock);
+    if (skip && writer->count != 0)
+    {
+        writer->head = (writer->head + 1) % COPY_WRITER_BUFFERS;
+        writer->count--;
+    }
+    writer->error = 0;
+    g_cond_broadcast (&writer->cond);
+    g_mutex_unlock (&writer->lock);
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,31 @@
+/** \file copywriter.h
+ *  \brief Header: writing of target file in background thread while copying
+ */
+
+#ifndef MC__COPYWRITER_H
+#define MC__COPYWRITER_H
+
+#include "lib/global.h"
+
+/*** typedefs(not structures) and defined constants **********************************************/
+
+typedef struct copy_writer_struct copy_writer_t;
+
+/*** enums ***************************************************************************************/
+
+/*** structures declarations (and typedefs of structures)*****************************************/
+
+/*** global variables defined in .c file *********************************************************/
+
+/*** declarations of public functions ************************************************************/
+
+copy_writer_t *copy_writer_new (int fd, size_t bufsize);
+void copy_writer_free (copy_writer_t *writer);
+int copy_writer_wait (copy_writer_t *writer, gboolean all);
+char *copy_writer_get (copy_writer_t *writer);
+void copy_writer_put (copy_writer_t *writer, size_t len);
+void copy_writer_continue (copy_writer_t *writer, gboolean skip);
+
+/*** inline functions ****************************************************************************/
+
+#endif
@@ -34,6 +34,10 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
+#ifdef HAVE_FSTATAT
+#include <fcntl.h>   // open(), AT_SYMLINK_NOFOLLOW
+#include <unistd.h>  // close()
+#endif
 
 #include "lib/global.h"
 #include "lib/tty/tty.h"
@@ -58,8 +62,95 @@
          ? 1                                                                                       \
          : ((S_ISDIR (x->st.st_mode) || link_isdir (x)) ? 2 : 0))
 
+/* lists longer than this are sorted using several threads */
+#define DIR_SORT_PARALLEL_MIN 16384
+/* number of runs sorted in parallel */
+#define DIR_SORT_MAX_THREADS 4
+/* arena of name keys made for entries with equal primary keys */
+#define DIR_SORT_TIES_ARENA DIR_SORT_MAX_THREADS
+
+/* show partially read directory if reading takes longer than this, us */
+#define DIR_LIST_PARTIAL_DELAY (200 * G_TIME_SPAN_MILLISECOND)
+
+#ifdef HAVE_FSTATAT
+#ifndef O_DIRECTORY
+#define O_DIRECTORY 0
+#endif
+#ifndef O_CLOEXEC
+#define O_CLOEXEC 0
+#endif
+
+/* number of entries stat'ed by one worker task */
+#define DIR_STAT_BATCH_SIZE 256
+/* stat() is I/O bound, so the number of workers doesn't depend on number of CPUs */
+#define DIR_STAT_MAX_THREADS 8
+/* how often the directory read callback is called while waiting for workers, us */
+#define DIR_STAT_WAIT_TIMEOUT (100 * G_TIME_SPAN_MILLISECOND)
+#endif
+
 /*** file scope type declarations ****************************************************************/
 
+/* primary sort key */
+typedef enum
+{
+    DIR_SORT_BY_NAME = 0,
+    DIR_SORT_BY_VERSION,
+    DIR_SORT_BY_EXT,
+    DIR_SORT_BY_MTIME,
+    DIR_SORT_BY_ATIME,
+    DIR_SORT_BY_CTIME,
+    DIR_SORT_BY_SIZE,
+    DIR_SORT_BY_INODE
+} dir_sort_by_t;
+
+/* precomputed sort keys of directory entry */
+typedef struct
+{
+    guint64 name_prefix;  // first bytes of name key, comparable as number
+    guint64 ext_prefix;   // first bytes of extension key, comparable as number
+    gint64 num;           // time, size or inode
+    const char *name;     // file name for version sort
+    gsize name_key;       // offset of name key in the key arena
+    gsize ext_key;        // offset of extension key in the key arena
+    int group;            // MY_ISDIR() of entry
+    int index;            // index of entry in the list
+    int arena;            // index of the key arena
+} dir_sort_key_t;
+
+/* part of parallel making of keys */
+typedef struct
+{
+    const file_entry_t *entries;  // entries to make keys of
+    dir_sort_key_t *keys;         // keys[i] is made for entries[i]
+    int first;                    // index of entries[0] in the list
+    int start;
+    int end;
+    int arena;  // index of the key arena of this part
+} dir_sort_keys_task_t;
+
+/* part of parallel sort */
+typedef struct
+{
+    dir_sort_key_t *src;
+    dir_sort_key_t *dst;  // NULL: sort [start, end) of src, otherwise merge it to dst
+    int start;
+    int mid;
+    int end;
+} dir_sort_task_t;
+
+#ifdef HAVE_FSTATAT
+/* shared state of the batched stat of directory entries */
+typedef struct
+{
+    int dirfd;              // descriptor of directory which entries are stat'ed
+    file_entry_t *entries;  // entries to stat
+    int count;              // number of entries
+    int done;               // number of finished batches
+    GMutex lock;
+    GCond cond;
+} dir_stat_job_t;
+#endif
+
 /*** forward declarations (file scope functions) *************************************************/
 
 /*** file scope variables ************************************************************************/
@@ -75,6 +166,25 @@ static gboolean exec_first = TRUE;
 
 static dir_list dir_copy = { NULL, 0, 0, NULL };
 
+/* keys used by dir_sort_key_cmp() */
+static dir_sort_by_t sort_by = DIR_SORT_BY_NAME;
+static GString *sort_arenas[DIR_SORT_MAX_THREADS + 1];
+static gboolean sort_keys_binary = FALSE;
+/* name keys are made for all entries or for entries with equal primary keys */
+static gboolean sort_names = FALSE;
+
+/* state of directory reading */
+static struct
+{
+    GCompareFunc sort;
+    const dir_sort_options_t *sort_op;
+    GHashTable *marked_files;  // names of files those marks are restored in reloaded list
+    int marked_cnt;            // number of marks that aren't restored yet
+    int first;                 // index of the first read entry
+    int sorted;                // end of the sorted part of list
+    gint64 timestamp;          // time of last partial list notification
+} dir_load;
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -103,135 +213,1068 @@ key_collate (const char *t1, const char *t2)
         ret = 0;  // it must not happen
     }
 
-    return ret;
+    return ret;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static inline int
+compare_by_names (file_entry_t *a, file_entry_t *b)
+{
+    // create key if does not exist, key will be freed after sorting
+    if (a->name_sort_key == NULL)
+        a->name_sort_key = str_create_key_for_filename (a->fname->str, case_sensitive);
+    if (b->name_sort_key == NULL)
+        b->name_sort_key = str_create_key_for_filename (b->fname->str, case_sensitive);
+
+    return key_collate (a->name_sort_key, b->name_sort_key);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+file_entry_clean_sort_keys (file_entry_t *fentry)
+{
+    str_release_key (fentry->name_sort_key, case_sensitive);
+    fentry->name_sort_key = NULL;
+    str_release_key (fentry->extension_sort_key, case_sensitive);
+    fentry->extension_sort_key = NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * clear keys, should be call after sorting is finished.
+ */
+
+static void
+clean_sort_keys (dir_list *list, int start, int count)
+{
+    int i;
+
+    for (i = 0; i < count; i++)
+        file_entry_clean_sort_keys (&list->list[i + start]);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+name_is_visible (const char *name, size_t len)
+{
+    if (DIR_IS_DOT (name) || DIR_IS_DOTDOT (name))
+        return FALSE;
+    if (!panels_options.show_dot_files && (name[0] == '.'))
+        return FALSE;
+    if (!panels_options.show_backups && name[len - 1] == '~')
+        return FALSE;
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+dirent_is_visible (const struct vfs_dirent *dp)
+{
+    return name_is_visible (dp->d_name, dp->d_len);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+dirent_match_filter (const char *name, size_t len, const struct stat *st, gboolean link_to_dir,
+                     const file_filter_t *filter)
+{
+    gboolean files_only;
+
+    if (filter == NULL || filter->handler == NULL)
+        return TRUE;
+
+    files_only = (filter->flags & SELECT_FILES_ONLY) != 0;
+
+    return ((S_ISDIR (st->st_mode) || link_to_dir) && files_only)
+        || mc_search_run (filter->handler, name, 0, len, NULL);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get first bytes of key as a number. If keys are compared bytewise, different prefixes
+ * of two keys give the result of comparison without looking at the keys themselves.
+ */
+
+static guint64
+dir_sort_key_prefix (const char *key)
+{
+    guint64 prefix = 0;
+    int i;
+
+    for (i = 0; i < (int) sizeof (prefix); i++)
+    {
+        prefix <<= 8;
+        if (*key != '\0')
+            prefix |= (guchar) *key++;
+    }
+
+    return prefix;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static inline int
+dir_sort_prefix_cmp (guint64 a, guint64 b)
+{
+    return (a < b ? -1 : 1) * reverse;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+static inline const char *
+dir_sort_key_str (const dir_sort_key_t *k, gsize key)
+{
+    return sort_arenas[k->arena]->str + key;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Compare precomputed keys by primary sort key only: group and key of sort order.
+ * Names aren't compared.
+ */
+
+static int
+dir_sort_key_cmp_primary (const dir_sort_key_t *a, const dir_sort_key_t *b)
+{
+    int r;
+
+    if (a->group != b->group && !panels_options.mix_all_files)
+        return b->group - a->group;
+
+    switch (sort_by)
+    {
+    case DIR_SORT_BY_VERSION:
+        return filevercmp (a->name, b->name) * reverse;
+
+    case DIR_SORT_BY_EXT:
+        if (sort_keys_binary && a->ext_prefix != b->ext_prefix)
+            return dir_sort_prefix_cmp (a->ext_prefix, b->ext_prefix);
+        r = str_key_collate (dir_sort_key_str (a, a->ext_key), dir_sort_key_str (b, b->ext_key),
+                             case_sensitive);
+        return r * reverse;
+
+    case DIR_SORT_BY_INODE:
+    case DIR_SORT_BY_MTIME:
+    case DIR_SORT_BY_ATIME:
+    case DIR_SORT_BY_CTIME:
+    case DIR_SORT_BY_SIZE:
+        return _GL_CMP (a->num, b->num) * reverse;
+
+    default:
+        return 0;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Compare precomputed keys in the same way as sort_*() functions compare entries.
+ * Can be called from worker threads: keys are not changed while sorting.
+ *
+ * If name keys aren't made yet, entries with equal primary keys are kept in order of list.
+ */
+
+static int
+dir_sort_key_cmp (const void *p1, const void *p2)
+{
+    const dir_sort_key_t *a = (const dir_sort_key_t *) p1;
+    const dir_sort_key_t *b = (const dir_sort_key_t *) p2;
+    const char *ka, *kb;
+    int r;
+
+    r = dir_sort_key_cmp_primary (a, b);
+    // sort_inode() doesn't compare names
+    if (r != 0 || sort_by == DIR_SORT_BY_INODE)
+        return r;
+
+    if (!sort_names)
+        return a->index - b->index;
+
+    ka = dir_sort_key_str (a, a->name_key);
+    kb = dir_sort_key_str (b, b->name_key);
+
+    // dot files are first regardless of order, see key_collate()
+    if ((ka[0] == '.') == (kb[0] == '.') && sort_keys_binary && a->name_prefix != b->name_prefix)
+        return dir_sort_prefix_cmp (a->name_prefix, b->name_prefix);
+
+    return key_collate (ka, kb);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+dir_sort_get_sort_by (GCompareFunc sort, dir_sort_by_t *by)
+{
+    if (sort == (GCompareFunc) sort_name)
+        *by = DIR_SORT_BY_NAME;
+    else if (sort == (GCompareFunc) sort_vers)
+        *by = DIR_SORT_BY_VERSION;
+    else if (sort == (GCompareFunc) sort_ext)
+        *by = DIR_SORT_BY_EXT;
+    else if (sort == (GCompareFunc) sort_time)
+        *by = DIR_SORT_BY_MTIME;
+    else if (sort == (GCompareFunc) sort_atime)
+        *by = DIR_SORT_BY_ATIME;
+    else if (sort == (GCompareFunc) sort_ctime)
+        *by = DIR_SORT_BY_CTIME;
+    else if (sort == (GCompareFunc) sort_size)
+        *by = DIR_SORT_BY_SIZE;
+    else if (sort == (GCompareFunc) sort_inode)
+        *by = DIR_SORT_BY_INODE;
+    else
+        return FALSE;
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Append the key to the arena.
+ *
+ * @return offset of key in the arena
+ */
+
+static gsize
+dir_sort_arena_add (GString *arena, char *key, guint64 *prefix)
+{
+    const gsize offset = arena->len;
+
+    // keep '\0' to use the key as a string
+    g_string_append_len (arena, key, strlen (key) + 1);
+    *prefix = dir_sort_key_prefix (key);
+    str_release_key (key, case_sensitive);
+
+    return offset;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Make name key of entry.
+ */
+
+static void
+dir_sort_make_name_key (dir_sort_key_t *k, int arena)
+{
+    k->arena = arena;
+    k->name_key = dir_sort_arena_add (sort_arenas[arena],
+                                      str_create_key_for_filename (k->name, case_sensitive),
+                                      &k->name_prefix);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Make sort keys of part of entries. Keys of each part are placed in own arena
+ * instead of allocating them one by one for each entry.
+ */
+
+static void
+dir_sort_make_keys_run (gpointer data, gpointer user_data)
+{
+    const dir_sort_keys_task_t *t = (const dir_sort_keys_task_t *) data;
+    int i;
+
+    (void) user_data;
+
+    for (i = t->start; i < t->end; i++)
+    {
+        const file_entry_t *x = &t->entries[i];
+        dir_sort_key_t *k = &t->keys[i];
+
+        k->index = t->first + i;
+        k->group = MY_ISDIR (x);
+        k->name = x->fname->str;
+        k->arena = t->arena;
+        k->name_key = 0;
+        k->name_prefix = 0;
+        k->ext_key = 0;
+        k->ext_prefix = 0;
+        k->num = 0;
+
+        if (sort_names)
+            dir_sort_make_name_key (k, t->arena);
+
+        switch (sort_by)
+        {
+        case DIR_SORT_BY_EXT:
+            k->ext_key =
+                dir_sort_arena_add (sort_arenas[t->arena],
+                                    str_create_key (extension (x->fname->str), case_sensitive),
+                                    &k->ext_prefix);
+            break;
+        case DIR_SORT_BY_MTIME:
+            k->num = (gint64) x->st.st_mtime;
+            break;
+        case DIR_SORT_BY_ATIME:
+            k->num = (gint64) x->st.st_atime;
+            break;
+        case DIR_SORT_BY_CTIME:
+            k->num = (gint64) x->st.st_ctime;
+            break;
+        case DIR_SORT_BY_SIZE:
+            k->num = (gint64) x->st.st_size;
+            break;
+        case DIR_SORT_BY_INODE:
+            k->num = (gint64) x->st.st_ino;
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Make sort keys of entries. Making of collation keys takes most of sorting time,
+ * so long lists are split into parts those keys are made in parallel.
+ */
+
+static dir_sort_key_t *
+dir_sort_make_keys (const dir_list *list, int start, int count)
+{
+    dir_sort_keys_task_t tasks[DIR_SORT_MAX_THREADS];
+    dir_sort_key_t *keys;
+    int parts, i;
+
+    keys = g_new (dir_sort_key_t, count);
+    parts = count < DIR_SORT_PARALLEL_MIN ? 1 : DIR_SORT_MAX_THREADS;
+
+    for (i = 0; i < parts; i++)
+    {
+        tasks[i].entries = &list->list[start];
+        tasks[i].keys = keys;
+        tasks[i].first = start;
+        tasks[i].start = (int) ((gint64) count * i / parts);
+        tasks[i].end = (int) ((gint64) count * (i + 1) / parts);
+        tasks[i].arena = i;
+        // 32 bytes per key is enough for most of file names
+        sort_arenas[i] =
+            g_string_sized_new (sort_names ? (gsize) (tasks[i].end - tasks[i].start) * 32 : 0);
+    }
+
+    if (parts == 1)
+        dir_sort_make_keys_run (&tasks[0], NULL);
+    else
+    {
+        GThreadPool *pool;
+
+        pool = g_thread_pool_new (dir_sort_make_keys_run, NULL, parts, FALSE, NULL);
+        for (i = 0; i < parts; i++)
+            g_thread_pool_push (pool, &tasks[i], NULL);
+        // wait for all tasks
+        g_thread_pool_free (pool, FALSE, TRUE);
+    }
+
+    return keys;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Sort runs of keys with equal primary keys by names. Name keys are made for entries
+ * of such runs only: unlike names, sizes and times are mostly unique.
+ */
+
+static void
+dir_sort_keys_ties (dir_sort_key_t *keys, int count)
+{
+    int i, j;
+
+    sort_arenas[DIR_SORT_TIES_ARENA] = g_string_new (NULL);
+    sort_names = TRUE;
+
+    for (i = 0; i < count; i = j)
+    {
+        for (j = i + 1; j < count && dir_sort_key_cmp_primary (&keys[i], &keys[j]) == 0; j++)
+            ;
+
+        if (j - i > 1)
+        {
+            int k;
+
+            for (k = i; k < j; k++)
+                dir_sort_make_name_key (&keys[k], DIR_SORT_TIES_ARENA);
+            qsort (&keys[i], j - i, sizeof (dir_sort_key_t), dir_sort_key_cmp);
+        }
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+dir_sort_keys_merge (const dir_sort_task_t *t)
+{
+    int i = t->start, j = t->mid, k = t->start;
+
+    while (i < t->mid && j < t->end)
+        if (dir_sort_key_cmp (&t->src[j], &t->src[i]) < 0)
+            t->dst[k++] = t->src[j++];
+        else
+            t->dst[k++] = t->src[i++];
+
+    if (i < t->mid)
+        memcpy (&t->dst[k], &t->src[i], (t->mid - i) * sizeof (dir_sort_key_t));
+    else if (j < t->end)
+        memcpy (&t->dst[k], &t->src[j], (t->end - j) * sizeof (dir_sort_key_t));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Worker thread function: sort or merge part of keys */
+
+static void
+dir_sort_task_run (gpointer data, gpointer user_data)
+{
+    const dir_sort_task_t *t = (const dir_sort_task_t *) data;
+
+    (void) user_data;
+
+    if (t->dst == NULL)
+        qsort (&t->src[t->start], t->end - t->start, sizeof (dir_sort_key_t), dir_sort_key_cmp);
+    else
+        dir_sort_keys_merge (t);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Sort keys. Long arrays are split into runs which are sorted in parallel
+ * and then merged pairwise, merges of one pass are parallel too.
+ */
+
+static void
+dir_sort_keys (dir_sort_key_t *keys, int count)
+{
+    dir_sort_task_t tasks[DIR_SORT_MAX_THREADS];
+    int bounds[DIR_SORT_MAX_THREADS + 1];
+    dir_sort_key_t *src, *dst, *tmp;
+    GThreadPool *pool;
+    int width, i;
+
+    if (count < DIR_SORT_PARALLEL_MIN)
+    {
+        qsort (keys, count, sizeof (dir_sort_key_t), dir_sort_key_cmp);
+        return;
+    }
+
+    for (i = 0; i <= DIR_SORT_MAX_THREADS; i++)
+        bounds[i] = (int) ((gint64) count * i / DIR_SORT_MAX_THREADS);
+
+    pool = g_thread_pool_new (dir_sort_task_run, NULL, DIR_SORT_MAX_THREADS, FALSE, NULL);
+    for (i = 0; i < DIR_SORT_MAX_THREADS; i++)
+    {
+        tasks[i].src = keys;
+        tasks[i].dst = NULL;
+        tasks[i].start = bounds[i];
+        tasks[i].mid = bounds[i + 1];
+        tasks[i].end = bounds[i + 1];
+        g_thread_pool_push (pool, &tasks[i], NULL);
+    }
+    // wait for all tasks
+    g_thread_pool_free (pool, FALSE, TRUE);
+
+    tmp = g_new (dir_sort_key_t, count);
+    src = keys;
+    dst = tmp;
+
+    for (width = 1; width < DIR_SORT_MAX_THREADS; width *= 2)
+    {
+        dir_sort_key_t *swap;
+        int t = 0;
+
+        pool = g_thread_pool_new (dir_sort_task_run, NULL, DIR_SORT_MAX_THREADS, FALSE, NULL);
+        for (i = 0; i < DIR_SORT_MAX_THREADS; i += 2 * width, t++)
+        {
+            tasks[t].src = src;
+            tasks[t].dst = dst;
+            tasks[t].start = bounds[i];
+            tasks[t].mid = bounds[MIN (i + width, DIR_SORT_MAX_THREADS)];
+            tasks[t].end = bounds[MIN (i + 2 * width, DIR_SORT_MAX_THREADS)];
+            g_thread_pool_push (pool, &tasks[t], NULL);
+        }
+        g_thread_pool_free (pool, FALSE, TRUE);
+
+        swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    if (src != keys)
+        memcpy (keys, src, count * sizeof (dir_sort_key_t));
+
+    g_free (tmp);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Sort part of list using precomputed keys: keys of all entries are made once
+ * instead of checking and making them in each comparison, and small key records are
+ * moved while sorting instead of large entries.
+ *
+ * @param list list
+ * @param start index of the first entry to sort
+ * @param sorted number of entries from @start those are in order already
+ * @param count number of entries to sort
+ * @param sort sort function
+ *
+ * @return FALSE if @sort is not supported, TRUE otherwise
+ */
+
+static gboolean
+dir_list_sort_by_keys (dir_list *list, int start, int sorted, int count, GCompareFunc sort)
+{
+    dir_sort_key_t *keys;
+    file_entry_t *entries;
+    int i;
+
+    if (!dir_sort_get_sort_by (sort, &sort_by))
+        return FALSE;
+
+    if (count < 2 || sorted == count)
+        return TRUE;
+
+    // names are compared for most of entries in these orders only
+    sort_names = sort_by == DIR_SORT_BY_NAME || sort_by == DIR_SORT_BY_EXT;
+    sort_keys_binary = str_key_is_binary (case_sensitive);
+    keys = dir_sort_make_keys (list, start, count);
+
+    dir_sort_keys (&keys[sorted], count - sorted);
+
+    if (sorted > 0)
+    {
+        const dir_sort_task_t t = { keys, g_new (dir_sort_key_t, count), 0, sorted, count };
+
+        dir_sort_keys_merge (&t);
+        g_free (keys);
+        keys = t.dst;
+    }
+
+    if (!sort_names && sort_by != DIR_SORT_BY_INODE)
+        dir_sort_keys_ties (keys, count);
+
+    entries = g_new (file_entry_t, count);
+    for (i = 0; i < count; i++)
+        entries[i] = list->list[keys[i].index];
+    memcpy (&list->list[start], entries, count * sizeof (file_entry_t));
+
+    g_free (entries);
+    g_free (keys);
+
+    for (i = 0; i < (int) G_N_ELEMENTS (sort_arenas); i++)
+        if (sort_arenas[i] != NULL)
+        {
+            g_string_free (sort_arenas[i], TRUE);
+            sort_arenas[i] = NULL;
+        }
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * If you change handle_dirent then check also handle_path.
+ * @return FALSE = don't add, TRUE = add to the list
+ */
+
+static gboolean
+handle_dirent (struct vfs_dirent *dp, const file_filter_t *filter, struct stat *buf1,
+               gboolean *link_to_dir, gboolean *stale_link)
+{
+    vfs_path_t *vpath;
+
+    if (!dirent_is_visible (dp))
+        return FALSE;
+
+    vpath = vfs_path_from_str (dp->d_name);
+    if (mc_lstat (vpath, buf1) == -1)
+    {
+        /*
+         * lstat() fails - such entries should be identified by
+         * buf1->st_mode being 0.
+         * It happens on QNX Neutrino for /fs/cd0 if no CD is inserted.
+         */
+        memset (buf1, 0, sizeof (*buf1));
+    }
+
+    if (S_ISDIR (buf1->st_mode))
+        tree_store_mark_checked (dp->d_name);
+
+    // A link to a file or a directory?
+    *link_to_dir = file_is_symlink_to_dir (vpath, buf1, stale_link);
+
+    vfs_path_free (vpath, TRUE);
+
+    return dirent_match_filter (dp->d_name, dp->d_len, buf1, *link_to_dir, filter);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** get info about ".." */
+
+static gboolean
+dir_get_dotdot_stat (const vfs_path_t *vpath, struct stat *st)
+{
+    gboolean ret = FALSE;
+
+    if ((vpath != NULL) && (st != NULL))
+    {
+        const char *path;
+
+        path = vfs_path_get_by_index (vpath, 0)->path;
+        if (path != NULL && *path != '\0')
+        {
+            vfs_path_t *tmp_vpath;
+
+            tmp_vpath = vfs_path_append_new (vpath, "..", (char *) NULL);
+            ret = mc_stat (tmp_vpath, st) == 0;
+            vfs_path_free (tmp_vpath, TRUE);
+        }
+    }
+
+    return ret;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+alloc_dir_copy (int size)
+{
+    if (dir_copy.size < size)
+    {
+        if (dir_copy.list != NULL)
+            dir_list_free_list (&dir_copy);
+
+        dir_copy.list = g_new0 (file_entry_t, size);
+        dir_copy.size = size;
+        dir_copy.len = 0;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+dir_list_set_sort_options (const dir_sort_options_t *sort_op)
+{
+    reverse = sort_op->reverse ? -1 : 1;
+    case_sensitive = sort_op->case_sensitive ? 1 : 0;
+    exec_first = sort_op->exec_first;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Compare entry of list with @fentry.  Sort keys of @fentry are kept to be used in next
+ * comparisons, ones of entry of list are freed.
+ */
+
+static int
+dir_list_compare_at (const dir_list *list, int idx, file_entry_t *fentry, GCompareFunc sort)
+{
+    file_entry_t *e = &list->list[idx];
+    int r;
+
+    r = sort (e, fentry);
+    file_entry_clean_sort_keys (e);
+
+    return r;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Find the first entry of sorted list which is not less than @fentry using binary search.
+ * Sort options must be set already.  Sort keys of @fentry are to be freed by caller.
+ */
+
+static int
+dir_list_lower_bound (const dir_list *list, file_entry_t *fentry, GCompareFunc sort)
+{
+    int lo, hi;
+
+    // ".." is always the first
+    lo = list->len > 0 && DIR_IS_DOTDOT (list->list[0].fname->str) ? 1 : 0;
+    hi = list->len;
+
+    while (lo < hi)
+    {
+        const int mid = lo + (hi - lo) / 2;
+
+        if (dir_list_compare_at (list, mid, fentry, sort) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Merge two adjacent sorted parts of list: [start, mid) and [mid, end).
+ */
+
+static void
+dir_list_merge (dir_list *list, int start, int mid, int end, GCompareFunc sort)
+{
+    file_entry_t *left;
+    int left_len, i, j, k;
+
+    if (start == mid || mid == end)
+        return;
+
+    // parts are in order already
+    if (sort (&list->list[mid - 1], &list->list[mid]) <= 0)
+        return;
+
+    left_len = mid - start;
+    left = g_new (file_entry_t, left_len);
+    memcpy (left, &list->list[start], left_len * sizeof (file_entry_t));
+
+    for (i = 0, j = mid, k = start; i < left_len && j < end; k++)
+        if (sort (&left[i], &list->list[j]) <= 0)
+            list->list[k] = left[i++];
+        else
+            list->list[k] = list->list[j++];
+
+    // the rest of right part is in place already
+    if (i < left_len)
+        memcpy (&list->list[k], &left[i], (left_len - i) * sizeof (file_entry_t));
+
+    g_free (left);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Sort entries read since last call and merge them with already sorted ones.
+ * Marks of reloaded list are restored here too.
+ */
+
+static void
+dir_list_sort_read (dir_list *list)
+{
+    int i;
+
+    /*
+     * If we have marked files in the copy, scan through the copy
+     * to find matching file.  Decrease number of remaining marks if
+     * we copied one.
+     */
+    for (i = dir_load.sorted; dir_load.marked_cnt > 0 && i < list->len; i++)
+    {
+        file_entry_t *fentry;
+
+        fentry = &list->list[i];
+        if (g_hash_table_lookup (dir_load.marked_files, fentry->fname->str) != NULL)
+        {
+            fentry->f.marked = 1;
+            dir_load.marked_cnt--;
+        }
+    }
+
+    if (dir_load.sort != (GCompareFunc) unsorted)
+    {
+        dir_list_set_sort_options (dir_load.sort_op);
+        if (!dir_list_sort_by_keys (list, dir_load.first, dir_load.sorted - dir_load.first,
+                                    list->len - dir_load.first, dir_load.sort))
+        {
+            qsort (&list->list[dir_load.sorted], list->len - dir_load.sorted, sizeof (file_entry_t),
+                   dir_load.sort);
+            dir_list_merge (list, dir_load.first, dir_load.sorted, list->len, dir_load.sort);
+            clean_sort_keys (list, dir_load.first, list->len - dir_load.first);
+        }
+    }
+
+    dir_load.sorted = list->len;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Show partially read directory if it is read too long.
+ * Read entries are sorted by runs of growing length, so the total cost of merges is
+ * O(n log n) and the final sort doesn't start from scratch.
+ */
+
+static void
+dir_list_partial (dir_list *list)
+{
+    if (list->callback == NULL || list->len == dir_load.sorted
+        || list->len - dir_load.sorted < dir_load.sorted - dir_load.first
+        || !mc_time_elapsed (&dir_load.timestamp, DIR_LIST_PARTIAL_DELAY))
+        return;
+
+    dir_list_sort_read (list);
+    list->callback (DIR_PARTIAL, list);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+dir_list_read_start (dir_list *list, GCompareFunc sort, const dir_sort_options_t *sort_op,
+                     GHashTable *marked_files, int marked_cnt)
+{
+    dir_load.sort = sort;
+    dir_load.sort_op = sort_op;
+    dir_load.marked_files = marked_files;
+    dir_load.marked_cnt = marked_cnt;
+    dir_load.first = list->len;
+    dir_load.sorted = list->len;
+    dir_load.timestamp = g_get_monotonic_time ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+dir_list_read_finish (dir_list *list)
+{
+    dir_list_sort_read (list);
+
+    dir_load.marked_files = NULL;
+    dir_load.marked_cnt = 0;
 }
 
+#ifdef HAVE_FSTATAT
 /* --------------------------------------------------------------------------------------------- */
+/**
+ * Open local directory to stat its entries relative to the directory descriptor.
+ *
+ * @return directory descriptor or -1 if directory is not local or cannot be opened
+ */
 
-static inline int
-compare_by_names (file_entry_t *a, file_entry_t *b)
+static int
+dir_open_local (const vfs_path_t *vpath)
 {
-    // create key if does not exist, key will be freed after sorting
-    if (a->name_sort_key == NULL)
-        a->name_sort_key = str_create_key_for_filename (a->fname->str, case_sensitive);
-    if (b->name_sort_key == NULL)
-        b->name_sort_key = str_create_key_for_filename (b->fname->str, case_sensitive);
+    const vfs_path_element_t *element;
 
-    return key_collate (a->name_sort_key, b->name_sort_key);
+    if (vfs_path_elements_count (vpath) != 1 || !vfs_file_is_local (vpath))
+        return -1;
+
+    element = vfs_path_get_by_index (vpath, 0);
+    // names of recoded directory can't be used with fstatat() as is
+    if (element->encoding != NULL || !IS_PATH_SEP (element->path[0]))
+        return -1;
+
+    return open (element->path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
 }
 
 /* --------------------------------------------------------------------------------------------- */
 /**
- * clear keys, should be call after sorting is finished.
+ * Stat a directory entry. If you change dir_stat_entry then check also handle_dirent.
+ * Can be called from a worker thread: nothing but @fentry is touched here.
  */
 
 static void
-clean_sort_keys (dir_list *list, int start, int count)
+dir_stat_entry (int dfd, file_entry_t *fentry)
 {
-    int i;
+    if (fstatat (dfd, fentry->fname->str, &fentry->st, AT_SYMLINK_NOFOLLOW) != 0)
+    {
+        // see handle_dirent()
+        memset (&fentry->st, 0, sizeof (fentry->st));
+        return;
+    }
 
-    for (i = 0; i < count; i++)
+    if (S_ISLNK (fentry->st.st_mode))
     {
-        file_entry_t *fentry;
+        struct stat st;
 
-        fentry = &list->list[i + start];
-        str_release_key (fentry->name_sort_key, case_sensitive);
-        fentry->name_sort_key = NULL;
-        str_release_key (fentry->extension_sort_key, case_sensitive);
-        fentry->extension_sort_key = NULL;
+        if (fstatat (dfd, fentry->fname->str, &st, 0) == 0)
+            fentry->f.link_to_dir = S_ISDIR (st.st_mode) ? 1 : 0;
+        else
+            fentry->f.stale_link = 1;
     }
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/** Worker thread function: stat one batch of entries */
+
+static void
+dir_stat_batch (gpointer data, gpointer user_data)
+{
+    dir_stat_job_t *job = (dir_stat_job_t *) user_data;
+    const int start = (GPOINTER_TO_INT (data) - 1) * DIR_STAT_BATCH_SIZE;
+    const int end = MIN (start + DIR_STAT_BATCH_SIZE, job->count);
+    int i;
+
+    for (i = start; i < end; i++)
+        dir_stat_entry (job->dirfd, &job->entries[i]);
+
+    g_mutex_lock (&job->lock);
+    job->done++;
+    g_cond_signal (&job->cond);
+    g_mutex_unlock (&job->lock);
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /**
- * If you change handle_dirent then check also handle_path.
- * @return FALSE = don't add, TRUE = add to the list
+ * Stat entries of directory list. One batch is handled in the current thread.
+ * Several batches are stat'ed by the thread pool at the same time: on network file systems
+ * this hides the latency of the round trip per file.
+ *
+ * @param job shared state of workers
+ * @param pool thread pool, NULL to stat all entries in the current thread
+ * @param entries entries to stat
+ * @param count number of entries to stat
+ * @param callback directory list callback
  */
 
-static gboolean
-handle_dirent (struct vfs_dirent *dp, const file_filter_t *filter, struct stat *buf1,
-               gboolean *link_to_dir, gboolean *stale_link)
+static void
+dir_stat_entries (dir_stat_job_t *job, GThreadPool *pool, file_entry_t *entries, int count,
+                  dir_list_cb_fn callback)
 {
-    vfs_path_t *vpath;
-    gboolean ok = TRUE;
+    int batches, i;
 
-    if (DIR_IS_DOT (dp->d_name) || DIR_IS_DOTDOT (dp->d_name))
-        return FALSE;
-    if (!panels_options.show_dot_files && (dp->d_name[0] == '.'))
-        return FALSE;
-    if (!panels_options.show_backups && dp->d_name[dp->d_len - 1] == '~')
-        return FALSE;
+    batches = (count + DIR_STAT_BATCH_SIZE - 1) / DIR_STAT_BATCH_SIZE;
 
-    vpath = vfs_path_from_str (dp->d_name);
-    if (mc_lstat (vpath, buf1) == -1)
+    if (pool == NULL || batches <= 1)
     {
-        /*
-         * lstat() fails - such entries should be identified by
-         * buf1->st_mode being 0.
-         * It happens on QNX Neutrino for /fs/cd0 if no CD is inserted.
-         */
-        memset (buf1, 0, sizeof (*buf1));
+        for (i = 0; i < count; i++)
+            dir_stat_entry (job->dirfd, &entries[i]);
+        return;
     }
 
-    if (S_ISDIR (buf1->st_mode))
-        tree_store_mark_checked (dp->d_name);
+    job->entries = entries;
+    job->count = count;
+    job->done = 0;
 
-    // A link to a file or a directory?
-    *link_to_dir = file_is_symlink_to_dir (vpath, buf1, stale_link);
+    // 0 is NULL, so batches are counted from 1
+    for (i = 1; i <= batches; i++)
+        g_thread_pool_push (pool, GINT_TO_POINTER (i), NULL);
 
-    vfs_path_free (vpath, TRUE);
+    g_mutex_lock (&job->lock);
+    while (job->done < batches)
+        if (!g_cond_wait_until (&job->cond, &job->lock,
+                                g_get_monotonic_time () + DIR_STAT_WAIT_TIMEOUT)
+            && callback != NULL)
+        {
+            // show that we are alive
+            g_mutex_unlock (&job->lock);
+            callback (DIR_READ, NULL);
+            g_mutex_lock (&job->lock);
+        }
+    g_mutex_unlock (&job->lock);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Read local directory. Names are collected first, then entries are stat'ed relative to
+ * the directory descriptor, avoiding building and resolving the full path for each entry.
+ * Entries are stat'ed by rounds of growing size, after each round the stat'ed entries
+ * are available to show.
+ *
+ * @return FALSE if list cannot be grown, TRUE otherwise
+ */
+
+static gboolean
+dir_list_read_local (dir_list *list, DIR *dirp, int dfd, const file_filter_t *filter)
+{
+    static const struct stat st0;  // entries are stat'ed later
+    struct vfs_dirent *dp;
+    dir_stat_job_t job;
+    GThreadPool *pool = NULL;
+    int total, round, i, j;
+    gboolean ret = TRUE;
 
-    if (filter != NULL && filter->handler != NULL)
+    while (ret && (dp = mc_readdir (dirp)) != NULL)
     {
-        gboolean files_only = (filter->flags & SELECT_FILES_ONLY) != 0;
+        if (list->callback != NULL)
+            list->callback (DIR_READ, dp);
 
-        ok = ((S_ISDIR (buf1->st_mode) || *link_to_dir) && files_only)
-            || mc_search_run (filter->handler, dp->d_name, 0, dp->d_len, NULL);
+        if (dirent_is_visible (dp))
+            ret = dir_list_append (list, dp->d_name, &st0, FALSE, FALSE);
     }
 
-    return ok;
-}
+    total = list->len;
+    i = j = list->len = dir_load.first;
 
-/* --------------------------------------------------------------------------------------------- */
-/** get info about ".." */
+    job.dirfd = dfd;
 
-static gboolean
-dir_get_dotdot_stat (const vfs_path_t *vpath, struct stat *st)
-{
-    gboolean ret = FALSE;
+    if (total - i > DIR_STAT_BATCH_SIZE)
+    {
+        g_mutex_init (&job.lock);
+        g_cond_init (&job.cond);
+        pool = g_thread_pool_new (dir_stat_batch, &job, DIR_STAT_MAX_THREADS, FALSE, NULL);
+    }
 
-    if ((vpath != NULL) && (st != NULL))
+    // first round is small to show first entries as soon as possible
+    for (round = DIR_STAT_BATCH_SIZE; i < total; round *= 2)
     {
-        const char *path;
+        const int end = MIN (i + round, total);
 
-        path = vfs_path_get_by_index (vpath, 0)->path;
-        if (path != NULL && *path != '\0')
-        {
-            vfs_path_t *tmp_vpath;
+        dir_stat_entries (&job, pool, &list->list[i], end - i, list->callback);
 
-            tmp_vpath = vfs_path_append_new (vpath, "..", (char *) NULL);
-            ret = mc_stat (tmp_vpath, st) == 0;
-            vfs_path_free (tmp_vpath, TRUE);
+        for (; i < end; i++)
+        {
+            file_entry_t *fentry = &list->list[i];
+
+            if (S_ISDIR (fentry->st.st_mode))
+                tree_store_mark_checked (fentry->fname->str);
+
+            if (!dirent_match_filter (fentry->fname->str, fentry->fname->len, &fentry->st,
+                                      link_isdir (fentry), filter))
+                g_string_free (fentry->fname, TRUE);
+            else
+            {
+                if (j != i)
+                    list->list[j] = *fentry;
+                j++;
+            }
         }
+
+        // entries [j, total) aren't ready yet
+        list->len = j;
+        dir_list_partial (list);
+    }
+
+    if (pool != NULL)
+    {
+        g_thread_pool_free (pool, FALSE, TRUE);
+        g_cond_clear (&job.cond);
+        g_mutex_clear (&job.lock);
     }
 
     return ret;
 }
+#endif
 
 /* --------------------------------------------------------------------------------------------- */
+/**
+ * Read directory entries and append them to the list.
+ *
+ * @return FALSE if list cannot be grown, TRUE otherwise
+ */
 
-static void
-alloc_dir_copy (int size)
+static gboolean
+dir_list_read (dir_list *list, const vfs_path_t *vpath, DIR *dirp, const file_filter_t *filter)
 {
-    if (dir_copy.size < size)
+    struct vfs_dirent *dp;
+    gboolean ret = TRUE;
+
+#ifdef HAVE_FSTATAT
+    int dfd;
+
+    dfd = dir_open_local (vpath);
+    if (dfd != -1)
     {
-        if (dir_copy.list != NULL)
-            dir_list_free_list (&dir_copy);
+        ret = dir_list_read_local (list, dirp, dfd, filter);
+        close (dfd);
+        return ret;
+    }
+#else
+    (void) vpath;
+#endif
 
-        dir_copy.list = g_new0 (file_entry_t, size);
-        dir_copy.size = size;
-        dir_copy.len = 0;
+    while (ret && (dp = mc_readdir (dirp)) != NULL)
+    {
+        struct stat st;
+        gboolean link_to_dir, stale_link;
+
+        if (list->callback != NULL)
+            list->callback (DIR_READ, dp);
+
+        if (handle_dirent (dp, filter, &st, &link_to_dir, &stale_link))
+        {
+            ret = dir_list_append (list, dp->d_name, &st, link_to_dir, stale_link);
+            dir_list_partial (list);
+        }
     }
+
+    return ret;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -320,6 +1363,130 @@ dir_list_append (dir_list *list, const char *fname, const struct stat *st, gbool
     return TRUE;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Insert entry to the sorted directory list keeping the sort order. Entry is appended to
+ * the unsorted list.
+ *
+ * @param list directory list
+ * @param fentry entry to insert, the list takes ownership of the file name
+ * @param sort sort function
+ * @param sort_op sort options
+ *
+ * @return index of inserted entry, -1 if list cannot be grown
+ */
+
+int
+dir_list_insert (dir_list *list, const file_entry_t *fentry, GCompareFunc sort,
+                 const dir_sort_options_t *sort_op)
+{
+    int i;
+
+    if (list->len == list->size && !dir_list_grow (list, DIR_LIST_RESIZE_STEP))
+        return (-1);
+
+    if (sort == (GCompareFunc) unsorted)
+        i = list->len;
+    else
+    {
+        file_entry_t key = *fentry;
+
+        dir_list_set_sort_options (sort_op);
+        i = dir_list_lower_bound (list, &key, sort);
+        file_entry_clean_sort_keys (&key);
+    }
+
+    memmove (&list->list[i + 1], &list->list[i], (list->len - i) * sizeof (file_entry_t));
+    list->list[i] = *fentry;
+    list->len++;
+
+    return i;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Remove entry from the directory list.
+ *
+ * @param list directory list
+ * @param idx index of entry
+ */
+
+void
+dir_list_remove (dir_list *list, int idx)
+{
+    g_string_free (list->list[idx].fname, TRUE);
+    list->len--;
+    memmove (&list->list[idx], &list->list[idx + 1], (list->len - idx) * sizeof (file_entry_t));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Find entry in the sorted directory list using binary search.
+ *
+ * @param list directory list
+ * @param fentry entry to find: name and fields used by @sort must be the same as ones of
+ *               the entry in the list
+ * @param sort sort function
+ * @param sort_op sort options
+ *
+ * @return index of entry, -1 if there is no such entry
+ */
+
+int
+dir_list_find (const dir_list *list, const file_entry_t *fentry, GCompareFunc sort,
+               const dir_sort_options_t *sort_op)
+{
+    file_entry_t key = *fentry;
+    int i, ret = -1;
+
+    dir_list_set_sort_options (sort_op);
+
+    // entries with different names can be equal (and all are equal in the unsorted list)
+    for (i = dir_list_lower_bound (list, &key, sort); ret == -1 && i < list->len; i++)
+    {
+        if (strcmp (list->list[i].fname->str, fentry->fname->str) == 0)
+            ret = i;
+        else if (dir_list_compare_at (list, i, &key, sort) != 0)
+            break;
+    }
+
+    file_entry_clean_sort_keys (&key);
+
+    return ret;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Check whether @fentry can replace the entry of sorted list keeping the order.
+ *
+ * @param list directory list
+ * @param idx index of entry to replace
+ * @param fentry new entry
+ * @param sort sort function
+ * @param sort_op sort options
+ *
+ * @return TRUE if @fentry is not less than the previous entry and not greater than the next one
+ */
+
+gboolean
+dir_list_fits_at (const dir_list *list, int idx, const file_entry_t *fentry, GCompareFunc sort,
+                  const dir_sort_options_t *sort_op)
+{
+    // ".." is always the first
+    const int first = DIR_IS_DOTDOT (list->list[0].fname->str) ? 1 : 0;
+    file_entry_t key = *fentry;
+    gboolean ret;
+
+    dir_list_set_sort_options (sort_op);
+
+    ret = (idx == first || dir_list_compare_at (list, idx - 1, &key, sort) <= 0)
+        && (idx == list->len - 1 || dir_list_compare_at (list, idx + 1, &key, sort) >= 0);
+
+    file_entry_clean_sort_keys (&key);
+
+    return ret;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 int
@@ -466,7 +1633,7 @@ sort_inode (file_entry_t *a, file_entry_t *b)
     int bd = MY_ISDIR (b);
 
     if (ad == bd || panels_options.mix_all_files)
-        return (a->st.st_ino - b->st.st_ino) * reverse;
+        return _GL_CMP (a->st.st_ino, b->st.st_ino) * reverse;
 
     return bd - ad;
 }
@@ -505,13 +1672,13 @@ dir_list_sort (dir_list *list, GCompareFunc sort, const dir_sort_options_t *sort
         /* If there is an ".." entry the caller must take care to
            ensure that it occupies the first list element. */
         dot_dot_found = DIR_IS_DOTDOT (fentry->fname->str) ? 1 : 0;
-        reverse = sort_op->reverse ? -1 : 1;
-        case_sensitive = sort_op->case_sensitive ? 1 : 0;
-        exec_first = sort_op->exec_first;
-        qsort (&(list->list)[dot_dot_found], list->len - dot_dot_found, sizeof (file_entry_t),
-               sort);
-
-        clean_sort_keys (list, dot_dot_found, list->len - dot_dot_found);
+        dir_list_set_sort_options (sort_op);
+        if (!dir_list_sort_by_keys (list, dot_dot_found, 0, list->len - dot_dot_found, sort))
+        {
+            qsort (&(list->list)[dot_dot_found], list->len - dot_dot_found, sizeof (file_entry_t),
+                   sort);
+            clean_sort_keys (list, dot_dot_found, list->len - dot_dot_found);
+        }
     }
 }
 
@@ -635,11 +1802,10 @@ dir_list_load (dir_list *list, const vfs_path_t *vpath, GCompareFunc sort,
                const dir_sort_options_t *sort_op, const file_filter_t *filter)
 {
     DIR *dirp;
-    struct vfs_dirent *dp;
     struct stat st;
     file_entry_t *fentry;
     const char *vpath_str;
-    gboolean ret = TRUE;
+    gboolean ret;
 
     // ".." (if any) must be the first entry in the list
     if (!dir_list_init (list))
@@ -662,22 +1828,9 @@ dir_list_load (dir_list *list, const vfs_path_t *vpath, GCompareFunc sort,
     if (IS_PATH_SEP (vpath_str[0]) && vpath_str[1] == '\0')
         dir_list_clean (list);
 
-    while (ret && (dp = mc_readdir (dirp)) != NULL)
-    {
-        gboolean link_to_dir, stale_link;
-
-        if (list->callback != NULL)
-            list->callback (DIR_READ, dp);
-
-        if (!handle_dirent (dp, filter, &st, &link_to_dir, &stale_link))
-            continue;
-
-        if (!dir_list_append (list, dp->d_name, &st, link_to_dir, stale_link))
-            ret = FALSE;
-    }
-
-    if (ret)
-        dir_list_sort (list, sort, sort_op);
+    dir_list_read_start (list, sort, sort_op, NULL, 0);
+    ret = dir_list_read (list, vpath, dirp, filter);
+    dir_list_read_finish (list);
 
     if (list->callback != NULL)
         list->callback (DIR_CLOSE, NULL);
@@ -708,13 +1861,12 @@ dir_list_reload (dir_list *list, const vfs_path_t *vpath, GCompareFunc sort,
                  const dir_sort_options_t *sort_op, const file_filter_t *filter)
 {
     DIR *dirp;
-    struct vfs_dirent *dp;
     int i;
     struct stat st;
     int marked_cnt;
     GHashTable *marked_files;
     const char *tmp_path;
-    gboolean ret = TRUE;
+    gboolean ret;
 
     if (list->callback != NULL)
         list->callback (DIR_OPEN, (void *) vpath);
@@ -781,38 +1933,9 @@ dir_list_reload (dir_list *list, const vfs_path_t *vpath, GCompareFunc sort,
         }
     }
 
-    while (ret && (dp = mc_readdir (dirp)) != NULL)
-    {
-        gboolean link_to_dir, stale_link;
-
-        if (list->callback != NULL)
-            list->callback (DIR_READ, dp);
-
-        if (!handle_dirent (dp, filter, &st, &link_to_dir, &stale_link))
-            continue;
-
-        if (!dir_list_append (list, dp->d_name, &st, link_to_dir, stale_link))
-            ret = FALSE;
-        else
-        {
-            file_entry_t *fentry;
-
-            fentry = &list->list[list->len - 1];
-
-            /*
-             * If we have marked files in the copy, scan through the copy
-             * to find matching file.  Decrease number of remaining marks if
-             * we copied one.
-             */
-            fentry->f.marked =
-                (marked_cnt > 0 && g_hash_table_lookup (marked_files, dp->d_name) != NULL) ? 1 : 0;
-            if (fentry->f.marked != 0)
-                marked_cnt--;
-        }
-    }
-
-    if (ret)
-        dir_list_sort (list, sort, sort_op);
+    dir_list_read_start (list, sort, sort_op, marked_files, marked_cnt);
+    ret = dir_list_read (list, vpath, dirp, filter);
+    dir_list_read_finish (list);
 
     if (list->callback != NULL)
         list->callback (DIR_CLOSE, NULL);
@@ -825,6 +1948,57 @@ dir_list_reload (dir_list *list, const vfs_path_t *vpath, GCompareFunc sort,
     return ret;
 }
 
+#ifdef HAVE_FSTATAT
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Open local directory to stat its entries relative to the directory descriptor.
+ *
+ * @return directory descriptor or -1 if directory is not local or cannot be opened
+ */
+
+int
+dir_list_open_local (const vfs_path_t *vpath)
+{
+    return dir_open_local (vpath);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Stat one entry of local directory like directory reading does.
+ *
+ * @param dfd directory descriptor
+ * @param fname file name
+ * @param filter file name filter
+ * @param fentry entry to fill, its file name is allocated if entry is returned
+ *
+ * @return TRUE if file exists and is shown in the directory list, FALSE otherwise
+ */
+
+gboolean
+dir_entry_stat_at (int dfd, const char *fname, const file_filter_t *filter, file_entry_t *fentry)
+{
+    const size_t len = strlen (fname);
+
+    if (len == 0 || !name_is_visible (fname, len))
+        return FALSE;
+
+    memset (fentry, 0, sizeof (*fentry));
+    fentry->fname = g_string_new_len (fname, len);
+    dir_stat_entry (dfd, fentry);
+
+    // file is removed already
+    if (fentry->st.st_mode == 0
+        || !dirent_match_filter (fname, len, &fentry->st, link_isdir (fentry), filter))
+    {
+        g_string_free (fentry->fname, TRUE);
+        fentry->fname = NULL;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+#endif
+
 /* --------------------------------------------------------------------------------------------- */
 
 void
@@ -21,6 +21,7 @@ typedef enum
 {
     DIR_OPEN = 0,
     DIR_READ,
+    DIR_PARTIAL,  // part of directory is read and sorted, can be shown
     DIR_CLOSE
 } dir_list_cb_state_t;
 
@@ -83,6 +84,13 @@ gboolean dir_list_load (dir_list *list, const vfs_path_t *vpath, GCompareFunc so
 gboolean dir_list_reload (dir_list *list, const vfs_path_t *vpath, GCompareFunc sort,
                           const dir_sort_options_t *sort_op, const file_filter_t *filter);
 void dir_list_sort (dir_list *list, GCompareFunc sort, const dir_sort_options_t *sort_op);
+int dir_list_insert (dir_list *list, const file_entry_t *fentry, GCompareFunc sort,
+                     const dir_sort_options_t *sort_op);
+void dir_list_remove (dir_list *list, int idx);
+int dir_list_find (const dir_list *list, const file_entry_t *fentry, GCompareFunc sort,
+                   const dir_sort_options_t *sort_op);
+gboolean dir_list_fits_at (const dir_list *list, int idx, const file_entry_t *fentry,
+                           GCompareFunc sort, const dir_sort_options_t *sort_op);
 gboolean dir_list_init (dir_list *list);
 void dir_list_clean (dir_list *list);
 void dir_list_free_list (dir_list *list);
@@ -102,6 +110,12 @@ int sort_inode (file_entry_t *a, file_entry_t *b);
 
 gboolean if_link_is_exe (const vfs_path_t *full_name, const file_entry_t *file);
 
+#ifdef HAVE_FSTATAT
+int dir_list_open_local (const vfs_path_t *vpath);
+gboolean dir_entry_stat_at (int dfd, const char *fname, const file_filter_t *filter,
+                            file_entry_t *fentry);
+#endif
+
 void file_filter_clear (file_filter_t *filter);
 
 /*** inline functions ****************************************************************************/
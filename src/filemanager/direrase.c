@@ -0,0 +1,211 @@
+/*
+   Parallel removal of files in local directories.
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** \file direrase.c
+ *  \brief Source: parallel removal of files in local directories
+ *
+ *  Directories are read by dir_walk_t threads, so paths are never resolved again.  Files are
+ *  removed by unlinkat() relative to the descriptor of directory.
+ *
+ *  Errors are not reported and directories are not removed.  The file manager removes
+ *  the rest of tree after that in the usual way: it asks the user about files which cannot
+ *  be removed.  Since the tree contains empty directories mostly, that is fast.
+ */
+
+#include <config.h>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "lib/global.h"
+
+#include "dirwalk.h"
+#include "direrase.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+/*** file scope type declarations ****************************************************************/
+
+/* results are protected by the lock of walk */
+struct dir_erase_struct
+{
+    dir_walk_t *walk;
+    size_t file_count;
+};
+
+/*** forward declarations (file scope functions) *************************************************/
+
+/*** file scope variables ************************************************************************/
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+dir_erase_entry (dir_walk_dir_t *dir, const struct dirent *dirent, gpointer user_data)
+{
+    (void) user_data;
+
+    if (dir_erase_entry_is_dir (dir->fd, dirent))
+        return TRUE;
+
+    if (unlinkat (dir->fd, dirent->d_name, 0) == 0)
+        dir->count++;
+
+    return FALSE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Count removed files.
+ */
+
+static void
+dir_erase_collect (dir_walk_dir_t *dir, gboolean done, gpointer user_data)
+{
+    dir_erase_t *de = (dir_erase_t *) user_data;
+
+    (void) done;
+
+    dir_walk_lock (de->walk);
+    de->file_count += dir->count;
+    dir_walk_unlock (de->walk);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Create the pool of threads.
+ *
+ * @param threads maximal number of threads
+ */
+
+dir_erase_t *
+dir_erase_new (int threads)
+{
+    static const dir_walk_callbacks_t callbacks = {
+        NULL,
+        dir_erase_entry,
+        dir_erase_collect,
+    };
+    dir_erase_t *de;
+
+    de = g_new0 (dir_erase_t, 1);
+    de->walk = dir_walk_new (threads, FALSE, &callbacks, de);
+
+    return de;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Stop removal and free @de.  Waits for directories being read.
+ */
+
+void
+dir_erase_free (dir_erase_t *de)
+{
+    if (de == NULL)
+        return;
+
+    dir_walk_free (de->walk);
+    g_free (de);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Add local directory whose files should be removed.  Symbolic link to directory is not
+ * followed.
+ *
+ * @param path absolute path of the directory
+ */
+
+void
+dir_erase_add (dir_erase_t *de, const char *path)
+{
+    int fd;
+
+    fd = open (path, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    if (fd != -1)
+        dir_walk_add (de->walk, fd, path);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Wait for all added directories are processed.
+ *
+ * @param timeout time to wait in microseconds
+ *
+ * @return TRUE if removal is finished, FALSE if timeout has passed
+ */
+
+gboolean
+dir_erase_wait (dir_erase_t *de, gint64 timeout)
+{
+    return dir_walk_wait (de->walk, timeout);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get current result.
+ *
+ * @param file_count number of removed files
+ * @param dirname last read directory (to be freed), NULL if no directory is read yet
+ */
+
+void
+dir_erase_get (dir_erase_t *de, size_t *file_count, char **dirname)
+{
+    dir_walk_lock (de->walk);
+    *file_count = de->file_count;
+    dir_walk_unlock (de->walk);
+
+    if (dirname != NULL)
+        *dirname = dir_walk_get_dirname (de->walk);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Check type of directory entry.  Symbolic link to directory is not a directory.
+ *
+ * @param fd descriptor of directory which @dirent is read from
+ */
+
+gboolean
+dir_erase_entry_is_dir (int fd, const struct dirent *dirent)
+{
+    struct stat st;
+
+#ifdef DT_DIR
+    if (dirent->d_type != DT_UNKNOWN)
+        return dirent->d_type == DT_DIR;
+#endif
+
+    return fstatat (fd, dirent->d_name, &st, AT_SYMLINK_NOFOLLOW) == 0 && S_ISDIR (st.st_mode);
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,34 @@
+/** \file direrase.h
+ *  \brief Header: parallel removal of files in local directories
+ */
+
+#ifndef MC__DIRERASE_H
+#define MC__DIRERASE_H
+
+#include <dirent.h>
+
+#include "lib/global.h"
+
+/*** typedefs(not structures) and defined constants **********************************************/
+
+typedef struct dir_erase_struct dir_erase_t;
+
+/*** enums ***************************************************************************************/
+
+/*** structures declarations (and typedefs of structures)*****************************************/
+
+/*** global variables defined in .c file *********************************************************/
+
+/*** declarations of public functions ************************************************************/
+
+dir_erase_t *dir_erase_new (int threads);
+void dir_erase_free (dir_erase_t *de);
+void dir_erase_add (dir_erase_t *de, const char *path);
+gboolean dir_erase_wait (dir_erase_t *de, gint64 timeout);
+void dir_erase_get (dir_erase_t *de, size_t *file_count, char **dirname);
+
+gboolean dir_erase_entry_is_dir (int fd, const struct dirent *dirent);
+
+/*** inline functions ****************************************************************************/
+
+#endif
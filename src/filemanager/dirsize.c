@@ -0,0 +1,499 @@
+/*
+   Parallel computing of sizes of local directories.
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** \file dirsize.c
+ *  \brief Source: parallel computing of sizes of local directories
+ *
+ *  Directories are scanned by dir_walk_t threads.  Entries are stat'ed by fstatat() relative
+ *  to the descriptor of directory.
+ *
+ *  The result of directory scan is cached by device and inode of directory and validated by
+ *  its mtime.  Size of file changed in place does not change the directory, so
+ *  cached results are used for DIR_SIZE_CACHE_TIMEOUT seconds only.  The file manager clears
+ *  the cache after file operations.
+ *
+ *  Files with several hard links are counted once.  Every directory is scanned once, that
+ *  prevents infinite loops if symlinks are followed.
+ */
+
+#include <config.h>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "lib/global.h"
+
+#include "dirwalk.h"
+#include "dirsize.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+#define DIR_SIZE_THREADS       4
+#define DIR_SIZE_CACHE_TIMEOUT 60
+#define DIR_SIZE_CACHE_MAX     100000
+
+/*** file scope type declarations ****************************************************************/
+
+typedef struct
+{
+    dev_t dev;
+    ino_t ino;
+    gboolean follow_symlinks;
+} dir_size_key_t;
+
+/* file with several hard links */
+typedef struct
+{
+    dir_size_key_t key;
+    off_t size;
+} dir_size_link_t;
+
+/* result of directory scan */
+typedef struct
+{
+    dir_size_key_t key;
+    time_t mtime;
+    gint64 timestamp;
+    gboolean changed;  // directory can be changed while it is scanned
+    size_t file_count;
+    uintmax_t total;   // without files in links
+    GArray *links;     // dir_size_link_t
+    GPtrArray *dirs;   // names of subdirectories
+} dir_size_entry_t;
+
+/* results are protected by the lock of walk */
+struct dir_size_struct
+{
+    dir_walk_t *walk;
+    gboolean follow_symlinks;
+
+    GHashTable *visited;  // scanned directories and counted hard links
+    size_t skipped;       // added directories which cannot be opened
+    size_t dir_count;
+    size_t file_count;
+    uintmax_t total;
+};
+
+/*** forward declarations (file scope functions) *************************************************/
+
+/*** file scope variables ************************************************************************/
+
+static GMutex cache_lock;
+static GHashTable *cache = NULL;
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+static guint
+dir_size_key_hash (gconstpointer v)
+{
+    const dir_size_key_t *key = (const dir_size_key_t *) v;
+
+    return (guint) key->ino ^ (guint) key->dev ^ (guint) key->follow_symlinks;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+dir_size_key_equal (gconstpointer v1, gconstpointer v2)
+{
+    const dir_size_key_t *key1 = (const dir_size_key_t *) v1;
+    const dir_size_key_t *key2 = (const dir_size_key_t *) v2;
+
+    return key1->ino == key2->ino && key1->dev == key2->dev
+        && key1->follow_symlinks == key2->follow_symlinks;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Remember directory or file with hard links.  Called with locked @ds.
+ *
+ * @return TRUE if @key is not visited yet
+ */
+
+static gboolean
+dir_size_visit (dir_size_t *ds, const dir_size_key_t *key)
+{
+    dir_size_key_t *k;
+
+    if (g_hash_table_contains (ds->visited, key))
+        return FALSE;
+
+    k = g_new (dir_size_key_t, 1);
+    *k = *key;
+    g_hash_table_add (ds->visited, k);
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+dir_size_entry_free (gpointer data)
+{
+    dir_size_entry_t *entry = (dir_size_entry_t *) data;
+
+    g_array_free (entry->links, TRUE);
+    g_ptr_array_free (entry->dirs, TRUE);
+    g_free (entry);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static dir_size_entry_t *
+dir_size_entry_new (const struct stat *dir_st, gboolean follow_symlinks)
+{
+    dir_size_entry_t *entry;
+
+    entry = g_new0 (dir_size_entry_t, 1);
+    entry->key.dev = dir_st->st_dev;
+    entry->key.ino = dir_st->st_ino;
+    entry->key.follow_symlinks = follow_symlinks;
+    entry->mtime = dir_st->st_mtime;
+    entry->timestamp = g_get_monotonic_time ();
+    // directory changed in the same second can be changed after the scan
+    entry->changed = dir_st->st_mtime >= time (NULL) - 1;
+    entry->links = g_array_new (FALSE, FALSE, sizeof (dir_size_link_t));
+    entry->dirs = g_ptr_array_new_with_free_func (g_free);
+
+    return entry;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get cached result of directory scan if directory is not changed since then.
+ */
+
+static dir_size_entry_t *
+dir_size_cache_lookup (const struct stat *dir_st, gboolean follow_symlinks)
+{
+    dir_size_key_t key = { dir_st->st_dev, dir_st->st_ino, follow_symlinks };
+    dir_size_entry_t *entry;
+
+    if (cache == NULL)
+        return NULL;
+
+    entry = (dir_size_entry_t *) g_hash_table_lookup (cache, &key);
+
+    if (entry != NULL
+        && (entry->mtime != dir_st->st_mtime
+            || g_get_monotonic_time () - entry->timestamp > DIR_SIZE_CACHE_TIMEOUT * G_USEC_PER_SEC))
+    {
+        g_hash_table_remove (cache, &key);
+        entry = NULL;
+    }
+
+    return entry;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+dir_size_cache_insert (dir_size_entry_t *entry)
+{
+    if (cache == NULL)
+        cache = g_hash_table_new_full (dir_size_key_hash, dir_size_key_equal, NULL,
+                                       dir_size_entry_free);
+    else if (g_hash_table_size (cache) >= DIR_SIZE_CACHE_MAX)
+        g_hash_table_remove_all (cache);
+
+    g_hash_table_replace (cache, &entry->key, entry);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Count the directory.  Called with locked walk.
+ */
+
+static void
+dir_size_count (dir_size_t *ds, const dir_size_entry_t *entry)
+{
+    guint i;
+
+    ds->dir_count++;
+    ds->file_count += entry->file_count;
+    ds->total += entry->total;
+
+    for (i = 0; i < entry->links->len; i++)
+    {
+        const dir_size_link_t *hard_link = &g_array_index (entry->links, dir_size_link_t, i);
+
+        if (dir_size_visit (ds, &hard_link->key))
+            ds->total += (uintmax_t) hard_link->size;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Skip visited directory, use the cached result or start scan of directory.
+ */
+
+static gboolean
+dir_size_enter (dir_walk_dir_t *dir, gpointer user_data)
+{
+    dir_size_t *ds = (dir_size_t *) user_data;
+    struct stat st;
+    dir_size_key_t key;
+    dir_size_entry_t *entry;
+    gboolean visited;
+
+    if (fstat (dir->fd, &st) != 0)
+        return FALSE;
+
+    key.dev = st.st_dev;
+    key.ino = st.st_ino;
+    key.follow_symlinks = FALSE;
+
+    dir_walk_lock (ds->walk);
+    visited = !dir_size_visit (ds, &key);
+    dir_walk_unlock (ds->walk);
+
+    if (visited)
+        return FALSE;
+
+    g_mutex_lock (&cache_lock);
+    entry = dir_size_cache_lookup (&st, ds->follow_symlinks);
+    if (entry != NULL)
+    {
+        guint i;
+
+        dir_walk_lock (ds->walk);
+        dir_size_count (ds, entry);
+        dir_walk_unlock (ds->walk);
+
+        for (i = 0; i < entry->dirs->len; i++)
+            g_ptr_array_add (dir->dirs, g_strdup (g_ptr_array_index (entry->dirs, i)));
+    }
+    g_mutex_unlock (&cache_lock);
+
+    if (entry != NULL)
+        return FALSE;
+
+    dir->data = dir_size_entry_new (&st, ds->follow_symlinks);
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+dir_size_entry (dir_walk_dir_t *dir, const struct dirent *dirent, gpointer user_data)
+{
+    dir_size_t *ds = (dir_size_t *) user_data;
+    dir_size_entry_t *entry = (dir_size_entry_t *) dir->data;
+    struct stat st;
+
+    // entries which cannot be stat'ed are not counted
+    if (fstatat (dir->fd, dirent->d_name, &st, ds->follow_symlinks ? 0 : AT_SYMLINK_NOFOLLOW) != 0)
+        return FALSE;
+
+    if (S_ISDIR (st.st_mode))
+    {
+        g_ptr_array_add (entry->dirs, g_strdup (dirent->d_name));
+        return TRUE;
+    }
+
+    entry->file_count++;
+
+    if (S_ISREG (st.st_mode) && st.st_nlink > 1)
+    {
+        dir_size_link_t hard_link = { { st.st_dev, st.st_ino, FALSE }, st.st_size };
+
+        g_array_append_val (entry->links, hard_link);
+    }
+    else
+        entry->total += (uintmax_t) st.st_size;
+
+    return FALSE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Count scanned directory and cache the result.
+ */
+
+static void
+dir_size_collect (dir_walk_dir_t *dir, gboolean done, gpointer user_data)
+{
+    dir_size_t *ds = (dir_size_t *) user_data;
+    dir_size_entry_t *entry = (dir_size_entry_t *) dir->data;
+
+    // directory is visited already or its result is cached
+    if (!done || entry == NULL)
+        return;
+
+    dir_walk_lock (ds->walk);
+    dir_size_count (ds, entry);
+    dir_walk_unlock (ds->walk);
+
+    if (entry->changed)
+        dir_size_entry_free (entry);
+    else
+    {
+        g_mutex_lock (&cache_lock);
+        dir_size_cache_insert (entry);
+        g_mutex_unlock (&cache_lock);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+dir_size_t *
+dir_size_new (gboolean follow_symlinks)
+{
+    static const dir_walk_callbacks_t callbacks = {
+        dir_size_enter,
+        dir_size_entry,
+        dir_size_collect,
+    };
+    dir_size_t *ds;
+
+    ds = g_new0 (dir_size_t, 1);
+    ds->follow_symlinks = follow_symlinks;
+    ds->visited = g_hash_table_new_full (dir_size_key_hash, dir_size_key_equal, g_free, NULL);
+    ds->walk = dir_walk_new (DIR_SIZE_THREADS, follow_symlinks, &callbacks, ds);
+
+    return ds;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Stop computing and free @ds.  Waits for directories being read.
+ */
+
+void
+dir_size_free (dir_size_t *ds)
+{
+    if (ds == NULL)
+        return;
+
+    dir_walk_free (ds->walk);
+    g_hash_table_destroy (ds->visited);
+    g_free (ds);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Add local directory to compute.  The size of all added directories is summed.
+ *
+ * @param path absolute path of the directory
+ */
+
+void
+dir_size_add (dir_size_t *ds, const char *path)
+{
+    int fd;
+
+    fd = open (path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd != -1)
+        dir_walk_add (ds->walk, fd, path);
+    else
+    {
+        dir_walk_lock (ds->walk);
+        ds->skipped++;
+        dir_walk_unlock (ds->walk);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Wait for all added directories are computed.
+ *
+ * @param timeout time to wait in microseconds
+ *
+ * @return TRUE if computing is finished, FALSE if timeout has passed
+ */
+
+gboolean
+dir_size_wait (dir_size_t *ds, gint64 timeout)
+{
+    return dir_walk_wait (ds->walk, timeout);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get current result.  Directories which cannot be opened are counted, but their files are not.
+ *
+ * @param dirname last scanned directory (to be freed), NULL if no directory is scanned yet
+ */
+
+void
+dir_size_get (dir_size_t *ds, size_t *dir_count, size_t *file_count, uintmax_t *total,
+              char **dirname)
+{
+    const size_t skipped = dir_walk_get_skipped (ds->walk);
+
+    dir_walk_lock (ds->walk);
+    *dir_count = ds->dir_count + ds->skipped + skipped;
+    *file_count = ds->file_count;
+    *total = ds->total;
+    dir_walk_unlock (ds->walk);
+
+    if (dirname != NULL)
+        *dirname = dir_walk_get_dirname (ds->walk);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get number of directories which cannot be opened.  If it isn't 0, the result is incomplete.
+ */
+
+size_t
+dir_size_get_skipped (dir_size_t *ds)
+{
+    size_t skipped;
+
+    skipped = dir_walk_get_skipped (ds->walk);
+
+    dir_walk_lock (ds->walk);
+    skipped += ds->skipped;
+    dir_walk_unlock (ds->walk);
+
+    return skipped;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Forget sizes of all directories, e.g. after the files are changed.
+ */
+
+void
+dir_size_cache_clear (void)
+{
+    g_mutex_lock (&cache_lock);
+    if (cache != NULL)
+    {
+        g_hash_table_destroy (cache);
+        cache = NULL;
+    }
+    g_mutex_unlock (&cache_lock);
+}
+
+/* --------------------------------------------------------------------------------------------- */
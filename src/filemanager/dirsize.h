@@ -0,0 +1,34 @@
+/** \file dirsize.h
+ *  \brief Header: parallel computing of sizes of local directories
+ */
+
+#ifndef MC__DIRSIZE_H
+#define MC__DIRSIZE_H
+
+#include "lib/global.h"
+
+/*** typedefs(not structures) and defined constants **********************************************/
+
+typedef struct dir_size_struct dir_size_t;
+
+/*** enums ***************************************************************************************/
+
+/*** structures declarations (and typedefs of structures)*****************************************/
+
+/*** global variables defined in .c file *********************************************************/
+
+/*** declarations of public functions ************************************************************/
+
+dir_size_t *dir_size_new (gboolean follow_symlinks);
+void dir_size_free (dir_size_t *ds);
+void dir_size_add (dir_size_t *ds, const char *path);
+gboolean dir_size_wait (dir_size_t *ds, gint64 timeout);
+void dir_size_get (dir_size_t *ds, size_t *dir_count, size_t *file_count, uintmax_t *total,
+                   char **dirname);
+size_t dir_size_get_skipped (dir_size_t *ds);
+
+void dir_size_cache_clear (void);
+
+/*** inline functions ****************************************************************************/
+
+#endif
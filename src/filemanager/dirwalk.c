@@ -0,0 +1,408 @@
+/*
+   Walk of local directory trees by several threads.
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** \file dirwalk.c
+ *  \brief Source: walk of local directory trees by several threads
+ *
+ *  Directories are read by a pool of threads.  Subdirectories are opened by openat() relative
+ *  to the descriptor of their parent, and descriptors are queued to the pool, so paths are never
+ *  resolved again.  To limit the number of open descriptors, only DIR_WALK_QUEUE_MAX directories
+ *  are queued: when the queue is full, the thread walks the subdirectory itself.  If descriptors
+ *  are exhausted anyway, the subdirectory is queued by path and opened when it is dequeued.
+ *
+ *  What is done with entries is up to the callbacks.  They are called without lock;
+ *  dir_walk_lock() protects their results.
+ */
+
+#include <config.h>
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "lib/global.h"
+
+#include "dirwalk.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+/* number of entries read between collects of results */
+#define DIR_WALK_COLLECT_STEP 256
+
+/* maximal number of queued directories */
+#define DIR_WALK_QUEUE_MAX 128
+
+/*** file scope type declarations ****************************************************************/
+
+/* queued directory */
+typedef struct
+{
+    int fd;  // -1 if directory is not opened yet
+    char *path;
+} dir_walk_item_t;
+
+struct dir_walk_struct
+{
+    GThreadPool *pool;
+    int open_flags;
+    dir_walk_callbacks_t callbacks;
+    gpointer user_data;
+
+    GMutex lock;
+    GCond cond;
+    guint pending;   // number of queued and read directories
+    size_t skipped;  // number of subdirectories which cannot be opened
+    gboolean stop;
+
+    char *dirname;  // last read directory
+};
+
+/*** forward declarations (file scope functions) *************************************************/
+
+/*** file scope variables ************************************************************************/
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+dir_walk_is_stopped (dir_walk_t *dw)
+{
+    gboolean stop;
+
+    g_mutex_lock (&dw->lock);
+    stop = dw->stop;
+    g_mutex_unlock (&dw->lock);
+
+    return stop;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Queue directory to the pool.  Called with locked @dw.
+ */
+
+static void
+dir_walk_push (dir_walk_t *dw, int fd, char *path)
+{
+    dir_walk_item_t *item;
+
+    item = g_new (dir_walk_item_t, 1);
+    item->fd = fd;
+    item->path = path;
+
+    dw->pending++;
+    g_thread_pool_push (dw->pool, item, NULL);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Count subdirectory which cannot be opened.
+ */
+
+static void
+dir_walk_skip (dir_walk_t *dw)
+{
+    g_mutex_lock (&dw->lock);
+    dw->skipped++;
+    g_mutex_unlock (&dw->lock);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Read directory and walk into its subdirectories.
+ *
+ * @param fd descriptor of directory, closed by this function
+ */
+
+static void
+dir_walk_dir (dir_walk_t *dw, int fd, const char *path)
+{
+    dir_walk_dir_t dir = { fd, path, NULL, 0, NULL };
+    DIR *reading = NULL;
+    gboolean stop;
+    guint i;
+
+    stop = dir_walk_is_stopped (dw);
+    if (stop)
+    {
+        close (fd);
+        return;
+    }
+
+    dir.dirs = g_ptr_array_new_with_free_func (g_free);
+
+    if (dw->callbacks.enter == NULL || dw->callbacks.enter (&dir, dw->user_data))
+        reading = fdopendir (fd);
+
+    if (reading != NULL)
+    {
+        struct dirent *dirent;
+        int n = 0;
+
+        while (!stop && (dirent = readdir (reading)) != NULL)
+        {
+            if (DIR_IS_DOT (dirent->d_name) || DIR_IS_DOTDOT (dirent->d_name))
+                continue;
+
+            if (dw->callbacks.entry (&dir, dirent, dw->user_data))
+                g_ptr_array_add (dir.dirs, g_strdup (dirent->d_name));
+
+            if (++n == DIR_WALK_COLLECT_STEP)
+            {
+                dw->callbacks.collect (&dir, FALSE, dw->user_data);
+                dir.count = 0;
+                n = 0;
+                stop = dir_walk_is_stopped (dw);
+            }
+        }
+    }
+
+    dw->callbacks.collect (&dir, TRUE, dw->user_data);
+
+    g_mutex_lock (&dw->lock);
+    g_free (dw->dirname);
+    dw->dirname = g_strdup (path);
+    g_mutex_unlock (&dw->lock);
+
+    for (i = 0; i < dir.dirs->len && !stop; i++)
+    {
+        const char *name = (const char *) g_ptr_array_index (dir.dirs, i);
+        int sub_fd;
+        char *sub_path;
+        gboolean queued;
+
+        sub_fd = openat (fd, name, dw->open_flags);
+        // if descriptors are exhausted, the subdirectory is queued without descriptor
+        // and opened by path later, when queued directories are closed
+        if (sub_fd == -1 && errno != EMFILE && errno != ENFILE)
+        {
+            dir_walk_skip (dw);
+            continue;
+        }
+
+        sub_path = g_build_filename (path, name, NULL);
+
+        g_mutex_lock (&dw->lock);
+        // the pool is being freed
+        stop = dw->stop;
+        queued =
+            !stop && (sub_fd == -1 || g_thread_pool_unprocessed (dw->pool) < DIR_WALK_QUEUE_MAX);
+        if (queued)
+            dir_walk_push (dw, sub_fd, sub_path);
+        g_mutex_unlock (&dw->lock);
+
+        if (!queued)
+        {
+            if (sub_fd != -1)
+                dir_walk_dir (dw, sub_fd, sub_path);
+            g_free (sub_path);
+        }
+    }
+
+    g_ptr_array_free (dir.dirs, TRUE);
+
+    if (reading != NULL)
+        closedir (reading);
+    else
+        close (fd);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+dir_walk_run (gpointer data, gpointer user_data)
+{
+    dir_walk_item_t *item = (dir_walk_item_t *) data;
+    dir_walk_t *dw = (dir_walk_t *) user_data;
+
+    if (item->fd == -1)
+    {
+        item->fd = open (item->path, dw->open_flags);
+        if (item->fd == -1)
+            dir_walk_skip (dw);
+    }
+
+    if (item->fd != -1)
+        dir_walk_dir (dw, item->fd, item->path);
+    g_free (item->path);
+    g_free (item);
+
+    g_mutex_lock (&dw->lock);
+    dw->pending--;
+    if (dw->pending == 0)
+        g_cond_broadcast (&dw->cond);
+    g_mutex_unlock (&dw->lock);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Create the pool of threads.
+ *
+ * @param threads maximal number of threads
+ * @param follow_symlinks TRUE if symbolic links to directories are walked into
+ * @param callbacks callbacks called for directories and their entries
+ * @param user_data data passed to callbacks
+ */
+
+dir_walk_t *
+dir_walk_new (int threads, gboolean follow_symlinks, const dir_walk_callbacks_t *callbacks,
+              gpointer user_data)
+{
+    dir_walk_t *dw;
+
+    dw = g_new0 (dir_walk_t, 1);
+    dw->open_flags = O_RDONLY | O_DIRECTORY | O_CLOEXEC | (follow_symlinks ? 0 : O_NOFOLLOW);
+    dw->callbacks = *callbacks;
+    dw->user_data = user_data;
+    g_mutex_init (&dw->lock);
+    g_cond_init (&dw->cond);
+    dw->pool = g_thread_pool_new (dir_walk_run, dw, threads, FALSE, NULL);
+
+    return dw;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Stop walk and free @dw.  Waits for directories being read.
+ */
+
+void
+dir_walk_free (dir_walk_t *dw)
+{
+    if (dw == NULL)
+        return;
+
+    // queued directories are skipped
+    g_mutex_lock (&dw->lock);
+    dw->stop = TRUE;
+    g_mutex_unlock (&dw->lock);
+    g_thread_pool_free (dw->pool, FALSE, TRUE);
+
+    g_free (dw->dirname);
+    g_cond_clear (&dw->cond);
+    g_mutex_clear (&dw->lock);
+    g_free (dw);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Add directory to walk.
+ *
+ * @param fd descriptor of the directory, closed after walk
+ * @param path path of the directory
+ */
+
+void
+dir_walk_add (dir_walk_t *dw, int fd, const char *path)
+{
+    g_mutex_lock (&dw->lock);
+    dir_walk_push (dw, fd, g_strdup (path));
+    g_mutex_unlock (&dw->lock);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Wait for all added directories are walked.
+ *
+ * @param timeout time to wait in microseconds
+ *
+ * @return TRUE if walk is finished, FALSE if timeout has passed
+ */
+
+gboolean
+dir_walk_wait (dir_walk_t *dw, gint64 timeout)
+{
+    const gint64 end_time = g_get_monotonic_time () + timeout;
+    gboolean done;
+
+    g_mutex_lock (&dw->lock);
+    while (dw->pending != 0 && g_cond_wait_until (&dw->cond, &dw->lock, end_time))
+        ;
+    done = dw->pending == 0;
+    g_mutex_unlock (&dw->lock);
+
+    return done;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get last read directory.
+ *
+ * @return path of directory (to be freed), NULL if no directory is read yet
+ */
+
+char *
+dir_walk_get_dirname (dir_walk_t *dw)
+{
+    char *dirname;
+
+    g_mutex_lock (&dw->lock);
+    dirname = g_strdup (dw->dirname);
+    g_mutex_unlock (&dw->lock);
+
+    return dirname;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get number of subdirectories which cannot be opened.  Their entries are not walked.
+ */
+
+size_t
+dir_walk_get_skipped (dir_walk_t *dw)
+{
+    size_t skipped;
+
+    g_mutex_lock (&dw->lock);
+    skipped = dw->skipped;
+    g_mutex_unlock (&dw->lock);
+
+    return skipped;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Lock results of callbacks.
+ */
+
+void
+dir_walk_lock (dir_walk_t *dw)
+{
+    g_mutex_lock (&dw->lock);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+dir_walk_unlock (dir_walk_t *dw)
+{
+    g_mutex_unlock (&dw->lock);
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,58 @@
+/** \file dirwalk.h
+ *  \brief Header: walk of local directory trees by several threads
+ */
+
+#ifndef MC__DIRWALK_H
+#define MC__DIRWALK_H
+
+#include <dirent.h>
+
+#include "lib/global.h"
+
+/*** typedefs(not structures) and defined constants **********************************************/
+
+typedef struct dir_walk_struct dir_walk_t;
+
+/*** enums ***************************************************************************************/
+
+/*** structures declarations (and typedefs of structures)*****************************************/
+
+/* directory being read */
+typedef struct
+{
+    int fd;            // descriptor of directory
+    const char *path;  // path of directory
+    GPtrArray *dirs;   // names of subdirectories to walk into
+    size_t count;      // number of entries counted by callbacks since the last collect
+    gpointer data;     // data of callbacks, NULL initially
+} dir_walk_dir_t;
+
+typedef struct
+{
+    /* directory is opened.  Returns FALSE if its entries should not be read.  May be NULL */
+    gboolean (*enter) (dir_walk_dir_t *dir, gpointer user_data);
+    /* entry of directory is read.  Returns TRUE if it is a directory to walk into */
+    gboolean (*entry) (dir_walk_dir_t *dir, const struct dirent *dirent, gpointer user_data);
+    /* results of directory are collected: several times while a big directory is read and
+       once after all entries (@done is TRUE) */
+    void (*collect) (dir_walk_dir_t *dir, gboolean done, gpointer user_data);
+} dir_walk_callbacks_t;
+
+/*** global variables defined in .c file *********************************************************/
+
+/*** declarations of public functions ************************************************************/
+
+dir_walk_t *dir_walk_new (int threads, gboolean follow_symlinks,
+                          const dir_walk_callbacks_t *callbacks, gpointer user_data);
+void dir_walk_free (dir_walk_t *dw);
+void dir_walk_add (dir_walk_t *dw, int fd, const char *path);
+gboolean dir_walk_wait (dir_walk_t *dw, gint64 timeout);
+char *dir_walk_get_dirname (dir_walk_t *dw);
+size_t dir_walk_get_skipped (dir_walk_t *dw);
+
+void dir_walk_lock (dir_walk_t *dw);
+void dir_walk_unlock (dir_walk_t *dw);
+
+/*** inline functions ****************************************************************************/
+
+#endif
@@ -0,0 +1,456 @@
+/*
+   Watching of directory changes
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** \file src/filemanager/dirwatch.c
+ *  \brief Source: watching of directory changes
+ *
+ *  Local directory shown in the panel is watched with inotify. Names of changed entries
+ *  are collected, and the loaded directory list is updated entry by entry instead of
+ *  reading the whole directory again.
+ *
+ *  Entry of sorted list is found using binary search, that requires fields of entry used
+ *  by sort functions. inotify doesn't report the previous state of changed file, so
+ *  these fields of all listed entries are kept in the watcher.
+ */
+
+#include <config.h>
+
+#include <string.h>
+
+#if defined(HAVE_SYS_INOTIFY_H) && defined(HAVE_FSTATAT)
+#define DIR_WATCH_INOTIFY 1
+#include <sys/inotify.h>
+#include <unistd.h>  // read(), close()
+#endif
+
+#include "lib/global.h"
+#include "lib/tty/key.h"  // add_select_channel()
+
+#include "src/setup.h"  // panels_options
+
+#include "dirwatch.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+#define DIR_WATCH_EVENTS                                                                           \
+    (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ATTRIB | IN_MODIFY | IN_CLOSE_WRITE  \
+     | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR | IN_EXCL_UNLINK)
+
+/* events after those the list cannot be updated */
+#define DIR_WATCH_LOST_EVENTS                                                                      \
+    (IN_Q_OVERFLOW | IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF | IN_UNMOUNT)
+
+/* Changes of so many entries are not collected: reading of directory is cheaper */
+#define DIR_WATCH_MAX_CHANGES 65536
+
+/*** file scope type declarations ****************************************************************/
+
+#ifdef DIR_WATCH_INOTIFY
+/* fields of listed entry used by sort functions */
+typedef struct
+{
+    mode_t mode;
+    ino_t ino;
+    off_t size;
+    time_t atime;
+    time_t mtime;
+    time_t ctime;
+    gboolean link_to_dir;
+} dir_watch_entry_t;
+
+struct dir_watch_struct
+{
+    int fd;               // inotify descriptor
+    int dirfd;            // descriptor of watched directory
+    gboolean valid;       // FALSE if some changes are lost
+    GHashTable *entries;  // name -> dir_watch_entry_t of listed entries
+    GHashTable *changed;  // names of changed entries
+    GString *name;        // temporary name of entry to find
+
+    // settings the list was loaded with
+    gboolean show_dot_files;
+    gboolean show_backups;
+    gboolean mix_all_files;
+    char *filter;
+    select_flags_t filter_flags;
+
+    dir_watch_cb_fn callback;
+    void *data;
+};
+#endif
+
+/*** forward declarations (file scope functions) *************************************************/
+
+/*** file scope variables ************************************************************************/
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+#ifdef DIR_WATCH_INOTIFY
+static dir_watch_entry_t *
+dir_watch_entry_new (const file_entry_t *fentry)
+{
+    dir_watch_entry_t *e;
+
+    e = g_new (dir_watch_entry_t, 1);
+    e->mode = fentry->st.st_mode;
+    e->ino = fentry->st.st_ino;
+    e->size = fentry->st.st_size;
+    e->atime = fentry->st.st_atime;
+    e->mtime = fentry->st.st_mtime;
+    e->ctime = fentry->st.st_ctime;
+    e->link_to_dir = link_isdir (fentry);
+
+    return e;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Make an entry to compare with entries of list */
+
+static void
+dir_watch_entry_restore (const dir_watch_entry_t *e, GString *name, file_entry_t *fentry)
+{
+    memset (fentry, 0, sizeof (*fentry));
+    fentry->fname = name;
+    fentry->st.st_mode = e->mode;
+    fentry->st.st_ino = e->ino;
+    fentry->st.st_size = e->size;
+    fentry->st.st_atime = e->atime;
+    fentry->st.st_mtime = e->mtime;
+    fentry->st.st_ctime = e->ctime;
+    fentry->f.link_to_dir = e->link_to_dir ? 1 : 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Read pending events and collect names of changed entries.
+ */
+
+static void
+dir_watch_read (dir_watch_t *watch)
+{
+    // aligned buffer for struct inotify_event
+    gint64 buf[4096 / sizeof (gint64)];
+    ssize_t len;
+
+    while ((len = read (watch->fd, buf, sizeof (buf))) > 0)
+    {
+        const char *p = (const char *) buf;
+        const char *end = p + len;
+
+        while (p < end)
+        {
+            const struct inotify_event *ev = (const struct inotify_event *) p;
+
+            if ((ev->mask & DIR_WATCH_LOST_EVENTS) != 0)
+                watch->valid = FALSE;
+            else if (watch->valid && ev->len != 0
+                     && !g_hash_table_contains (watch->changed, ev->name))
+                g_hash_table_add (watch->changed, g_strdup (ev->name));
+
+            p += sizeof (struct inotify_event) + ev->len;
+        }
+
+        if (g_hash_table_size (watch->changed) > DIR_WATCH_MAX_CHANGES)
+            watch->valid = FALSE;
+
+        if (!watch->valid)
+            g_hash_table_remove_all (watch->changed);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static int
+dir_watch_select_cb (int fd, void *info)
+{
+    dir_watch_t *watch = (dir_watch_t *) info;
+
+    (void) fd;
+
+    dir_watch_read (watch);
+
+    // watch can be freed in callback
+    if (!watch->valid || g_hash_table_size (watch->changed) != 0)
+        watch->callback (watch->data);
+
+    return 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Check whether the list was loaded with the current settings */
+
+static gboolean
+dir_watch_settings_match (const dir_watch_t *watch, const file_filter_t *filter)
+{
+    return watch->show_dot_files == panels_options.show_dot_files
+        && watch->show_backups == panels_options.show_backups
+        && watch->mix_all_files == panels_options.mix_all_files
+        && g_strcmp0 (watch->filter, filter->value) == 0 && watch->filter_flags == filter->flags;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Update one entry of directory list: remove old one, if any, and insert the new one,
+ * if file exists.
+ *
+ * @return FALSE if list cannot be updated, TRUE otherwise
+ */
+
+static gboolean
+dir_watch_update_entry (dir_watch_t *watch, dir_list *list, const char *name, GCompareFunc sort,
+                        const dir_sort_options_t *sort_op, const file_filter_t *filter,
+                        dir_watch_change_fn change, void *data)
+{
+    const dir_watch_entry_t *old;
+    file_entry_t fentry;
+    gboolean exists;
+    int i = -1;
+
+    exists = dir_entry_stat_at (watch->dirfd, name, filter, &fentry);
+
+    old = (const dir_watch_entry_t *) g_hash_table_lookup (watch->entries, name);
+    if (old != NULL)
+    {
+        file_entry_t probe;
+
+        g_string_assign (watch->name, name);
+        dir_watch_entry_restore (old, watch->name, &probe);
+        i = dir_list_find (list, &probe, sort, sort_op);
+        if (i < 0)
+        {
+            // list was changed bypassing the watcher
+            if (exists)
+                g_string_free (fentry.fname, TRUE);
+            return FALSE;
+        }
+    }
+
+    if (i >= 0)
+    {
+        file_entry_t *fe = &list->list[i];
+
+        if (exists)
+        {
+            fentry.f.marked = fe->f.marked;
+
+            // nothing is changed
+            if (memcmp (&fentry.st, &fe->st, sizeof (fentry.st)) == 0
+                && fentry.f.link_to_dir == fe->f.link_to_dir
+                && fentry.f.stale_link == fe->f.stale_link)
+            {
+                g_string_free (fentry.fname, TRUE);
+                return TRUE;
+            }
+        }
+
+        change (DIR_WATCH_REMOVE, i, data);
+
+        // entry keeps its place in the list: update it in place
+        if (exists && dir_list_fits_at (list, i, &fentry, sort, sort_op))
+        {
+            g_string_free (fe->fname, TRUE);
+            *fe = fentry;
+        }
+        else
+        {
+            dir_list_remove (list, i);
+            i = -1;
+        }
+    }
+
+    if (!exists)
+    {
+        g_hash_table_remove (watch->entries, name);
+        return TRUE;
+    }
+
+    if (i < 0)
+    {
+        i = dir_list_insert (list, &fentry, sort, sort_op);
+        if (i < 0)
+        {
+            g_string_free (fentry.fname, TRUE);
+            g_hash_table_remove (watch->entries, name);
+            return FALSE;
+        }
+    }
+
+    g_hash_table_replace (watch->entries, g_strdup (name), dir_watch_entry_new (&fentry));
+    change (DIR_WATCH_INSERT, i, data);
+
+    return TRUE;
+}
+#endif
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Start watching of directory.
+ *
+ * @param vpath directory path
+ * @param list directory list that is just loaded
+ * @param filter file name filter the list is loaded with
+ * @param callback function that is called from the main loop when directory is changed
+ * @param data user data for @callback
+ *
+ * @return new watcher, NULL if directory cannot be watched
+ */
+
+dir_watch_t *
+dir_watch_new (const vfs_path_t *vpath, const dir_list *list, const file_filter_t *filter,
+               dir_watch_cb_fn callback, void *data)
+{
+#ifdef DIR_WATCH_INOTIFY
+    dir_watch_t *watch;
+    int dirfd, fd, i;
+
+    dirfd = dir_list_open_local (vpath);
+    if (dirfd == -1)
+        return NULL;
+
+    fd = inotify_init1 (IN_NONBLOCK | IN_CLOEXEC);
+    if (fd == -1)
+    {
+        close (dirfd);
+        return NULL;
+    }
+
+    if (inotify_add_watch (fd, vfs_path_get_by_index (vpath, 0)->path, DIR_WATCH_EVENTS) == -1)
+    {
+        close (fd);
+        close (dirfd);
+        return NULL;
+    }
+
+    watch = g_new0 (dir_watch_t, 1);
+    watch->fd = fd;
+    watch->dirfd = dirfd;
+    watch->valid = TRUE;
+    watch->entries = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+    watch->changed = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    watch->name = g_string_sized_new (MC_MAXFILENAMELEN);
+    watch->show_dot_files = panels_options.show_dot_files;
+    watch->show_backups = panels_options.show_backups;
+    watch->mix_all_files = panels_options.mix_all_files;
+    watch->filter = g_strdup (filter->value);
+    watch->filter_flags = filter->flags;
+    watch->callback = callback;
+    watch->data = data;
+
+    for (i = 0; i < list->len; i++)
+        if (!DIR_IS_DOTDOT (list->list[i].fname->str))
+            g_hash_table_insert (watch->entries, g_strdup (list->list[i].fname->str),
+                                 dir_watch_entry_new (&list->list[i]));
+
+    add_select_channel (fd, dir_watch_select_cb, watch);
+
+    return watch;
+#else
+    (void) vpath;
+    (void) list;
+    (void) filter;
+    (void) callback;
+    (void) data;
+
+    return NULL;
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+dir_watch_free (dir_watch_t *watch)
+{
+#ifdef DIR_WATCH_INOTIFY
+    if (watch == NULL)
+        return;
+
+    delete_select_channel (watch->fd);
+    close (watch->fd);
+    close (watch->dirfd);
+    g_hash_table_destroy (watch->entries);
+    g_hash_table_destroy (watch->changed);
+    g_string_free (watch->name, TRUE);
+    g_free (watch->filter);
+    g_free (watch);
+#else
+    (void) watch;
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Apply collected changes of directory to the list. Sort order of list is kept.
+ *
+ * @param watch watcher
+ * @param list directory list the watcher was created for
+ * @param sort sort function
+ * @param sort_op sort options
+ * @param filter file name filter
+ * @param change function that is called for each removed and inserted entry
+ * @param data user data for @change
+ *
+ * @return TRUE if list is up to date, FALSE if directory should be reloaded
+ */
+
+gboolean
+dir_watch_update (dir_watch_t *watch, dir_list *list, GCompareFunc sort,
+                  const dir_sort_options_t *sort_op, const file_filter_t *filter,
+                  dir_watch_change_fn change, void *data)
+{
+#ifdef DIR_WATCH_INOTIFY
+    GHashTableIter iter;
+    gpointer key;
+
+    // take changes made just now, i.e. by file operation
+    dir_watch_read (watch);
+
+    if (!watch->valid || !dir_watch_settings_match (watch, filter))
+        return FALSE;
+
+    g_hash_table_iter_init (&iter, watch->changed);
+    while (watch->valid && g_hash_table_iter_next (&iter, &key, NULL))
+        watch->valid = dir_watch_update_entry (watch, list, (const char *) key, sort, sort_op,
+                                               filter, change, data);
+
+    g_hash_table_remove_all (watch->changed);
+
+    return watch->valid;
+#else
+    (void) watch;
+    (void) list;
+    (void) sort;
+    (void) sort_op;
+    (void) filter;
+    (void) change;
+    (void) data;
+
+    return FALSE;
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,46 @@
+/** \file dirwatch.h
+ *  \brief Header: watching of directory changes
+ */
+
+#ifndef MC__DIRWATCH_H
+#define MC__DIRWATCH_H
+
+#include "lib/global.h"
+#include "lib/vfs/vfs.h"
+
+#include "dir.h"
+
+/*** typedefs(not structures) and defined constants **********************************************/
+
+typedef struct dir_watch_struct dir_watch_t;
+
+/*** enums ***************************************************************************************/
+
+typedef enum
+{
+    DIR_WATCH_REMOVE = 0,  // entry is going to be removed from the list
+    DIR_WATCH_INSERT       // entry is inserted to the list
+} dir_watch_change_t;
+
+/* Directory is changed, changes can be applied using dir_watch_update() */
+typedef void (*dir_watch_cb_fn) (void *data);
+
+/* Called for each change of directory list made by dir_watch_update() */
+typedef void (*dir_watch_change_fn) (dir_watch_change_t change, int idx, void *data);
+
+/*** structures declarations (and typedefs of structures)*****************************************/
+
+/*** global variables defined in .c file *********************************************************/
+
+/*** declarations of public functions ************************************************************/
+
+dir_watch_t *dir_watch_new (const vfs_path_t *vpath, const dir_list *list,
+                            const file_filter_t *filter, dir_watch_cb_fn callback, void *data);
+void dir_watch_free (dir_watch_t *watch);
+gboolean dir_watch_update (dir_watch_t *watch, dir_list *list, GCompareFunc sort,
+                           const dir_sort_options_t *sort_op, const file_filter_t *filter,
+                           dir_watch_change_fn change, void *data);
+
+/*** inline functions ****************************************************************************/
+
+#endif
@@ -53,16 +53,22 @@
 
 #include <ctype.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/types.h>
+#include <sys/resource.h>  // getrusage()
 #include <sys/stat.h>
 #include <unistd.h>
+#ifdef ENABLE_EXT2FS_ATTR
+#include <e2p/e2p.h>  // fgetflags(), fsetflags()
+#endif
 
 #include "lib/global.h"
 #include "lib/tty/tty.h"
 #include "lib/tty/key.h"
+#include "lib/logging.h"
 #include "lib/search.h"
 #include "lib/strutil.h"
 #include "lib/util.h"
@@ -83,6 +89,13 @@
 #include "filemanager.h"  // other_panel
 #include "layout.h"       // rotate_dash()
 #include "ioblksize.h"    // io_blksize()
+#include "copyreader.h"
+#include "copywriter.h"
+#include "direrase.h"
+#include "dirsize.h"
+#ifdef ENABLE_URING
+#include "fileuring.h"
+#endif
 
 #include "file.h"
 
@@ -104,9 +117,20 @@ const char *op_names[3] = {
 #define FILEOP_UPDATE_INTERVAL_US   (FILEOP_UPDATE_INTERVAL * G_USEC_PER_SEC)
 #define FILEOP_STALLING_INTERVAL_US (FILEOP_STALLING_INTERVAL * G_USEC_PER_SEC)
 
+/* size of data copied by kernel at once: progress is updated and buttons are checked after it */
+#define FILEOP_KERNEL_COPY_CHUNK (8 * 1024 * 1024)
+
+/* files copied by worker threads: bigger files are copied by copy_file_file() */
+#define COPY_WORKERS_MAX_FILE_SIZE (1024 * 1024)
+/* number of queued files: the main thread waits for workers if there are more */
+#define COPY_WORKERS_MAX_JOBS 256
+
+/* number of files removed by one io_uring batch */
+#define ERASE_BATCH_SIZE 256
+
 /*** file scope type declarations ****************************************************************/
 
-/* This is a hard link cache */
+/* Source and destination of file or directory */
 typedef struct
 {
     const struct vfs_class *vfs;
@@ -117,6 +141,16 @@ typedef struct
     vfs_path_t *dst_vpath;
 } link_t;
 
+/* This is a hard link cache entry: the first copied name of file with several links */
+typedef struct
+{
+    const struct vfs_class *vfs;
+    dev_t dev;
+    ino_t ino;
+    char *src_path;
+    char *dst_path;
+} hardlink_t;
+
 /* Status of the destination file */
 typedef enum
 {
@@ -138,6 +172,24 @@ typedef enum
     HARDLINK_ABORT         // Stop file operation after hardlink creation error
 } hardlink_status_t;
 
+/* File copied by worker thread */
+typedef struct
+{
+    char *src_path;   // for copy_file_file() if worker fails
+    char *dst_path;
+    char *src_local;  // for system calls
+    char *dst_local;
+    off_t size;
+    mode_t src_mode;
+    mode_t mode;  // final mode of target file
+    uid_t uid;
+    gid_t gid;
+    gboolean chown;
+    gboolean attrs;
+    mc_timesbuf_t times;
+    gboolean ok;
+} copy_job_t;
+
 /*
  * This array introduced to avoid translation problems. The former (op_names)
  * is assumed to be nouns, suitable in dialog box titles; this one should
@@ -175,10 +227,13 @@ static const char *prompt_parts[] = {
 
 /*** forward declarations (file scope functions) *************************************************/
 
+static FileProgressStatus recursive_erase_entries_at (file_op_context_t *ctx, int dir_fd,
+                                                      GString *path);
+
 /*** file scope variables ************************************************************************/
 
-/* the hard link cache */
-static GSList *linklist = NULL;
+/* the hard link cache, keyed by hardlink_t */
+static GHashTable *hardlinks = NULL;
 
 /* the files-to-be-erased list */
 static GQueue *erase_list = NULL;
@@ -189,6 +244,24 @@ static GQueue *erase_list = NULL;
  */
 static GSList *dest_dirs = NULL;
 
+/* worker threads copying small files and files copied by them */
+static GThreadPool *copy_workers = NULL;
+static GAsyncQueue *copy_workers_done = NULL;
+static guint copy_workers_pending = 0;
+
+#ifdef ENABLE_URING
+/* ring to remove local files by batches */
+static file_uring_t *erase_uring = NULL;
+#endif
+
+/* scanner of local directories computing totals while files are processed */
+static dir_size_t *totals_scan = NULL;
+static size_t totals_scan_count = 0;
+static uintmax_t totals_scan_bytes = 0;
+
+/* numbers of VFS calls before current operation */
+static guint op_vfs_calls[VFS_CALL_COUNT];
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -329,6 +402,51 @@ free_linklist (GSList *lp)
 
 /* --------------------------------------------------------------------------------------------- */
 
+static guint
+hardlink_hash (gconstpointer v)
+{
+    const hardlink_t *lnk = (const hardlink_t *) v;
+
+    return (guint) lnk->ino ^ (guint) lnk->dev ^ GPOINTER_TO_UINT (lnk->vfs);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+hardlink_equal (gconstpointer v1, gconstpointer v2)
+{
+    const hardlink_t *lnk1 = (const hardlink_t *) v1;
+    const hardlink_t *lnk2 = (const hardlink_t *) v2;
+
+    return lnk1->ino == lnk2->ino && lnk1->dev == lnk2->dev && lnk1->vfs == lnk2->vfs;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+hardlink_free (gpointer data)
+{
+    hardlink_t *lnk = (hardlink_t *) data;
+
+    g_free (lnk->src_path);
+    g_free (lnk->dst_path);
+    g_free (lnk);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+free_hardlinks (void)
+{
+    if (hardlinks != NULL)
+    {
+        g_hash_table_destroy (hardlinks);
+        hardlinks = NULL;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static const link_t *
 is_in_linklist (const GSList *lp, const vfs_path_t *vpath, const struct stat *sb)
 {
@@ -351,134 +469,167 @@ is_in_linklist (const GSList *lp, const vfs_path_t *vpath, const struct stat *sb
 
 /* --------------------------------------------------------------------------------------------- */
 /**
- * Check and made hardlink
+ * Make hardlink to the file copied already.
  *
- * @return FALSE if the inode wasn't found in the cache and TRUE if it was found
- * and a hardlink was successfully made
+ * @param lnk_src_vpath copied source file with the same inode
+ * @param lnk_dst_vpath copy of @lnk_src_vpath
  */
 
 static hardlink_status_t
-check_hardlinks (file_op_context_t *ctx, const vfs_path_t *src_vpath, const struct stat *src_stat,
-                 const vfs_path_t *dst_vpath, gboolean *ignore_all)
+make_hardlink (file_op_context_t *ctx, const vfs_path_t *lnk_src_vpath,
+               const vfs_path_t *lnk_dst_vpath, const vfs_path_t *src_vpath,
+               const struct stat *src_stat, const vfs_path_t *dst_vpath, gboolean *ignore_all)
 {
-    link_t *lnk;
-    ino_t ino = src_stat->st_ino;
-    dev_t dev = src_stat->st_dev;
+    int stat_result;
+    struct stat link_stat;
 
-    if (src_stat->st_nlink < 2)
-        return HARDLINK_NOTLINK;
-    if ((vfs_file_class_flags (src_vpath) & VFSF_NOLINKS) != 0)
-        return HARDLINK_UNSUPPORTED;
+    stat_result = mc_stat (lnk_src_vpath, &link_stat);
 
-    lnk = (link_t *) is_in_linklist (linklist, src_vpath, src_stat);
-    if (lnk != NULL)
+    if (stat_result == 0 && link_stat.st_ino == src_stat->st_ino
+        && link_stat.st_dev == src_stat->st_dev)
     {
-        int stat_result;
-        struct stat link_stat;
+        const struct vfs_class *lp_name_class;
+        const struct vfs_class *my_vfs;
 
-        stat_result = mc_stat (lnk->src_vpath, &link_stat);
+        lp_name_class = vfs_path_get_last_path_vfs (lnk_src_vpath);
+        my_vfs = vfs_path_get_last_path_vfs (src_vpath);
 
-        if (stat_result == 0 && link_stat.st_ino == ino && link_stat.st_dev == dev)
+        if (lp_name_class == my_vfs)
         {
-            const struct vfs_class *lp_name_class;
-            const struct vfs_class *my_vfs;
+            const struct vfs_class *p_class, *dst_name_class;
 
-            lp_name_class = vfs_path_get_last_path_vfs (lnk->src_vpath);
-            my_vfs = vfs_path_get_last_path_vfs (src_vpath);
+            dst_name_class = vfs_path_get_last_path_vfs (dst_vpath);
+            p_class = vfs_path_get_last_path_vfs (lnk_dst_vpath);
 
-            if (lp_name_class == my_vfs)
+            if (dst_name_class == p_class)
             {
-                const struct vfs_class *p_class, *dst_name_class;
-
-                dst_name_class = vfs_path_get_last_path_vfs (dst_vpath);
-                p_class = vfs_path_get_last_path_vfs (lnk->dst_vpath);
+                gboolean ok;
 
-                if (dst_name_class == p_class)
+                while (!(ok = (mc_stat (lnk_dst_vpath, &link_stat) == 0)) && !*ignore_all)
                 {
-                    gboolean ok;
-
-                    while (!(ok = (mc_stat (lnk->dst_vpath, &link_stat) == 0)) && !*ignore_all)
-                    {
-                        FileProgressStatus status;
-
-                        status = file_error (ctx, TRUE, _ ("Cannot stat hardlink source file\n%s"),
-                                             vfs_path_as_str (lnk->dst_vpath));
-                        if (status == FILE_ABORT)
-                            return HARDLINK_ABORT;
-                        if (status == FILE_RETRY)
-                            continue;
-                        if (status == FILE_IGNORE_ALL)
-                            *ignore_all = TRUE;
-                        break;
-                    }
+                    FileProgressStatus status;
 
-                    // if stat() finished unsuccessfully, don't try to create link
-                    if (!ok)
-                        return HARDLINK_ERROR;
+                    status = file_error (ctx, TRUE, _ ("Cannot stat hardlink source file\n%s"),
+                                         vfs_path_as_str (lnk_dst_vpath));
+                    if (status == FILE_ABORT)
+                        return HARDLINK_ABORT;
+                    if (status == FILE_RETRY)
+                        continue;
+                    if (status == FILE_IGNORE_ALL)
+                        *ignore_all = TRUE;
+                    break;
+                }
 
-                    while (!(ok = (mc_link (lnk->dst_vpath, dst_vpath) == 0)) && !*ignore_all)
-                    {
-                        FileProgressStatus status;
+                // if stat() finished unsuccessfully, don't try to create link
+                if (!ok)
+                    return HARDLINK_ERROR;
 
-                        status = file_error (ctx, TRUE, _ ("Cannot create target hardlink\n%s"),
-                                             vfs_path_as_str (dst_vpath));
-                        if (status == FILE_ABORT)
-                            return HARDLINK_ABORT;
-                        if (status == FILE_RETRY)
-                            continue;
-                        if (status == FILE_IGNORE_ALL)
-                            *ignore_all = TRUE;
-                        break;
-                    }
+                while (!(ok = (mc_link (lnk_dst_vpath, dst_vpath) == 0)) && !*ignore_all)
+                {
+                    FileProgressStatus status;
 
-                    // Success?
-                    return (ok ? HARDLINK_OK : HARDLINK_ERROR);
+                    status = file_error (ctx, TRUE, _ ("Cannot create target hardlink\n%s"),
+                                         vfs_path_as_str (dst_vpath));
+                    if (status == FILE_ABORT)
+                        return HARDLINK_ABORT;
+                    if (status == FILE_RETRY)
+                        continue;
+                    if (status == FILE_IGNORE_ALL)
+                        *ignore_all = TRUE;
+                    break;
                 }
+
+                // Success?
+                return (ok ? HARDLINK_OK : HARDLINK_ERROR);
             }
         }
+    }
 
-        if (!*ignore_all)
-        {
-            FileProgressStatus status;
+    if (!*ignore_all)
+    {
+        FileProgressStatus status;
 
-            /* Message w/o "Retry" action.
-             *
-             * FIXME: Can't say what errno is here. Define it and don't display.
-             *
-             * file_error() displays a message with text representation of errno
-             * and the string passed to file_error() should provide the format "%s"
-             * for that at end (see previous file_error() call for the reference).
-             * But if format for errno isn't provided, it is safe, because C standard says:
-             * "If the format is exhausted while arguments remain, the excess arguments
-             * are evaluated (as always) but are otherwise ignored" (ISO/IEC 9899:1999,
-             * section 7.19.6.1, paragraph 2).
-             *
-             */
-            errno = 0;
-            status = file_error (ctx, FALSE, _ ("Cannot create target hardlink\n%s"),
-                                 vfs_path_as_str (dst_vpath));
+        /* Message w/o "Retry" action.
+         *
+         * FIXME: Can't say what errno is here. Define it and don't display.
+         *
+         * file_error() displays a message with text representation of errno
+         * and the string passed to file_error() should provide the format "%s"
+         * for that at end (see previous file_error() call for the reference).
+         * But if format for errno isn't provided, it is safe, because C standard says:
+         * "If the format is exhausted while arguments remain, the excess arguments
+         * are evaluated (as always) but are otherwise ignored" (ISO/IEC 9899:1999,
+         * section 7.19.6.1, paragraph 2).
+         *
+         */
+        errno = 0;
+        status = file_error (ctx, FALSE, _ ("Cannot create target hardlink\n%s"),
+                             vfs_path_as_str (dst_vpath));
 
-            if (status == FILE_ABORT)
-                return HARDLINK_ABORT;
+        if (status == FILE_ABORT)
+            return HARDLINK_ABORT;
 
-            if (status == FILE_IGNORE_ALL)
-                *ignore_all = TRUE;
-        }
+        if (status == FILE_IGNORE_ALL)
+            *ignore_all = TRUE;
+    }
+
+    return HARDLINK_ERROR;
+}
 
-        return HARDLINK_ERROR;
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Check and made hardlink
+ *
+ * @return FALSE if the inode wasn't found in the cache and TRUE if it was found
+ * and a hardlink was successfully made
+ */
+
+static hardlink_status_t
+check_hardlinks (file_op_context_t *ctx, const vfs_path_t *src_vpath, const struct stat *src_stat,
+                 const vfs_path_t *dst_vpath, gboolean *ignore_all)
+{
+    hardlink_t key;
+    hardlink_t *lnk = NULL;
+
+    if (src_stat->st_nlink < 2)
+        return HARDLINK_NOTLINK;
+    if ((vfs_file_class_flags (src_vpath) & VFSF_NOLINKS) != 0)
+        return HARDLINK_UNSUPPORTED;
+
+    key.vfs = vfs_path_get_last_path_vfs (src_vpath);
+    key.dev = src_stat->st_dev;
+    key.ino = src_stat->st_ino;
+
+    if (hardlinks != NULL)
+        lnk = (hardlink_t *) g_hash_table_lookup (hardlinks, &key);
+
+    if (lnk != NULL)
+    {
+        vfs_path_t *lnk_src_vpath, *lnk_dst_vpath;
+        hardlink_status_t status;
+
+        lnk_src_vpath = vfs_path_from_str (lnk->src_path);
+        lnk_dst_vpath = vfs_path_from_str (lnk->dst_path);
+        status = make_hardlink (ctx, lnk_src_vpath, lnk_dst_vpath, src_vpath, src_stat, dst_vpath,
+                                ignore_all);
+        vfs_path_free (lnk_src_vpath, TRUE);
+        vfs_path_free (lnk_dst_vpath, TRUE);
+
+        return status;
     }
 
-    lnk = g_try_new (link_t, 1);
+    if (hardlinks == NULL)
+        hardlinks = g_hash_table_new_full (hardlink_hash, hardlink_equal, hardlink_free, NULL);
+
+    lnk = g_try_new (hardlink_t, 1);
     if (lnk != NULL)
     {
-        lnk->vfs = vfs_path_get_last_path_vfs (src_vpath);
-        lnk->ino = ino;
-        lnk->dev = dev;
-        lnk->st_mode = 0;
-        lnk->src_vpath = vfs_path_clone (src_vpath);
-        lnk->dst_vpath = vfs_path_clone (dst_vpath);
+        *lnk = key;
+        // paths are stored as strings: vfs_path_t is much bigger
+        lnk->src_path = g_strdup (vfs_path_as_str (src_vpath));
+        lnk->dst_path = g_strdup (vfs_path_as_str (dst_vpath));
 
-        linklist = g_slist_prepend (linklist, lnk);
+        g_hash_table_insert (hardlinks, lnk, lnk);
     }
 
     return HARDLINK_CACHED;
@@ -614,6 +765,53 @@ ret:
     return return_status;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Wait for local directories are computed in background, update status every 1/25 second.
+ * @ds is freed.
+ */
+
+static FileProgressStatus
+dir_size_wait_status (dir_size_t *ds, dirsize_status_msg_t *dsm, size_t *dir_count,
+                      size_t *ret_marked, uintmax_t *ret_total)
+{
+    status_msg_t *sm = STATUS_MSG (dsm);
+    size_t ds_dir_count, ds_file_count;
+    uintmax_t ds_total;
+    FileProgressStatus ret = FILE_CONT;
+
+    while (!dir_size_wait (ds, G_USEC_PER_SEC / 25) && ret == FILE_CONT)
+        if (sm->update != NULL)
+        {
+            char *dirname;
+
+            dir_size_get (ds, &ds_dir_count, &ds_file_count, &ds_total, &dirname);
+
+            if (dirname != NULL)
+            {
+                vfs_path_t *tmp_vpath;
+
+                tmp_vpath = vfs_path_from_str (dirname);
+                dsm->dirname_vpath = tmp_vpath;
+                dsm->dir_count = *dir_count + ds_dir_count;
+                dsm->total_size = *ret_total + ds_total;
+                ret = sm->update (sm);
+                dsm->dirname_vpath = NULL;
+                vfs_path_free (tmp_vpath, TRUE);
+                g_free (dirname);
+            }
+        }
+
+    dir_size_get (ds, &ds_dir_count, &ds_file_count, &ds_total, NULL);
+    dir_size_free (ds);
+
+    *dir_count += ds_dir_count;
+    *ret_marked += ds_file_count;
+    *ret_total += ds_total;
+
+    return ret;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /**
  * do_compute_dir_size:
@@ -636,6 +834,16 @@ do_compute_dir_size (const vfs_path_t *dirname_vpath, dirsize_status_msg_t *dsm,
     struct vfs_dirent *dirent;
     FileProgressStatus ret = FILE_CONT;
 
+    if (vfs_file_is_local (dirname_vpath))
+    {
+        dir_size_t *ds;
+
+        // local directories are read by several threads
+        ds = dir_size_new (stat_func == mc_stat);
+        dir_size_add (ds, vfs_path_get_last_path_str (dirname_vpath));
+        return dir_size_wait_status (ds, dsm, dir_count, ret_marked, ret_total);
+    }
+
     (*dir_count)++;
 
     dir = mc_opendir (dirname_vpath);
@@ -733,6 +941,120 @@ panel_compute_totals (const WPanel *panel, dirsize_status_msg_t *sm, size_t *ret
 
 /* --------------------------------------------------------------------------------------------- */
 
+static void
+totals_scan_free (void)
+{
+    dir_size_free (totals_scan);
+    totals_scan = NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Start computing of totals of local files without waiting for result.  Files are processed
+ * at the same time, totals of ctx are refined by totals_scan_update().
+ *
+ * @return FALSE if files are not local and totals should be computed before processing
+ */
+
+static gboolean
+totals_scan_start (const WPanel *panel, const vfs_path_t *source, gboolean source_is_dir,
+                   const struct stat *source_stat, file_op_context_t *ctx)
+{
+    totals_scan_free ();
+    totals_scan_count = 0;
+    totals_scan_bytes = 0;
+
+    if (source == NULL)
+    {
+        int i;
+
+        if (!vfs_file_is_local (panel->cwd_vpath))
+            return FALSE;
+
+        totals_scan = dir_size_new (ctx->follow_links);
+
+        for (i = 0; i < panel->dir.len; i++)
+        {
+            const file_entry_t *fe = &panel->dir.list[i];
+
+            if (fe->f.marked == 0)
+                continue;
+
+            if (S_ISDIR (fe->st.st_mode)
+                || (ctx->follow_links && link_isdir (fe) && fe->f.stale_link == 0))
+            {
+                vfs_path_t *p;
+
+                p = vfs_path_append_new (panel->cwd_vpath, fe->fname->str, (char *) NULL);
+                dir_size_add (totals_scan, vfs_path_get_last_path_str (p));
+                vfs_path_free (p, TRUE);
+            }
+            else
+            {
+                totals_scan_count++;
+                totals_scan_bytes += (uintmax_t) fe->st.st_size;
+            }
+        }
+    }
+    else if (!source_is_dir)
+    {
+        // nothing to scan
+        totals_scan_count = 1;
+        totals_scan_bytes = (uintmax_t) source_stat->st_size;
+    }
+    else
+    {
+        if (!vfs_file_is_local (source))
+            return FALSE;
+
+        totals_scan = dir_size_new (ctx->stat_func == mc_stat);
+        dir_size_add (totals_scan, vfs_path_get_last_path_str (source));
+    }
+
+    ctx->total_count = totals_scan_count;
+    ctx->total_bytes = totals_scan_bytes;
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Refine totals by result of scanner.  Until the scanner is finished, totals are not less than
+ * already processed files.
+ *
+ * @param copied_bytes processed bytes including the current file
+ */
+
+static void
+totals_scan_update (file_op_context_t *ctx, uintmax_t copied_bytes)
+{
+    size_t dir_count, file_count;
+    uintmax_t total;
+    gboolean done;
+
+    if (totals_scan == NULL)
+        return;
+
+    // if scanner cannot read some directories, its result is a lower bound only:
+    // files of them can be processed anyway
+    done = dir_size_wait (totals_scan, 0) && dir_size_get_skipped (totals_scan) == 0;
+    dir_size_get (totals_scan, &dir_count, &file_count, &total, NULL);
+
+    if (done)
+    {
+        totals_scan_free ();
+        ctx->total_count = totals_scan_count + file_count;
+        ctx->total_bytes = totals_scan_bytes + total;
+    }
+    else
+    {
+        ctx->total_count = MAX (totals_scan_count + file_count, ctx->total_progress_count);
+        ctx->total_bytes = MAX (totals_scan_bytes + total, copied_bytes);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 /** Initialize variables for progress bars */
 static FileProgressStatus
 panel_operate_init_totals (const WPanel *panel, const vfs_path_t *source,
@@ -748,46 +1070,56 @@ panel_operate_init_totals (const WPanel *panel, const vfs_path_t *source,
 
     if (verbose && compute_totals)
     {
-        dirsize_status_msg_t dsm;
         gboolean stale_link = FALSE;
+        gboolean source_is_dir;
 
-        memset (&dsm, 0, sizeof (dsm));
-        dsm.allow_skip = TRUE;
-        status_msg_init (STATUS_MSG (&dsm), _ ("Directory scanning"), 0, dirsize_status_init_cb,
-                         dirsize_status_update_cb, dirsize_status_deinit_cb);
+        source_is_dir = source != NULL
+            && (S_ISDIR (source_stat->st_mode)
+                || (ctx->follow_links
+                    && file_is_symlink_to_dir (source, (struct stat *) source_stat, &stale_link)
+                    && !stale_link));
 
-        ctx->total_count = 0;
-        ctx->total_bytes = 0;
-
-        if (source == NULL)
-            status = panel_compute_totals (panel, &dsm, &ctx->total_count, &ctx->total_bytes,
-                                           ctx->follow_links);
-        else if (S_ISDIR (source_stat->st_mode)
-                 || (ctx->follow_links
-                     && file_is_symlink_to_dir (source, (struct stat *) source_stat, &stale_link)
-                     && !stale_link))
+        // copying of local files is not delayed by scanning of large trees
+        if (totals_scan_start (panel, source, source_is_dir, source_stat, ctx))
         {
-            size_t dir_count = 0;
-
-            status = do_compute_dir_size (source, &dsm, &dir_count, &ctx->total_count,
-                                          &ctx->total_bytes, ctx->stat_func);
+            status = FILE_CONT;
+            ctx->totals_computed = TRUE;
         }
         else
         {
-            ctx->total_count++;
-            ctx->total_bytes += (uintmax_t) source_stat->st_size;
-            status = FILE_CONT;
-        }
+            dirsize_status_msg_t dsm;
 
-        status_msg_deinit (STATUS_MSG (&dsm));
+            memset (&dsm, 0, sizeof (dsm));
+            dsm.allow_skip = TRUE;
+            status_msg_init (STATUS_MSG (&dsm), _ ("Directory scanning"), 0,
+                             dirsize_status_init_cb, dirsize_status_update_cb,
+                             dirsize_status_deinit_cb);
 
-        ctx->totals_computed = (status == FILE_CONT);
+            ctx->total_count = 0;
+            ctx->total_bytes = 0;
 
-        if (status == FILE_SKIP)
-            status = FILE_CONT;
+            if (source == NULL)
+                status = panel_compute_totals (panel, &dsm, &ctx->total_count, &ctx->total_bytes,
+                                               ctx->follow_links);
+            else
+            {
+                size_t dir_count = 0;
+
+                status = do_compute_dir_size (source, &dsm, &dir_count, &ctx->total_count,
+                                              &ctx->total_bytes, ctx->stat_func);
+            }
+
+            status_msg_deinit (STATUS_MSG (&dsm));
+
+            ctx->totals_computed = (status == FILE_CONT);
+
+            if (status == FILE_SKIP)
+                status = FILE_CONT;
+        }
     }
     else
     {
+        totals_scan_free ();
         status = FILE_CONT;
         ctx->total_count = panel->marked;
         ctx->total_bytes = panel->total;
@@ -822,6 +1154,8 @@ progress_update_one (gboolean success, file_op_context_t *ctx, off_t add)
         tv_start = tv_current;
     else if (tv_current - tv_start > FILEOP_UPDATE_INTERVAL_US)
     {
+        totals_scan_update (ctx, ctx->total_progress_bytes);
+
         if (verbose && ctx->dialog_type == FILEGUI_DIALOG_MULTI_ITEM)
         {
             file_progress_show_count (ctx);
@@ -1388,6 +1722,7 @@ erase_file (file_op_context_t *ctx, const vfs_path_t *vpath)
     // check buttons if deleting info was changed
     if (file_progress_show_deleting (ctx, vpath, &ctx->total_progress_count))
     {
+        totals_scan_update (ctx, 0);
         file_progress_show_count (ctx);
         if (file_progress_check_buttons (ctx) == FILE_ABORT)
             return FILE_ABORT;
@@ -1434,6 +1769,249 @@ try_erase_dir (file_op_context_t *ctx, const vfs_path_t *vpath)
 
 /* --------------------------------------------------------------------------------------------- */
 
+#ifdef ENABLE_URING
+static file_uring_t *
+erase_uring_get (void)
+{
+    static gboolean unsupported = FALSE;
+
+    if (erase_uring == NULL && !unsupported)
+    {
+        erase_uring = file_uring_new (ERASE_BATCH_SIZE);
+        unsupported = erase_uring == NULL;
+    }
+
+    return erase_uring;
+}
+#endif
+
+/* --------------------------------------------------------------------------------------------- */
+
+static FileProgressStatus
+erase_progress_at (file_op_context_t *ctx, const char *path, gboolean is_dir)
+{
+    if (file_progress_show_deleting_path (ctx, path, is_dir ? NULL : &ctx->total_progress_count))
+    {
+        totals_scan_update (ctx, 0);
+        file_progress_show_count (ctx);
+        if (file_progress_check_buttons (ctx) == FILE_ABORT)
+            return FILE_ABORT;
+
+        mc_refresh ();
+    }
+
+    return FILE_CONT;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Remove entry of local directory relative to its descriptor.  If entry cannot be removed,
+ * its path is used to ask the user.
+ *
+ * @param path path of the entry
+ */
+
+static FileProgressStatus
+erase_entry_at (file_op_context_t *ctx, int dir_fd, const char *name, gboolean is_dir,
+                const char *path)
+{
+    vfs_path_t *vpath;
+    FileProgressStatus return_status = FILE_CONT;
+
+    if (erase_progress_at (ctx, path, is_dir) == FILE_ABORT)
+        return FILE_ABORT;
+
+    if (unlinkat (dir_fd, name, is_dir ? AT_REMOVEDIR : 0) == 0)
+        return FILE_CONT;
+
+    vpath = vfs_path_from_str (path);
+    if (is_dir)
+        return_status = try_erase_dir (ctx, vpath);
+    else if (try_remove_file (ctx, vpath, &return_status) || return_status != FILE_ABORT)
+        return_status = FILE_CONT;
+    vfs_path_free (vpath, TRUE);
+
+    return return_status;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Remove subdirectory of local directory relative to its descriptor.
+ *
+ * @param path path of the subdirectory
+ */
+
+static FileProgressStatus
+recursive_erase_dir_at (file_op_context_t *ctx, int dir_fd, const char *name, GString *path)
+{
+    FileProgressStatus return_status;
+    int fd;
+
+    fd = openat (dir_fd, name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    return_status = fd == -1 ? FILE_RETRY : recursive_erase_entries_at (ctx, fd, path);
+
+    if (return_status != FILE_ABORT)
+        return_status = erase_entry_at (ctx, dir_fd, name, TRUE, path->str);
+
+    return return_status;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+erase_path_append (GString *path, gsize len, const char *name)
+{
+    if (len == 0 || path->str[len - 1] != PATH_SEP)
+        g_string_append_c (path, PATH_SEP);
+    g_string_append (path, name);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+#ifdef ENABLE_URING
+/**
+ * Remove batch of files of local directory by io_uring.  Files which cannot be removed by
+ * the batch are removed by erase_entry_at() to report the error.
+ *
+ * @param path path of directory, names of entries are appended temporarily
+ */
+
+static FileProgressStatus
+recursive_erase_batch_at (file_op_context_t *ctx, int dir_fd, GPtrArray *names, GString *path)
+{
+    int results[ERASE_BATCH_SIZE];
+    const gsize len = path->len;
+    FileProgressStatus return_status = FILE_CONT;
+    guint i;
+
+    file_uring_unlinkat (erase_uring, dir_fd, (char *const *) names->pdata, results, names->len);
+
+    for (i = 0; i < names->len && return_status != FILE_ABORT; i++)
+    {
+        const char *name = (const char *) g_ptr_array_index (names, i);
+
+        erase_path_append (path, len, name);
+
+        if (results[i] == 0)
+            return_status = erase_progress_at (ctx, path->str, FALSE);
+        else if (results[i] == -EISDIR)
+            // file is replaced by directory after it was read
+            return_status = recursive_erase_dir_at (ctx, dir_fd, name, path);
+        else
+            return_status = erase_entry_at (ctx, dir_fd, name, FALSE, path->str);
+
+        g_string_truncate (path, len);
+    }
+
+    g_ptr_array_set_size (names, 0);
+
+    return return_status;
+}
+#endif
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Remove entries of local directory relative to its descriptor.  Paths of entries are not
+ * resolved by the kernel again and again: only one component is looked up for every entry.
+ * Files are removed by io_uring batches if it is available.
+ *
+ * @param dir_fd descriptor of directory, closed by this function
+ * @param path path of directory, names of entries are appended temporarily
+ */
+
+static FileProgressStatus
+recursive_erase_entries_at (file_op_context_t *ctx, int dir_fd, GString *path)
+{
+    DIR *reading;
+    struct dirent *next;
+    const gsize len = path->len;
+    FileProgressStatus return_status = FILE_CONT;
+#ifdef ENABLE_URING
+    GPtrArray *names = NULL;
+#endif
+
+    reading = fdopendir (dir_fd);
+    if (reading == NULL)
+    {
+        close (dir_fd);
+        return FILE_RETRY;
+    }
+
+#ifdef ENABLE_URING
+    if (erase_uring != NULL)
+        names = g_ptr_array_new_full (ERASE_BATCH_SIZE, g_free);
+#endif
+
+    while (return_status != FILE_ABORT && (next = readdir (reading)) != NULL)
+    {
+        gboolean is_dir;
+
+        if (DIR_IS_DOT (next->d_name) || DIR_IS_DOTDOT (next->d_name))
+            continue;
+
+        is_dir = dir_erase_entry_is_dir (dir_fd, next);
+
+#ifdef ENABLE_URING
+        if (!is_dir && names != NULL)
+        {
+            g_ptr_array_add (names, g_strdup (next->d_name));
+            if (names->len == ERASE_BATCH_SIZE)
+                return_status = recursive_erase_batch_at (ctx, dir_fd, names, path);
+            continue;
+        }
+#endif
+
+        erase_path_append (path, len, next->d_name);
+
+        if (is_dir)
+            return_status = recursive_erase_dir_at (ctx, dir_fd, next->d_name, path);
+        else
+            return_status = erase_entry_at (ctx, dir_fd, next->d_name, FALSE, path->str);
+
+        g_string_truncate (path, len);
+    }
+
+#ifdef ENABLE_URING
+    if (names != NULL)
+    {
+        if (return_status != FILE_ABORT && names->len != 0)
+            return_status = recursive_erase_batch_at (ctx, dir_fd, names, path);
+        g_ptr_array_free (names, TRUE);
+    }
+#endif
+
+    closedir (reading);
+
+    return return_status;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static FileProgressStatus
+recursive_erase_entries_local (file_op_context_t *ctx, const vfs_path_t *vpath)
+{
+    int dir_fd;
+    GString *path;
+    FileProgressStatus return_status;
+
+#ifdef ENABLE_URING
+    (void) erase_uring_get ();
+#endif
+
+    dir_fd = open (vfs_path_get_last_path_str (vpath),
+                   O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    if (dir_fd == -1)
+        return FILE_RETRY;
+
+    path = g_string_new (vfs_path_as_str (vpath));
+    return_status = recursive_erase_entries_at (ctx, dir_fd, path);
+    g_string_free (path, TRUE);
+
+    return return_status;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 /**
   Recursive removal of files
   abort -> cancel stack
@@ -1447,44 +2025,95 @@ recursive_erase (file_op_context_t *ctx, const vfs_path_t *vpath)
     DIR *reading;
     FileProgressStatus return_status = FILE_CONT;
 
-    reading = mc_opendir (vpath);
-    if (reading == NULL)
-        return FILE_RETRY;
-
-    while ((next = mc_readdir (reading)) && return_status != FILE_ABORT)
+    if (vfs_file_is_local (vpath))
+        return_status = recursive_erase_entries_local (ctx, vpath);
+    else
     {
-        vfs_path_t *tmp_vpath;
-        struct stat buf;
-
-        if (DIR_IS_DOT (next->d_name) || DIR_IS_DOTDOT (next->d_name))
-            continue;
+        reading = mc_opendir (vpath);
+        if (reading == NULL)
+            return FILE_RETRY;
 
-        tmp_vpath = vfs_path_append_new (vpath, next->d_name, (char *) NULL);
-        if (mc_lstat (tmp_vpath, &buf) != 0)
+        while ((next = mc_readdir (reading)) && return_status != FILE_ABORT)
         {
-            mc_closedir (reading);
+            vfs_path_t *tmp_vpath;
+            struct stat buf;
+
+            if (DIR_IS_DOT (next->d_name) || DIR_IS_DOTDOT (next->d_name))
+                continue;
+
+            tmp_vpath = vfs_path_append_new (vpath, next->d_name, (char *) NULL);
+            if (mc_lstat (tmp_vpath, &buf) != 0)
+            {
+                mc_closedir (reading);
+                vfs_path_free (tmp_vpath, TRUE);
+                return FILE_RETRY;
+            }
+            if (S_ISDIR (buf.st_mode))
+                return_status = recursive_erase (ctx, tmp_vpath);
+            else
+                return_status = erase_file (ctx, tmp_vpath);
             vfs_path_free (tmp_vpath, TRUE);
-            return FILE_RETRY;
         }
-        if (S_ISDIR (buf.st_mode))
-            return_status = recursive_erase (ctx, tmp_vpath);
-        else
-            return_status = erase_file (ctx, tmp_vpath);
-        vfs_path_free (tmp_vpath, TRUE);
+        mc_closedir (reading);
     }
-    mc_closedir (reading);
 
-    if (return_status == FILE_ABORT)
-        return FILE_ABORT;
+    if (return_status == FILE_ABORT)
+        return FILE_ABORT;
+
+    file_progress_show_deleting (ctx, vpath, NULL);
+    file_progress_show_count (ctx);
+    if (file_progress_check_buttons (ctx) == FILE_ABORT)
+        return FILE_ABORT;
+
+    mc_refresh ();
+
+    return try_erase_dir (ctx, vpath);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Remove files of local directory tree by several threads.  Errors are not reported here:
+ * the rest of tree is removed by recursive_erase() after that.
+ */
+
+static FileProgressStatus
+erase_dir_workers (file_op_context_t *ctx, const vfs_path_t *vpath)
+{
+    dir_erase_t *de;
+    size_t file_count = 0;
+    const size_t progress_count = ctx->total_progress_count;
+    FileProgressStatus return_status = FILE_CONT;
+
+    if (file_op_erase_workers < 2 || !vfs_file_is_local (vpath))
+        return FILE_CONT;
+
+    de = dir_erase_new (MIN (file_op_erase_workers, 64));
+    dir_erase_add (de, vfs_path_get_last_path_str (vpath));
+
+    while (return_status != FILE_ABORT && !dir_erase_wait (de, G_USEC_PER_SEC / 25))
+    {
+        char *dirname;
+
+        dir_erase_get (de, &file_count, &dirname);
+        ctx->total_progress_count = progress_count + file_count;
 
-    file_progress_show_deleting (ctx, vpath, NULL);
-    file_progress_show_count (ctx);
-    if (file_progress_check_buttons (ctx) == FILE_ABORT)
-        return FILE_ABORT;
+        if (dirname != NULL)
+        {
+            file_progress_show_deleting_path (ctx, dirname, NULL);
+            g_free (dirname);
+        }
 
-    mc_refresh ();
+        totals_scan_update (ctx, 0);
+        file_progress_show_count (ctx);
+        return_status = file_progress_check_buttons (ctx);
+        mc_refresh ();
+    }
 
-    return try_erase_dir (ctx, vpath);
+    dir_erase_get (de, &file_count, NULL);
+    dir_erase_free (de);
+    ctx->total_progress_count = progress_count + file_count;
+
+    return return_status == FILE_ABORT ? FILE_ABORT : FILE_CONT;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -1556,6 +2185,11 @@ erase_dir_iff_empty (file_op_context_t *ctx, const vfs_path_t *vpath)
 
     mc_refresh ();
 
+    // local directory is not read: rmdir() fails if it is not empty
+    if (vfs_file_is_local (vpath)
+        && (mc_rmdir (vpath) == 0 || errno == ENOTEMPTY || errno == EEXIST))
+        return FILE_CONT;
+
     const int res = check_dir_is_empty (ctx, vpath, &error);
 
     if (res == -1)
@@ -2201,6 +2835,48 @@ operate_one_file (const WPanel *panel, file_op_context_t *ctx, const char *src,
     return value;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Write performance counters of finished operation to the log file, see mc_log().
+ * System calls made by worker threads are not counted.
+ */
+
+static void
+file_op_log_stats (const file_op_context_t *ctx)
+{
+    guint calls[VFS_CALL_COUNT];
+    guint total_calls = 0;
+    const size_t files = ctx->total_progress_count;
+    struct rusage usage;
+    long max_rss = 0;
+    double dt;
+    int i;
+
+    vfs_calls_get (calls);
+    for (i = 0; i < VFS_CALL_COUNT; i++)
+    {
+        calls[i] -= op_vfs_calls[i];
+        total_calls += calls[i];
+    }
+
+    dt = (g_get_monotonic_time () - ctx->pauses - ctx->total_transfer_start)
+        / (double) G_USEC_PER_SEC;
+    dt = MAX (dt, 0.001);
+
+    // kilobytes on Linux and BSD
+    if (getrusage (RUSAGE_SELF, &usage) == 0)
+        max_rss = usage.ru_maxrss;
+
+    mc_log ("%s: %zu files, %ju bytes in %.3f s: %.1f files/s, %.2f MB/s, max RSS %ld KiB\n"
+            "  VFS calls: %u open, %u read, %u write, %u stat, %u dir, %u other,"
+            " %.1f per file\n",
+            op_names[ctx->operation], files, ctx->total_progress_bytes, dt, files / dt,
+            ctx->total_progress_bytes / dt / (1024 * 1024), max_rss, calls[VFS_CALL_OPEN],
+            calls[VFS_CALL_READ], calls[VFS_CALL_WRITE], calls[VFS_CALL_STAT],
+            calls[VFS_CALL_DIR], calls[VFS_CALL_OTHER],
+            (double) total_calls / MAX (files, (size_t) 1));
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 #ifdef ENABLE_BACKGROUND
@@ -2232,6 +2908,306 @@ attrs_ignore_error (const int e)
             || e == ELOOP || e == ENXIO);
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/* {{{ Parallel copy of small files */
+
+static gboolean
+copy_job_copy_data (int src_fd, int dst_fd)
+{
+    char *buf;
+    ssize_t n;
+
+#ifdef HAVE_COPY_FILE_RANGE
+    // errors and end of file are confirmed by read() and write() below
+    while (copy_file_range (src_fd, NULL, dst_fd, NULL, COPY_WORKERS_MAX_FILE_SIZE, 0) > 0)
+        ;
+#endif
+
+    buf = g_malloc (BUF_LARGE * 8);
+
+    while ((n = read (src_fd, buf, BUF_LARGE * 8)) != 0)
+    {
+        const char *t = buf;
+
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0)
+            break;
+
+        while (n > 0)
+        {
+            ssize_t n_written;
+
+            n_written = write (dst_fd, t, (size_t) n);
+            if (n_written < 0 && errno == EINTR)
+                continue;
+            if (n_written <= 0)
+                break;
+
+            t += n_written;
+            n -= n_written;
+        }
+
+        if (n != 0)
+            break;
+    }
+
+    g_free (buf);
+
+    return (n == 0);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Copy file in worker thread.  Only system calls are used here: neither VFS nor screen is
+ * thread safe.  Errors are not reported: failed file is copied again by the main thread.
+ */
+
+static void
+copy_job_run (gpointer data, gpointer user_data)
+{
+    copy_job_t *job = (copy_job_t *) data;
+    int src_fd, dst_fd = -1;
+
+    (void) user_data;
+
+    job->ok = FALSE;
+
+    src_fd = open (job->src_local, O_RDONLY);
+    if (src_fd != -1)
+        dst_fd = open (job->dst_local, O_WRONLY | O_CREAT | O_EXCL, job->src_mode);
+
+    if (dst_fd != -1)
+    {
+        job->ok = copy_job_copy_data (src_fd, dst_fd)
+            && (!job->chown || fchown (dst_fd, job->uid, job->gid) == 0)
+            && fchmod (dst_fd, job->mode) == 0;
+
+#ifdef HAVE_UTIMENSAT
+        (void) futimens (dst_fd, job->times);
+#endif
+
+        if (close (dst_fd) != 0)
+            job->ok = FALSE;
+
+#ifndef HAVE_UTIMENSAT
+        (void) utime (job->dst_local, &job->times);
+#endif
+
+#ifdef ENABLE_EXT2FS_ATTR
+        if (job->ok && job->attrs)
+        {
+            unsigned long flags;
+
+            if (fgetflags (job->src_local, &flags) != 0)
+                job->ok = attrs_ignore_error (errno);
+            else if (fsetflags (job->dst_local, flags) != 0)
+                job->ok = attrs_ignore_error (errno);
+        }
+#endif
+
+        // file is created by us
+        if (!job->ok)
+            (void) unlink (job->dst_local);
+    }
+
+    if (src_fd != -1)
+        close (src_fd);
+
+    g_async_queue_push (copy_workers_done, job);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+copy_job_free (copy_job_t *job)
+{
+    g_free (job->src_path);
+    g_free (job->dst_path);
+    g_free (job->src_local);
+    g_free (job->dst_local);
+    g_free (job);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Account files copied by workers.  Failed files are copied again by copy_file_file() to show
+ * errors and ask user.
+ *
+ * @param wait_all wait for all queued files, otherwise only for the queue not to be too long
+ * @param status   status of operation: failed files are not copied again if it is aborted
+ *
+ * @return FILE_ABORT if operation was aborted, @status otherwise
+ */
+
+static FileProgressStatus
+copy_workers_process (file_op_context_t *ctx, gboolean wait_all, FileProgressStatus status)
+{
+    while (copy_workers_pending != 0)
+    {
+        copy_job_t *job;
+
+        if (wait_all || copy_workers_pending >= COPY_WORKERS_MAX_JOBS)
+            job = (copy_job_t *) g_async_queue_pop (copy_workers_done);
+        else
+            job = (copy_job_t *) g_async_queue_try_pop (copy_workers_done);
+
+        if (job == NULL)
+            break;
+
+        copy_workers_pending--;
+
+        if (job->ok)
+            progress_update_one (TRUE, ctx, job->size);
+        else if (status != FILE_ABORT
+                 && copy_file_file (ctx, job->src_path, job->dst_path) == FILE_ABORT)
+            status = FILE_ABORT;
+
+        copy_job_free (job);
+    }
+
+    return status;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Queue small regular file to be copied by worker thread.  Only new local files are copied
+ * this way: there is nothing to ask user about.
+ *
+ * @return TRUE if file is queued or operation is aborted (see @status), FALSE if file should be
+ *         copied by copy_file_file()
+ */
+
+static gboolean
+copy_file_file_parallel (file_op_context_t *ctx, const vfs_path_t *src_vpath,
+                         const struct stat *src_stat, const char *dst_path,
+                         FileProgressStatus *status)
+{
+    vfs_path_t *dst_vpath;
+    struct stat dst_stat;
+    copy_job_t *job;
+
+    if (file_op_copy_workers < 2 || !S_ISREG (src_stat->st_mode) || src_stat->st_nlink > 1
+        || src_stat->st_size > COPY_WORKERS_MAX_FILE_SIZE || !vfs_file_is_local (src_vpath))
+        return FALSE;
+
+    dst_vpath = vfs_path_from_str (dst_path);
+
+    if (!vfs_file_is_local (dst_vpath) || mc_lstat (dst_vpath, &dst_stat) == 0 || errno != ENOENT)
+    {
+        vfs_path_free (dst_vpath, TRUE);
+        return FALSE;
+    }
+
+    file_progress_show_source (ctx, src_vpath);
+    file_progress_show_target (ctx, dst_vpath);
+
+    if (file_progress_check_buttons (ctx) == FILE_ABORT)
+    {
+        vfs_path_free (dst_vpath, TRUE);
+        *status = FILE_ABORT;
+        return TRUE;
+    }
+
+    if (copy_workers == NULL)
+    {
+        copy_workers_done = g_async_queue_new ();
+        copy_workers = g_thread_pool_new (copy_job_run, NULL, MIN (file_op_copy_workers, 64),
+                                          FALSE, NULL);
+    }
+
+    job = g_new0 (copy_job_t, 1);
+    job->src_path = g_strdup (vfs_path_as_str (src_vpath));
+    job->dst_path = g_strdup (dst_path);
+    job->src_local = g_strdup (vfs_path_get_last_path_str (src_vpath));
+    job->dst_local = g_strdup (vfs_path_get_last_path_str (dst_vpath));
+    job->size = src_stat->st_size;
+    job->src_mode = src_stat->st_mode;
+    job->uid = src_stat->st_uid;
+    job->gid = src_stat->st_gid;
+    job->chown = ctx->preserve_uidgid;
+    job->attrs = copymove_persistent_ext2_attr;
+    vfs_get_timesbuf_from_stat (src_stat, &job->times);
+
+    if (ctx->preserve)
+        job->mode = src_stat->st_mode & ctx->umask_kill;
+    else
+    {
+        // the same as copy_file_file() does
+        mode_t mode;
+
+        mode = umask (-1);
+        umask (mode);
+        job->mode = (0100666 & ~mode) & ctx->umask_kill;
+    }
+
+    vfs_path_free (dst_vpath, TRUE);
+
+    g_thread_pool_push (copy_workers, job, NULL);
+    copy_workers_pending++;
+
+    *status = copy_workers_process (ctx, FALSE, FILE_CONT);
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+copy_workers_free (void)
+{
+    if (copy_workers != NULL)
+    {
+        g_thread_pool_free (copy_workers, FALSE, TRUE);
+        copy_workers = NULL;
+        g_async_queue_unref (copy_workers_done);
+        copy_workers_done = NULL;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Wait for target file to be written in background and report write errors the same way
+ * as copy_file_file() does for mc_write().
+ *
+ * @param all wait for all buffers are written, otherwise only for free buffer
+ *
+ * @return FILE_CONT if copying can be continued, status to stop copying otherwise
+ */
+
+static FileProgressStatus
+copy_writer_process (file_op_context_t *ctx, copy_writer_t *writer, gboolean all,
+                     const char *dst_path)
+{
+    int error;
+
+    while ((error = copy_writer_wait (writer, all)) != 0)
+    {
+        FileProgressStatus status;
+
+        errno = error;
+
+        if (ctx->ignore_all)
+            status = FILE_IGNORE_ALL;
+        else
+            status = file_error (ctx, TRUE, _ ("Cannot write target file\n%s"), dst_path);
+
+        if (status == FILE_RETRY)
+            copy_writer_continue (writer, FALSE);
+        else if (status == FILE_IGNORE && error != ENOSPC)
+            copy_writer_continue (writer, TRUE);
+        else
+        {
+            if (status == FILE_IGNORE_ALL)
+                ctx->ignore_all = TRUE;
+            return status;
+        }
+    }
+
+    return FILE_CONT;
+}
+
+/* }}} */
+
 /* --------------------------------------------------------------------------------------------- */
 /*** public functions ****************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -2291,12 +3267,15 @@ copy_file_file (file_op_context_t *ctx, const char *src_path, const char *dst_pa
     unsigned long attrs = 0;
     gboolean attrs_ok = copymove_persistent_ext2_attr;
     gboolean dst_exists = FALSE, appending = FALSE;
+    gboolean sparse = FALSE;
     off_t file_size = -1;
     FileProgressStatus return_status, temp_status;
     dest_status_t dst_status = DEST_NONE;
     int open_flags;
     vfs_path_t *src_vpath = NULL, *dst_vpath = NULL;
     char *buf = NULL;
+    copy_reader_t *reader = NULL;
+    copy_writer_t *writer = NULL;
 
     /* Keep the non-default value applied in chain of calls:
        move_file_file() -> file_progress_real_query_replace()
@@ -2651,8 +3630,14 @@ copy_file_file (file_op_context_t *ctx, const char *src_path, const char *dst_pa
         goto ret;
     }
 
+#ifdef HAVE_STRUCT_STAT_ST_BLOCKS
+    // holes of sparse file are skipped, so the target file is sparse as well
+    sparse = !appending && (off_t) src_stat.st_blocks * 512 < file_size
+        && vfs_file_is_local (dst_vpath);
+#endif
+
     // try preallocate space; if fail, try copy anyway
-    while (mc_global.vfs.preallocate_space
+    while (mc_global.vfs.preallocate_space && !sparse
            && vfs_preallocate (dest_desc, file_size, appending ? dst_stat.st_size : 0) != 0)
     {
         if (ctx->ignore_all)
@@ -2704,29 +3689,134 @@ copy_file_file (file_op_context_t *ctx, const char *src_path, const char *dst_pa
     if (return_status == FILE_CONT)
     {
         off_t file_part = 0;
+        off_t data_left = 0;  // size of data before next hole of sparse file
         gint64 tv_last_update = ctx->transfer_start;
         gint64 tv_last_input = 0;
         gboolean is_first_time = TRUE;
+        // O_APPEND is not supported by copy_file_range() and sendfile()
+        vfs_copy_data_t copy_method = appending ? VFS_COPY_DATA_NONE : VFS_COPY_DATA_RANGE;
 
         const size_t bufsize = io_blksize (dst_stat);
-        buf = g_malloc (bufsize);
+
+        /* Local and non-local files: overlap latencies of source and destination.  VFS is not
+           thread-safe, so only the local file is accessed in background, by its own descriptor:
+           the local source is read while the main thread writes, the local target is written
+           while the main thread reads */
+        if (!sparse && file_size - ctx->do_reget > (off_t) bufsize
+            && vfs_file_is_local (src_vpath) != vfs_file_is_local (dst_vpath))
+        {
+            int fd;
+
+            fd = vfs_dup_local_fd (src_desc);
+            if (fd != -1)
+                reader = copy_reader_new (fd, mc_lseek (src_desc, 0, SEEK_CUR), bufsize);
+            else
+            {
+                fd = vfs_dup_local_fd (dest_desc);
+                if (fd != -1)
+                    writer = copy_writer_new (fd, bufsize);
+            }
+        }
+
+        if (reader != NULL || writer != NULL)
+            copy_method = VFS_COPY_DATA_NONE;
+        else
+            buf = g_malloc (bufsize);
 
         while (TRUE)
         {
             ssize_t n_read = -1;
+            gboolean copied = FALSE;
+            char *data = buf;
+            size_t chunk = FILEOP_KERNEL_COPY_CHUNK;
+            size_t read_size = bufsize;
+
+            if (sparse && data_left == 0)
+            {
+                off_t hole;
+
+                hole = vfs_skip_hole (dest_desc, src_desc, &data_left);
+                if (hole == -1)
+                    // copy the rest of file with holes
+                    sparse = FALSE;
+                else
+                    file_part += hole;
+            }
+
+            if (sparse)
+            {
+                // don't read hole after data
+                chunk = (size_t) MIN ((off_t) chunk, data_left);
+                read_size = (size_t) MIN ((off_t) read_size, data_left);
+            }
 
-            // src_read
-            if (mc_ctl (src_desc, VFS_CTL_IS_NOTREADY, 0) == 0)
-                while ((n_read = mc_read (src_desc, buf, bufsize)) < 0 && !ctx->ignore_all)
+            if (copy_method != VFS_COPY_DATA_NONE)
+            {
+                // local files: data is copied by kernel, e.g. server-side on NFS 4.2
+                n_read = vfs_copy_data (dest_desc, src_desc, chunk, &copy_method);
+                if (n_read <= 0)
+                {
+                    /* Use mc_read() and mc_write() for the rest of file: they report errors and
+                       confirm end of file */
+                    copy_method = VFS_COPY_DATA_NONE;
+                    continue;
+                }
+
+                copied = TRUE;
+            }
+            else if (reader != NULL)
+            {
+                int read_error;
+
+                // src_read: data has been read in background
+                while ((n_read = copy_reader_get (reader, &data, &read_error)) < 0
+                       && !ctx->ignore_all)
                 {
+                    errno = read_error;
                     return_status =
                         file_error (ctx, TRUE, _ ("Cannot read source file\n%s"), src_path);
                     if (return_status == FILE_RETRY)
+                    {
+                        copy_reader_release (reader);
                         continue;
+                    }
                     if (return_status == FILE_IGNORE_ALL)
                         ctx->ignore_all = TRUE;
                     goto ret;
                 }
+            }
+            else
+            {
+                if (writer != NULL)
+                {
+                    // previous buffers are written in background
+                    return_status = copy_writer_process (ctx, writer, FALSE, dst_path);
+                    if (return_status != FILE_CONT)
+                        goto ret;
+
+                    data = copy_writer_get (writer);
+                }
+
+                // src_read
+                if (mc_ctl (src_desc, VFS_CTL_IS_NOTREADY, 0) == 0)
+                    while ((n_read = mc_read (src_desc, data, read_size)) < 0 && !ctx->ignore_all)
+                    {
+                        return_status =
+                            file_error (ctx, TRUE, _ ("Cannot read source file\n%s"), src_path);
+                        if (return_status == FILE_RETRY)
+                            continue;
+                        if (return_status == FILE_IGNORE_ALL)
+                            ctx->ignore_all = TRUE;
+                        goto ret;
+                    }
+
+                // dst_write: data is written in background
+                if (writer != NULL && n_read > 0)
+                {
+                    copy_writer_put (writer, (size_t) n_read);
+                    copied = TRUE;
+                }
+            }
 
             if (n_read == 0)
                 break;
@@ -2736,14 +3826,16 @@ copy_file_file (file_op_context_t *ctx, const char *src_path, const char *dst_pa
             if (n_read > 0)
             {
                 ssize_t n_written;
-                char *t = buf;
+                char *t = data;
 
                 file_part += n_read;
+                if (sparse)
+                    data_left -= n_read;
 
                 tv_last_input = tv_current;
 
                 // dst_write
-                while ((n_written = mc_write (dest_desc, t, (size_t) n_read)) < n_read)
+                while (!copied && (n_written = mc_write (dest_desc, t, (size_t) n_read)) < n_read)
                 {
                     gboolean write_errno_nospace;
 
@@ -2779,12 +3871,17 @@ copy_file_file (file_op_context_t *ctx, const char *src_path, const char *dst_pa
                 }
             }
 
+            // buffer is written, let it be filled again
+            if (reader != NULL)
+                copy_reader_release (reader);
+
             ctx->progress_bytes = file_part + ctx->do_reget;
 
             const gint64 usecs = tv_current - tv_last_update;
 
             if (is_first_time || usecs > FILEOP_UPDATE_INTERVAL_US)
             {
+                totals_scan_update (ctx, ctx->total_progress_bytes + (uintmax_t) file_part);
                 calc_copy_file_progress (ctx, tv_current, file_part, file_size - ctx->do_reget);
                 tv_last_update = tv_current;
             }
@@ -2845,11 +3942,21 @@ copy_file_file (file_op_context_t *ctx, const char *src_path, const char *dst_pa
             }
         }
 
+        if (writer != NULL)
+        {
+            return_status = copy_writer_process (ctx, writer, TRUE, dst_path);
+            if (return_status != FILE_CONT)
+                goto ret;
+        }
+
         // copy successful
         dst_status = DEST_FULL;
     }
 
 ret:
+    // stop reading and writing before the files are closed
+    copy_reader_free (reader);
+    copy_writer_free (writer);
     g_free (buf);
 
     rotate_dash (FALSE);
@@ -3249,7 +4356,11 @@ retry_dst_stat:
             char *dest_file;
 
             dest_file = mc_build_filename (d, x_basename (path), (char *) NULL);
-            return_status = copy_file_file (ctx, path, dest_file);
+            // files to be erased after copy are not copied by workers
+            if (do_delete
+                || !copy_file_file_parallel (ctx, tmp_vpath, &dst_stat, dest_file,
+                                             &return_status))
+                return_status = copy_file_file (ctx, path, dest_file);
             g_free (dest_file);
         }
 
@@ -3277,6 +4388,9 @@ retry_dst_stat:
     }
     mc_closedir (reading);
 
+    // files must be written before the time of directory is set
+    return_status = copy_workers_process (ctx, TRUE, return_status);
+
     if (ctx->preserve)
     {
         mc_timesbuf_t times;
@@ -3350,6 +4464,8 @@ erase_dir (file_op_context_t *ctx, const vfs_path_t *vpath)
     {
         // not empty
         error = query_recursive (ctx, vfs_path_as_str (vpath));
+        if (error == FILE_CONT)
+            error = erase_dir_workers (ctx, vpath);
         if (error == FILE_CONT)
             error = recursive_erase (ctx, vpath);
         return error;
@@ -3360,6 +4476,26 @@ erase_dir (file_op_context_t *ctx, const vfs_path_t *vpath)
 
 /* }}} */
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Free state kept by copy, move and erase routines during one file operation: hardlinks and
+ * directories created by copying, copy workers and so on.  File operation is done by several
+ * calls of these routines, state must be freed before next operation.
+ */
+
+void
+file_op_free_state (void)
+{
+    free_hardlinks ();
+    copy_workers_free ();
+    totals_scan_free ();
+#ifdef ENABLE_URING
+    file_uring_free (erase_uring);
+    erase_uring = NULL;
+#endif
+    dest_dirs = free_linklist (dest_dirs);
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /* {{{ Panel operate routines */
 
@@ -3514,8 +4650,7 @@ panel_operate (void *source_panel, FileOperation operation, gboolean force_singl
         i18n_flag = TRUE;
     }
 
-    linklist = free_linklist (linklist);
-    dest_dirs = free_linklist (dest_dirs);
+    file_op_free_state ();
 
     save_cwds_stat ();
 
@@ -3548,6 +4683,7 @@ panel_operate (void *source_panel, FileOperation operation, gboolean force_singl
     }
 
     ctx->total_transfer_start = g_get_monotonic_time ();
+    vfs_calls_get (op_vfs_calls);
 
 #ifdef ENABLE_BACKGROUND
     // Did the user select to do a background operation?
@@ -3680,6 +4816,8 @@ panel_operate (void *source_panel, FileOperation operation, gboolean force_singl
     }  // Many entries
 
 clean_up:
+    file_op_log_stats (ctx);
+
     // Clean up
     if (save_cwd != NULL)
     {
@@ -3693,8 +4831,9 @@ clean_up:
         vfs_path_free (save_dest, TRUE);
     }
 
-    linklist = free_linklist (linklist);
-    dest_dirs = free_linklist (dest_dirs);
+    file_op_free_state ();
+    // sizes of changed directories are computed again
+    dir_size_cache_clear ();
     g_free (dest);
     vfs_path_free (dest_vpath, TRUE);
     MC_PTR_FREE (ctx->dest_mask);
@@ -48,6 +48,7 @@ FileProgressStatus copy_dir_dir (file_op_context_t *ctx, const char *s, const ch
                                  gboolean toplevel, gboolean move_over, gboolean do_delete,
                                  GSList *parent_dirs);
 FileProgressStatus erase_dir (file_op_context_t *ctx, const vfs_path_t *vpath);
+void file_op_free_state (void);
 
 gboolean panel_operate (void *source_panel, FileOperation op, gboolean force_single);
 
@@ -1223,6 +1223,14 @@ file_progress_show_target (file_op_context_t *ctx, const vfs_path_t *vpath)
 
 gboolean
 file_progress_show_deleting (file_op_context_t *ctx, const vfs_path_t *vpath, size_t *count)
+{
+    return file_progress_show_deleting_path (ctx, vfs_path_as_str (vpath), count);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+gboolean
+file_progress_show_deleting_path (file_op_context_t *ctx, const char *path, size_t *count)
 {
     static gint64 timestamp = 0;
     // update with 25 FPS rate
@@ -1238,15 +1246,13 @@ file_progress_show_deleting (file_op_context_t *ctx, const vfs_path_t *vpath, si
     if (ret)
     {
         file_progress_ui_t *ui;
-        const char *s;
 
         ui = ctx->ui;
 
         if (ui->src_file_label != NULL)
             label_set_text (ui->src_file_label, _ ("Deleting"));
 
-        s = vfs_path_as_str (vpath);
-        label_set_text (ui->src_file, truncFileStringSecure (ui->op_dlg, s));
+        label_set_text (ui->src_file, truncFileStringSecure (ui->op_dlg, path));
     }
 
     if (count != NULL)
@@ -181,6 +181,7 @@ void file_progress_show_source (file_op_context_t *ctx, const vfs_path_t *vpath)
 void file_progress_show_target (file_op_context_t *ctx, const vfs_path_t *vpath);
 gboolean file_progress_show_deleting (file_op_context_t *ctx, const vfs_path_t *vpath,
                                       size_t *count);
+gboolean file_progress_show_deleting_path (file_op_context_t *ctx, const char *path, size_t *count);
 
 /* The following functions are implemented separately by each port */
 FileProgressStatus file_progress_real_query_replace (file_op_context_t *ctx,
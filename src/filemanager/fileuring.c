@@ -0,0 +1,191 @@
+/*
+   Batched file operations using io_uring.
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** \file fileuring.c
+ *  \brief Source: batched file operations using io_uring
+ *
+ *  Deletion of a directory with many files costs at least one system call per file.  With
+ *  io_uring the whole batch of unlinkat() requests is submitted and waited for by a couple
+ *  of system calls.
+ *
+ *  The ring is used for local files only.  If io_uring is not available (old kernel, seccomp
+ *  filter, etc.) file_uring_new() returns NULL and caller uses ordinary system calls.
+ */
+
+#include <config.h>
+
+#include <errno.h>
+
+#include <liburing.h>
+
+#include "lib/global.h"
+
+#include "fileuring.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+/*** file scope type declarations ****************************************************************/
+
+struct file_uring_struct
+{
+    struct io_uring ring;
+    gboolean broken;  // submission failed, requests left in the ring are never used
+};
+
+/*** forward declarations (file scope functions) *************************************************/
+
+/*** file scope variables ************************************************************************/
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+static int
+file_uring_submit (file_uring_t *ring)
+{
+    int ret;
+
+    while ((ret = io_uring_submit (&ring->ring)) == -EINTR)
+        ;
+
+    return ret;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Create ring for file operations.
+ *
+ * @param entries maximal number of requests submitted at once
+ *
+ * @return new ring, NULL if io_uring or required operations are not supported
+ */
+
+file_uring_t *
+file_uring_new (unsigned int entries)
+{
+    file_uring_t *ring;
+    struct io_uring_probe *probe;
+    gboolean supported;
+
+    ring = g_new0 (file_uring_t, 1);
+
+    if (io_uring_queue_init (entries, &ring->ring, 0) != 0)
+    {
+        g_free (ring);
+        return NULL;
+    }
+
+    // IORING_OP_UNLINKAT is available since Linux 5.11
+    probe = io_uring_get_probe_ring (&ring->ring);
+    supported = probe != NULL && io_uring_opcode_supported (probe, IORING_OP_UNLINKAT);
+    if (probe != NULL)
+        io_uring_free_probe (probe);
+
+    if (!supported)
+    {
+        file_uring_free (ring);
+        ring = NULL;
+    }
+
+    return ring;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+file_uring_free (file_uring_t *ring)
+{
+    if (ring == NULL)
+        return;
+
+    io_uring_queue_exit (&ring->ring);
+    g_free (ring);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Remove files.  Requests are submitted by batches of ring size.
+ *
+ * @param dir_fd  directory of files
+ * @param names   names of files relative to @dir_fd
+ * @param results results of unlinkat(): 0 or negative errno.  -EISDIR is returned for
+ *                directories, -ECANCELED if request was not done
+ * @param n       number of files
+ */
+
+void
+file_uring_unlinkat (file_uring_t *ring, int dir_fd, char *const *names, int *results, guint n)
+{
+    guint i;
+
+    for (i = 0; i < n; i++)
+        results[i] = -ECANCELED;
+
+    i = 0;
+
+    while (i < n && !ring->broken)
+    {
+        struct io_uring_sqe *sqe;
+        guint queued = 0;
+        guint done;
+
+        while (i + queued < n && (sqe = io_uring_get_sqe (&ring->ring)) != NULL)
+        {
+            io_uring_prep_unlinkat (sqe, dir_fd, names[i + queued], 0);
+            io_uring_sqe_set_data (sqe, GUINT_TO_POINTER (i + queued));
+            queued++;
+        }
+
+        if (file_uring_submit (ring) != (int) queued)
+        {
+            // completions of submitted requests are not waited: the ring is not used anymore
+            ring->broken = TRUE;
+            break;
+        }
+
+        for (done = 0; done < queued; done++)
+        {
+            struct io_uring_cqe *cqe;
+            int ret;
+
+            while ((ret = io_uring_wait_cqe (&ring->ring, &cqe)) == -EINTR)
+                ;
+
+            if (ret != 0)
+            {
+                ring->broken = TRUE;
+                return;
+            }
+
+            results[GPOINTER_TO_UINT (io_uring_cqe_get_data (cqe))] = cqe->res;
+            io_uring_cqe_seen (&ring->ring, cqe);
+        }
+
+        i += queued;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,29 @@
+/** \file fileuring.h
+ *  \brief Header: batched file operations using io_uring
+ */
+
+#ifndef MC__FILEURING_H
+#define MC__FILEURING_H
+
+#include "lib/global.h"
+
+/*** typedefs(not structures) and defined constants **********************************************/
+
+typedef struct file_uring_struct file_uring_t;
+
+/*** enums ***************************************************************************************/
+
+/*** structures declarations (and typedefs of structures)*****************************************/
+
+/*** global variables defined in .c file *********************************************************/
+
+/*** declarations of public functions ************************************************************/
+
+file_uring_t *file_uring_new (unsigned int entries);
+void file_uring_free (file_uring_t *ring);
+void file_uring_unlinkat (file_uring_t *ring, int dir_fd, char *const *names, int *results,
+                          guint n);
+
+/*** inline functions ****************************************************************************/
+
+#endif
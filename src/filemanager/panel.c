@@ -65,6 +65,7 @@
 #include "src/usermenu.h"
 
 #include "dir.h"
+#include "dirwatch.h"
 #include "boxes.h"
 #include "tree.h"
 #include "ext.h"     // regexp_command
@@ -139,6 +140,31 @@ typedef enum
     FILENAME_SCROLL_RIGHT = 4
 } filename_scroll_flag_t;
 
+/*
+ * Rendered row of file list. Text of fields and highlight color of file are reused
+ * while file entry, panel format and width are the same.
+ */
+typedef struct panel_row_struct
+{
+    guint generation;  // generation of cache the row was rendered in, 0 if row is empty
+    int file_index;
+    int width;
+    unsigned int content_shift;
+    file_entry_t fe;             // copy of rendered entry, fe.fname is owned by row
+    GString *text;               // fitted texts of fields separated by '\0'
+    int color;                   // highlight color of file
+    gboolean color_valid;        // TRUE if color is computed already
+    filename_scroll_flag_t res;  // scroll state of file name
+    unsigned int name_len_diff;  // number of file name characters that don't fit field
+} panel_row_t;
+
+/* state of file list update by directory watcher */
+typedef struct
+{
+    WPanel *panel;
+    char *current;  // name of current file that is removed to be inserted again
+} panel_watch_state_t;
+
 /*** forward declarations (file scope functions) *************************************************/
 
 static const char *string_file_name (const file_entry_t *fe, int len);
@@ -159,6 +185,7 @@ static const char *string_file_group (const file_entry_t *fe, int len);
 static const char *string_marked (const file_entry_t *fe, int len);
 static const char *string_space (const file_entry_t *fe, int len);
 static const char *string_dot (const file_entry_t *fe, int len);
+static void panel_watch_callback (void *data);
 
 /*** file scope variables ************************************************************************/
 
@@ -241,6 +268,9 @@ static int state_mark = 0;
 
 static GString *string_file_name_buffer;
 
+/* rows rendered in other generation are out of date */
+static guint panel_row_cache_generation = 1;
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -597,7 +627,7 @@ string_file_owner (const file_entry_t *fe, int len)
 {
     (void) len;
 
-    return get_owner (fe->st.st_uid);
+    return get_owner_nowait (fe->st.st_uid);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -608,7 +638,7 @@ string_file_group (const file_entry_t *fe, int len)
 {
     (void) len;
 
-    return get_group (fe->st.st_gid);
+    return get_group_nowait (fe->st.st_gid);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -679,6 +709,123 @@ panel_items (const WPanel *p)
     return panel_lines (p) * p->list_cols;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Request names of owners and groups of all files of just loaded directory, so that they
+ * are got in background before they are shown.
+ */
+
+static void
+panel_prefetch_owners (const WPanel *panel)
+{
+    gboolean owner = FALSE, group = FALSE;
+    GSList *format;
+    int i;
+
+    for (format = panel->format; format != NULL; format = g_slist_next (format))
+    {
+        const format_item_t *fi = (const format_item_t *) format->data;
+
+        if (fi->string_fn == string_file_owner)
+            owner = TRUE;
+        else if (fi->string_fn == string_file_group)
+            group = TRUE;
+    }
+
+    for (i = 0; (owner || group) && i < panel->dir.len; i++)
+    {
+        const file_entry_t *fe = &panel->dir.list[i];
+
+        if (owner)
+            (void) get_owner_nowait (fe->st.st_uid);
+        if (group)
+            (void) get_group_nowait (fe->st.st_gid);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+panel_row_cache_free (WPanel *panel)
+{
+    int i;
+
+    for (i = 0; i < panel->row_cache.size; i++)
+    {
+        panel_row_t *row = &panel->row_cache.rows[i];
+
+        if (row->fe.fname != NULL)
+            g_string_free (row->fe.fname, TRUE);
+        if (row->text != NULL)
+            g_string_free (row->text, TRUE);
+    }
+
+    MC_PTR_FREE (panel->row_cache.rows);
+    panel->row_cache.size = 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Find rendered row of file.
+ *
+ * @param panel panel
+ * @param fe file entry
+ * @param file_index index of file in the list
+ * @param width width of row
+ * @param hit set to TRUE if row is rendered already and is up to date
+ *
+ * @return row to render file or get rendered one
+ */
+
+static panel_row_t *
+panel_row_cache_get (WPanel *panel, const file_entry_t *fe, int file_index, int width,
+                     gboolean *hit)
+{
+    // keep rows of current and previous pages
+    const int size = 2 * panel_items (panel);
+    panel_row_t *row;
+
+    if (size <= 0)
+        return NULL;
+
+    if (panel->row_cache.size != size)
+    {
+        panel_row_cache_free (panel);
+        panel->row_cache.rows = g_new0 (panel_row_t, size);
+        panel->row_cache.size = size;
+    }
+
+    row = &panel->row_cache.rows[file_index % size];
+
+    *hit = row->generation == panel_row_cache_generation && row->file_index == file_index
+        && row->width == width && row->content_shift == panel->content_shift
+        && memcmp (&row->fe.st, &fe->st, sizeof (fe->st)) == 0
+        && memcmp (&row->fe.f, &fe->f, sizeof (fe->f)) == 0
+        && g_string_equal (row->fe.fname, fe->fname);
+
+    if (!*hit)
+    {
+        GString *fname = row->fe.fname;
+
+        row->generation = panel_row_cache_generation;
+        row->file_index = file_index;
+        row->width = width;
+        row->content_shift = panel->content_shift;
+        row->fe = *fe;
+        row->fe.fname = fname == NULL ? mc_g_string_dup (fe->fname)
+                                      : mc_g_string_copy (fname, fe->fname);
+        if (row->text == NULL)
+            row->text = g_string_sized_new (width * 2);
+        else
+            g_string_set_size (row->text, 0);
+        row->color_valid = FALSE;
+        row->res = FILENAME_NOSCROLL;
+        row->name_len_diff = 0;
+    }
+
+    return row;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /** Formats the file number file_index of panel in the buffer dest */
 
@@ -691,13 +838,37 @@ format_file (WPanel *panel, int file_index, int width, file_attr_t attr, gboolea
     GSList *format, *home;
     file_entry_t *fe = NULL;
     filename_scroll_flag_t res = FILENAME_NOSCROLL;
+    panel_row_t *row = NULL;
+    gboolean hit = FALSE;
+    const char *cached_text = NULL;
 
     *field_length = 0;
 
     if (panel->dir.len != 0 && file_index < panel->dir.len)
     {
         fe = &panel->dir.list[file_index];
-        color = file_compute_color (attr, fe);
+
+        if (!isstatus)
+            row = panel_row_cache_get (panel, fe, file_index, width, &hit);
+
+        if (row == NULL || attr != FATTR_NORMAL || !panels_options.filetype_mode)
+            color = file_compute_color (attr, fe);
+        else
+        {
+            if (!row->color_valid)
+            {
+                row->color = file_compute_color (attr, fe);
+                row->color_valid = TRUE;
+            }
+            color = row->color;
+        }
+    }
+
+    if (hit)
+    {
+        cached_text = row->text->str;
+        res = row->res;
+        panel->max_shift = MAX (panel->max_shift, row->name_len_diff);
     }
 
     home = isstatus ? panel->status_format : panel->format;
@@ -713,9 +884,6 @@ format_file (WPanel *panel, int file_index, int width, file_attr_t attr, gboolea
             const char *prepared_text;
             int name_offset = 0;
 
-            if (fe != NULL)
-                txt = fi->string_fn (fe, fi->field_len);
-
             len = fi->field_len;
             if (len + length > width)
                 len = width - length;
@@ -723,25 +891,49 @@ format_file (WPanel *panel, int file_index, int width, file_attr_t attr, gboolea
                 break;
 
             if (!isstatus && strcmp (fi->id, "name") == 0)
-            {
-                const int str_len = str_length (txt);
-                const unsigned int len_diff = (unsigned int) DOZ (str_len, len);
-
                 *field_length = len + 1;
 
-                panel->max_shift = MAX (panel->max_shift, len_diff);
+            if (hit)
+            {
+                prepared_text = cached_text;
+                cached_text += strlen (cached_text) + 1;
+            }
+            else
+            {
+                if (fe != NULL)
+                    txt = fi->string_fn (fe, fi->field_len);
 
-                if (len_diff != 0)
+                if (!isstatus && strcmp (fi->id, "name") == 0)
                 {
-                    const unsigned int shift = MIN (panel->content_shift, len_diff);
+                    const int str_len = str_length (txt);
+                    const unsigned int len_diff = (unsigned int) DOZ (str_len, len);
+
+                    panel->max_shift = MAX (panel->max_shift, len_diff);
+
+                    if (len_diff != 0)
+                    {
+                        const unsigned int shift = MIN (panel->content_shift, len_diff);
 
-                    if (shift != 0)
-                        res |= FILENAME_SCROLL_LEFT;
+                        if (shift != 0)
+                            res |= FILENAME_SCROLL_LEFT;
 
-                    name_offset = str_offset_to_pos (txt, shift);
-                    if (str_length (txt + name_offset) > len)
-                        res |= FILENAME_SCROLL_RIGHT;
+                        name_offset = str_offset_to_pos (txt, shift);
+                        if (str_length (txt + name_offset) > len)
+                            res |= FILENAME_SCROLL_RIGHT;
+                    }
+
+                    if (row != NULL)
+                        row->name_len_diff = len_diff;
                 }
+
+                if (!isstatus)
+                    prepared_text =
+                        str_fit_to_term (txt + name_offset, len, HIDE_FIT (fi->just_mode));
+                else
+                    prepared_text = str_fit_to_term (txt, len, fi->just_mode);
+
+                if (row != NULL)
+                    g_string_append_len (row->text, prepared_text, strlen (prepared_text) + 1);
             }
 
             if (panels_options.permission_mode)
@@ -757,11 +949,6 @@ format_file (WPanel *panel, int file_index, int width, file_attr_t attr, gboolea
             else
                 tty_lowlevel_setcolor (-color);
 
-            if (!isstatus)
-                prepared_text = str_fit_to_term (txt + name_offset, len, HIDE_FIT (fi->just_mode));
-            else
-                prepared_text = str_fit_to_term (txt, len, fi->just_mode);
-
             if (perm != 0 && fe != NULL)
                 add_permission_string (prepared_text, fi->field_len, fe, attr, color, perm != 1);
             else
@@ -788,6 +975,9 @@ format_file (WPanel *panel, int file_index, int width, file_attr_t attr, gboolea
         tty_draw_hline (y, x, ' ', width - length);
     }
 
+    if (row != NULL)
+        row->res = res;
+
     return res;
 }
 
@@ -977,13 +1167,13 @@ paint_dir (WPanel *panel)
     {
         file_attr_t attr = FATTR_NORMAL;  // Color value of the line
         int n;
-        gboolean marked;
 
         n = i + panel->top;
-        marked = (panel->dir.list[n].f.marked != 0);
 
         if (n < panel->dir.len)
         {
+            const gboolean marked = (panel->dir.list[n].f.marked != 0);
+
             if (panel->current == n && panel->active)
                 attr = marked ? FATTR_MARKED_CURRENT : FATTR_CURRENT;
             else if (marked)
@@ -1434,6 +1624,8 @@ panel_destroy (WPanel *p)
     g_string_free (p->quick_search.buffer, TRUE);
     g_string_free (p->quick_search.prev_buffer, TRUE);
 
+    panel_row_cache_free (p);
+
     vfs_path_free (p->lwd_vpath, TRUE);
     vfs_path_free (p->cwd_vpath, TRUE);
 }
@@ -2043,6 +2235,105 @@ panel_set_current (WPanel *panel, int i)
     }
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/** Keep current file, top file and marks of panel while watcher changes the file list */
+
+static void
+panel_watch_changed (dir_watch_change_t change, int idx, void *data)
+{
+    panel_watch_state_t *state = (panel_watch_state_t *) data;
+    WPanel *panel = state->panel;
+    file_entry_t *fe = &panel->dir.list[idx];
+
+    if (change == DIR_WATCH_REMOVE)
+    {
+        do_file_mark (panel, idx, 0);
+
+        if (idx == panel->current)
+        {
+            g_free (state->current);
+            state->current = g_strndup (fe->fname->str, fe->fname->len);
+        }
+        else if (idx < panel->current)
+            panel->current--;
+
+        if (idx < panel->top)
+            panel->top--;
+    }
+    else
+    {
+        if (fe->f.marked != 0)
+        {
+            // see recalculate_panel_summary()
+            fe->f.marked = 0;
+            do_file_mark (panel, idx, 1);
+        }
+
+        if (state->current != NULL && strcmp (fe->fname->str, state->current) == 0)
+        {
+            panel->current = idx;
+            MC_PTR_FREE (state->current);
+        }
+        else if (idx <= panel->current)
+            panel->current++;
+
+        if (idx < panel->top)
+            panel->top++;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Apply changes reported by directory watcher to the file list.
+ *
+ * @return TRUE if file list is up to date, FALSE if directory should be reloaded
+ */
+
+static gboolean
+panel_watch_update (WPanel *panel)
+{
+    panel_watch_state_t state = { panel, NULL };
+    gboolean ret;
+
+    if (panel->watch == NULL)
+        return FALSE;
+
+    if (!panels_options.watch_dirs || panel->is_panelized)
+    {
+        panel_watch_stop (panel);
+        return FALSE;
+    }
+
+    ret = dir_watch_update (panel->watch, &panel->dir, panel->sort_field->sort_routine,
+                            &panel->sort_info, &panel->filter, panel_watch_changed, &state);
+    g_free (state.current);
+
+    if (!ret)
+        return FALSE;
+
+    panel->dirty = TRUE;
+    if (panel->dir.len == 0)
+        panel_set_current (panel, -1);
+    else if (panel->current >= panel->dir.len)
+        panel->current = panel->dir.len - 1;
+    adjust_top_file (panel);
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Start watching of just loaded directory */
+
+static void
+panel_watch_start (WPanel *panel)
+{
+    panel_watch_stop (panel);
+
+    if (panels_options.watch_dirs && !panel->is_panelized)
+        panel->watch = dir_watch_new (panel->cwd_vpath, &panel->dir, &panel->filter,
+                                      panel_watch_callback, panel);
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 static int
@@ -3398,6 +3689,9 @@ panel_do_cd_int (WPanel *panel, const vfs_path_t *new_dir_vpath, enum cd_enum cd
                         &panel->sort_info, &panel->filter))
         message (D_ERROR, MSG_ERROR, _ ("Cannot read directory contents"));
 
+    panel_prefetch_owners (panel);
+    panel_watch_start (panel);
+
     if (panel->dir.len == 0)
         panel_set_current (panel, -1);
 
@@ -4326,13 +4620,87 @@ panel_recursive_cd_to_parent (const vfs_path_t *vpath)
 
 /* --------------------------------------------------------------------------------------------- */
 
+/**
+ * Show the first part of directory while the rest of it is being read.
+ *
+ * @param list directory list of left or right panel
+ */
+
 static void
-panel_dir_list_callback (dir_list_cb_state_t state, void *data)
+panel_show_partial_dir (const dir_list *list)
 {
-    static int count = 0;
+    int i;
+
+    if (ok_to_refresh <= 0 || top_dlg == NULL || DIALOG (top_dlg->data) != filemanager)
+        return;
+
+    for (i = 0; i < 2; i++)
+        if (get_panel_type (i) == view_listing)
+        {
+            WPanel *panel;
+
+            panel = PANEL (get_panel_widget (i));
+            if (&panel->dir == list)
+            {
+                widget_draw (WIDGET (panel));
+                mc_refresh ();
+                break;
+            }
+        }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Directory of panel is changed */
+
+static void
+panel_watch_callback (void *data)
+{
+    WPanel *panel = PANEL (data);
+
+    // file list can be in use by other dialog, changes are applied when panels are on top
+    if (top_dlg == NULL || DIALOG (top_dlg->data) != filemanager)
+        return;
+
+    if (!panel_watch_update (panel))
+        update_one_panel_widget (panel, UP_OPTIMIZE, UP_KEEPSEL);
+
+    if (ok_to_refresh > 0 && panel->dirty)
+    {
+        widget_draw (WIDGET (panel));
+        mc_refresh ();
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Show names of owners and groups those are got in background */
+
+static void
+panel_uid_gid_resolved (void *data)
+{
+    int i;
 
     (void) data;
 
+    panel_row_cache_invalidate ();
+
+    // other dialogs are over panels, panels will be repainted when they are closed
+    if (ok_to_refresh <= 0 || top_dlg == NULL || DIALOG (top_dlg->data) != filemanager)
+        return;
+
+    for (i = 0; i < 2; i++)
+        if (get_panel_type (i) == view_listing)
+            widget_draw (get_panel_widget (i));
+
+    mc_refresh ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+panel_dir_list_callback (dir_list_cb_state_t state, void *data)
+{
+    static int count = 0;
+
     switch (state)
     {
     case DIR_OPEN:
@@ -4345,6 +4713,10 @@ panel_dir_list_callback (dir_list_cb_state_t state, void *data)
             rotate_dash (TRUE);
         break;
 
+    case DIR_PARTIAL:
+        panel_show_partial_dir ((const dir_list *) data);
+        break;
+
     case DIR_CLOSE:
         rotate_dash (FALSE);
         break;
@@ -4433,9 +4805,20 @@ panel_clean_dir (WPanel *panel)
     panel->content_shift = 0;
     panel->max_shift = 0;
 
+    panel_watch_stop (panel);
     dir_list_free_list (&panel->dir);
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/** Stop watching of panel directory. Directory will be read again on next reload */
+
+void
+panel_watch_stop (WPanel *panel)
+{
+    dir_watch_free (panel->watch);
+    panel->watch = NULL;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /**
  * Set Up panel's current dir object
@@ -4608,6 +4991,8 @@ panel_sized_with_dir_new (const char *panel_name, const WRect *r, const vfs_path
                         &panel->sort_info, &panel->filter))
         message (D_ERROR, MSG_ERROR, _ ("Cannot read directory contents"));
 
+    panel_watch_start (panel);
+
     if (panel->dir.len == 0)
         panel_set_current (panel, -1);
 
@@ -4635,6 +5020,10 @@ panel_reload (WPanel *panel)
     struct stat current_stat;
     vfs_path_t *cwd_vpath;
 
+    // only changed entries are updated
+    if (panel_watch_update (panel))
+        return;
+
     if (panels_options.fast_reload && stat (vfs_path_as_str (panel->cwd_vpath), &current_stat) == 0
         && current_stat.st_ctime == panel->dir_stat.st_ctime
         && current_stat.st_mtime == panel->dir_stat.st_mtime)
@@ -4659,6 +5048,9 @@ panel_reload (WPanel *panel)
                           &panel->sort_info, &panel->filter))
         message (D_ERROR, MSG_ERROR, _ ("Cannot read directory contents"));
 
+    panel_prefetch_owners (panel);
+    panel_watch_start (panel);
+
     panel->dirty = TRUE;
 
     if (panel->dir.len == 0)
@@ -4681,6 +5073,8 @@ set_panel_formats (WPanel *p)
     char *err = NULL;
     int retcode = 0;
 
+    panel_row_cache_invalidate ();
+
     form = use_display_format (p, panel_format (p), &err, FALSE);
 
     if (err != NULL)
@@ -5102,6 +5496,10 @@ update_panels (panel_update_flags_t flags, const char *current_file)
 {
     WPanel *panel;
 
+    // panel options could be changed
+    if ((flags & UP_RELOAD) != 0)
+        panel_row_cache_invalidate ();
+
     // first, update other panel...
     if ((flags & UP_ONLY_CURRENT) == 0)
         update_one_panel (get_other_index (), flags, UP_KEEPSEL);
@@ -5117,6 +5515,22 @@ update_panels (panel_update_flags_t flags, const char *current_file)
         (void) mc_chdir (panel->cwd_vpath);
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Forget rendered rows of all panels. Should be called if something that is not part of
+ * file entry, panel format or panel width changes the look of file list: options, colors,
+ * highlight rules.
+ */
+
+void
+panel_row_cache_invalidate (void)
+{
+    panel_row_cache_generation++;
+    // 0 is used for empty rows
+    if (panel_row_cache_generation == 0)
+        panel_row_cache_generation++;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 gsize
@@ -5419,6 +5833,11 @@ panel_init (void)
 
     string_file_name_buffer = g_string_sized_new (MC_MAXFILENAMELEN);
 
+    // colors could be changed
+    panel_row_cache_invalidate ();
+
+    add_hook (&uid_gid_resolved_hook, panel_uid_gid_resolved, NULL);
+
     mc_event_add (MCEVENT_GROUP_FILEMANAGER, "update_panels", event_update_panels, NULL, NULL);
     mc_event_add (MCEVENT_GROUP_FILEMANAGER, "panel_save_current_file_to_clip_file",
                   panel_save_current_file_to_clip_file, NULL, NULL);
@@ -5439,6 +5858,8 @@ panel_deinit (void)
     g_free (panel_filename_scroll_left_char);
     g_free (panel_filename_scroll_right_char);
     g_string_free (string_file_name_buffer, TRUE);
+
+    delete_hook (&uid_gid_resolved_hook, panel_uid_gid_resolved);
 }
 
 /* --------------------------------------------------------------------------------------------- */
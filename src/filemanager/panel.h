@@ -93,8 +93,9 @@ typedef struct
 
     int codepage;  // Panel codepage
 
-    dir_list dir;          // Directory contents
-    struct stat dir_stat;  // Stat of current dir: used by execute ()
+    dir_list dir;                    // Directory contents
+    struct stat dir_stat;            // Stat of current dir: used by execute ()
+    struct dir_watch_struct *watch;  // Watcher of directory changes
 
     vfs_path_t *cwd_vpath;  // Current Working Directory
     vfs_path_t *lwd_vpath;  // Last Working Directory
@@ -139,6 +140,12 @@ typedef struct
 
     unsigned int content_shift;  // Number of characters of filename need to skip from left side
     unsigned int max_shift;      // Max shift for visible part of current panel
+
+    struct
+    {
+        struct panel_row_struct *rows;  // Rendered rows of file list
+        int size;
+    } row_cache;
 } WPanel;
 
 /*** global variables defined in .c file *********************************************************/
@@ -155,6 +162,7 @@ WPanel *panel_sized_with_dir_new (const char *panel_name, const WRect *r, const
 void panel_clean_dir (WPanel *panel);
 
 void panel_reload (WPanel *panel);
+void panel_watch_stop (WPanel *panel);
 void panel_set_sort_order (WPanel *panel, const panel_field_t *sort_order);
 void panel_re_sort (WPanel *panel);
 
@@ -163,6 +171,7 @@ vfs_path_t *remove_encoding_from_path (const vfs_path_t *vpath);
 
 void update_panels (panel_update_flags_t flags, const char *current_file);
 int set_panel_formats (WPanel *p);
+void panel_row_cache_invalidate (void);
 
 void panel_set_filter (WPanel *panel, const file_filter_t *filter);
 
@@ -132,6 +132,7 @@ panels_options_t panels_options = {
     .show_dot_files = TRUE,
     .fast_reload = FALSE,
     .fast_reload_msg_shown = FALSE,
+    .watch_dirs = FALSE,
     .mark_moves_down = TRUE,
     .reverse_files_only = TRUE,
     .auto_save_setup = FALSE,
@@ -176,6 +177,12 @@ gboolean verbose = TRUE;
  */
 gboolean file_op_compute_totals = TRUE;
 
+/* Number of threads copying small files of directories. 1 to copy files one by one */
+int file_op_copy_workers = 1;
+
+/* Number of threads removing files of local directories. 1 to remove files one by one */
+int file_op_erase_workers = 1;
+
 /* If true use the internal viewer */
 gboolean use_internal_view = TRUE;
 /* If set, use the builtin editor */
@@ -334,6 +341,9 @@ static const struct
     { "ftpfs_first_cd_then_ls", &ftpfs_first_cd_then_ls },
     { "ignore_ftp_chattr_errors", &ftpfs_ignore_chattr_errors },
 #endif
+#ifdef ENABLE_VFS_NET
+    { "vfs_persistent_dircache", &vfs_persistent_dircache },
+#endif
 #endif
 #ifdef USE_INTERNAL_EDIT
     { "editor_fill_tabs_with_spaces", &edit_options.fill_tabs_with_spaces },
@@ -384,6 +394,8 @@ static const struct
     { "old_esc_mode_timeout", &old_esc_mode_timeout },
     { "max_dirt_limit", &mcview_max_dirt_limit },
     { "num_history_items_recorded", &num_history_items_recorded },
+    { "file_op_copy_workers", &file_op_copy_workers },
+    { "file_op_erase_workers", &file_op_erase_workers },
 
 #ifdef ENABLE_VFS
     { "vfs_timeout", &vfs_timeout },
@@ -435,6 +447,7 @@ static const struct
     { "show_dot_files", &panels_options.show_dot_files },
     { "fast_reload", &panels_options.fast_reload },
     { "fast_reload_msg_shown", &panels_options.fast_reload_msg_shown },
+    { "watch_dirs", &panels_options.watch_dirs },
     { "mark_moves_down", &panels_options.mark_moves_down },
     { "reverse_files_only", &panels_options.reverse_files_only },
     { "auto_save_setup_panels", &panels_options.auto_save_setup },
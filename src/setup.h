@@ -43,6 +43,7 @@ typedef struct
     gboolean show_dot_files;  // If TRUE, show files starting with a dot
     gboolean fast_reload;     // If TRUE then use stat() on the cwd to determine directory changes
     gboolean fast_reload_msg_shown;  // Have we shown the fast-reload warning in the past?
+    gboolean watch_dirs;             // If TRUE, apply changes of local directories as they happen
     gboolean mark_moves_down;        // If TRUE, marking a files moves the cursor down
     gboolean reverse_files_only;     // If TRUE, only selection of files is inverted
     gboolean auto_save_setup;
@@ -102,6 +103,8 @@ extern gboolean output_starts_shell;
 extern gboolean use_file_to_check_type;
 #endif
 extern gboolean file_op_compute_totals;
+extern int file_op_copy_workers;
+extern int file_op_erase_workers;
 extern gboolean editor_ask_filename_before_edit;
 
 extern panels_options_t panels_options;
@@ -243,6 +243,7 @@ tar_calc_sparse_offsets (struct vfs_s_inode *inode)
 {
     off_t begin = inode->data_offset;
     GArray *sm = (GArray *) inode->user_data;
+    off_t data_size = 0;
     size_t i;
 
     for (i = 0; i < sm->len; i++)
@@ -252,7 +253,15 @@ tar_calc_sparse_offsets (struct vfs_s_inode *inode)
         sp = &g_array_index (sm, struct sp_array, i);
         sp->arch_offset = begin;
         begin += BLOCKSIZE * (sp->numbytes / BLOCKSIZE + sp->numbytes % BLOCKSIZE);
+        data_size += sp->numbytes;
     }
+
+#ifdef HAVE_STRUCT_STAT_ST_BLOCKS
+    // holes don't occupy space, so extracted file can be sparse too
+    inode->st.st_blocks = (data_size + 511) / 512;
+#else
+    (void) data_size;
+#endif
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -1207,6 +1216,51 @@ tar_lseek_sparse (vfs_file_handler_t *fh, off_t offset)
     return res;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Find data or hole in sparse file using the sparse map.
+ *
+ * @param offset offset in the file, less than file size
+ * @param whence SEEK_DATA or SEEK_HOLE
+ *
+ * @return offset of next data or hole, -1 if there is no data after @offset
+ */
+
+static off_t
+tar_fh_seek_data (struct vfs_class *me, vfs_file_handler_t *fh, off_t offset, int whence)
+{
+    const GArray *sm = (const GArray *) fh->ino->user_data;
+    ssize_t chunk_idx;
+    const struct sp_array *chunk;
+
+    if (sm == NULL)
+        // file without holes
+        return whence == SEEK_DATA ? offset : fh->ino->st.st_size;
+
+    chunk_idx = tar_get_sparse_chunk_idx (sm, offset);
+
+    if (chunk_idx > 0)
+    {
+        // we are in the chunk
+        chunk = &g_array_index (sm, struct sp_array, chunk_idx - 1);
+        return whence == SEEK_DATA ? offset : chunk->offset + chunk->numbytes;
+    }
+
+    // we are in the hole
+    if (whence == SEEK_HOLE)
+        return offset;
+
+    if (chunk_idx < 0)
+    {
+        // the last chunk can be empty: it only sets the file size
+        chunk = &g_array_index (sm, struct sp_array, -chunk_idx - 1);
+        if (chunk->numbytes != 0 && chunk->offset < fh->ino->st.st_size)
+            return chunk->offset;
+    }
+
+    ERRNOR (ENXIO, -1);
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 static ssize_t
@@ -1274,6 +1328,7 @@ vfs_init_tarfs (void)
     tarfs_subclass.free_archive = tar_free_archive;
     tarfs_subclass.free_inode = tar_free_inode;
     tarfs_subclass.fh_open = tar_fh_open;
+    tarfs_subclass.fh_seek_data = tar_fh_seek_data;
     vfs_register_class (vfs_tarfs_ops);
 }
 
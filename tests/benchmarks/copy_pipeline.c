@@ -0,0 +1,316 @@
+/*
+   Benchmark of copying between local file and slow VFS.
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+   Non-local VFS (e.g. sftp) is replaced by artificial delay of every buffer.  Local target is
+   a pipe drained by a thread with artificial delay of every buffer, local source is read by
+   pread() with artificial delay, so both sides are slow.  Delays of concurrent pread() calls
+   overlap as on disk or NFS with several requests in flight.  Copying loops are the same as
+   in copy_file_file(): serial mc_read() and mc_write() against the copy reader or the copy
+   writer.
+
+   Options (environment):
+     MCBENCH_SIZE     size of copied file in bytes
+     MCBENCH_BUFSIZE  size of buffer
+     MCBENCH_REMOTE   latency of non-local VFS per buffer in usecs
+     MCBENCH_LOCAL    latency of local file per buffer in usecs
+     MCBENCH_FILE     local source file; temporary file of MCBENCH_SIZE bytes is used
+                      by default
+ */
+
+#include "tests/benchmarks/mcbench.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gint64 size;
+static size_t bufsize;
+static gint64 remote_latency;
+static gint64 local_latency;
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* slow local disk */
+static ssize_t
+slow_pread (int fd, void *buf, size_t count, off_t offset)
+{
+    g_usleep (local_latency * (gint64) count / (gint64) bufsize);
+    return pread (fd, buf, count, offset);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+#define pread slow_pread
+#include "src/filemanager/copyreader.c"
+#undef pread
+#include "src/filemanager/copywriter.c"
+
+/* --------------------------------------------------------------------------------------------- */
+
+typedef struct
+{
+    int fd;
+    size_t bufsize;
+    gint64 latency;
+} sink_t;
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* slow local disk: data is drained at rate of one buffer per latency */
+static gpointer
+sink_run (gpointer data)
+{
+    sink_t *sink = (sink_t *) data;
+    char *buf;
+    gint64 deadline = 0;
+    ssize_t n;
+
+    buf = g_malloc (sink->bufsize);
+
+    while (TRUE)
+    {
+        gint64 t, now;
+
+        t = mcbench_now ();
+        n = read (sink->fd, buf, sink->bufsize);
+        if (n <= 0)
+            break;
+        now = mcbench_now ();
+
+        /* disk is idle while data is waited for, oversleeping of previous part of data
+           is caught up */
+        if (now - t > 20)
+            deadline = MAX (deadline, now);
+        deadline += sink->latency * n / (gint64) sink->bufsize;
+        if (deadline > now)
+            g_usleep ((gulong) (deadline - now));
+    }
+
+    g_free (buf);
+    close (sink->fd);
+
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static int
+sink_open (sink_t *sink, GThread **thread)
+{
+    int fds[2];
+
+    if (pipe (fds) != 0)
+        exit (EXIT_FAILURE);
+
+#ifdef F_SETPIPE_SZ
+    // write() returns when data is almost drained, as if it is written to disk
+    (void) fcntl (fds[1], F_SETPIPE_SZ, 4096);
+#endif
+
+    sink->fd = fds[0];
+    sink->bufsize = bufsize;
+    sink->latency = local_latency;
+    *thread = g_thread_new ("sink", sink_run, sink);
+
+    return fds[1];
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* non-local VFS: sleep for every buffer */
+static void
+remote_io (char *buf, size_t len)
+{
+    g_usleep (remote_latency);
+    if (buf != NULL)
+        memset (buf, 'x', len);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+write_all (int fd, const char *buf, size_t len)
+{
+    while (len != 0)
+    {
+        ssize_t n;
+
+        n = write (fd, buf, len);
+        if (n <= 0)
+            exit (EXIT_FAILURE);
+        buf += n;
+        len -= (size_t) n;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+bench_remote_to_local (gboolean pipelined)
+{
+    sink_t sink;
+    GThread *thread;
+    int fd;
+    gint64 done, t;
+
+    fd = sink_open (&sink, &thread);
+    t = mcbench_now ();
+
+    if (!pipelined)
+    {
+        char *buf;
+
+        buf = g_malloc (bufsize);
+        for (done = 0; done < size; done += (gint64) bufsize)
+        {
+            remote_io (buf, bufsize);
+            write_all (fd, buf, bufsize);
+        }
+        g_free (buf);
+        close (fd);
+    }
+    else
+    {
+        copy_writer_t *writer;
+
+        writer = copy_writer_new (fd, bufsize);
+        for (done = 0; done < size; done += (gint64) bufsize)
+        {
+            if (copy_writer_wait (writer, FALSE) != 0)
+                exit (EXIT_FAILURE);
+            remote_io (copy_writer_get (writer), bufsize);
+            copy_writer_put (writer, bufsize);
+        }
+        if (copy_writer_wait (writer, TRUE) != 0)
+            exit (EXIT_FAILURE);
+        copy_writer_free (writer);
+    }
+
+    g_thread_join (thread);
+
+    mcbench_report (pipelined ? "remote -> local, copy writer" : "remote -> local, serial",
+                    (double) done / (1024 * 1024), "MiB", mcbench_now () - t);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+bench_local_to_remote (const char *filename, gboolean pipelined)
+{
+    int fd;
+    gint64 done = 0, t;
+
+    fd = open (filename, O_RDONLY);
+    if (fd == -1)
+        exit (EXIT_FAILURE);
+
+    t = mcbench_now ();
+
+    if (!pipelined)
+    {
+        char *buf;
+        ssize_t n;
+
+        buf = g_malloc (bufsize);
+        while ((n = slow_pread (fd, buf, bufsize, (off_t) done)) > 0)
+        {
+            remote_io (NULL, (size_t) n);
+            done += n;
+        }
+        g_free (buf);
+        close (fd);
+    }
+    else
+    {
+        copy_reader_t *reader;
+        char *buf;
+        int error;
+        ssize_t n;
+
+        reader = copy_reader_new (fd, 0, bufsize);
+        while ((n = copy_reader_get (reader, &buf, &error)) > 0)
+        {
+            remote_io (NULL, (size_t) n);
+            done += n;
+            copy_reader_release (reader);
+        }
+        copy_reader_free (reader);
+    }
+
+    mcbench_report (pipelined ? "local -> remote, copy reader" : "local -> remote, serial",
+                    (double) done / (1024 * 1024), "MiB", mcbench_now () - t);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    const char *filename;
+    char *tmpname = NULL;
+
+    size = mcbench_option ("MCBENCH_SIZE", 32 * 1024 * 1024);
+    bufsize = (size_t) mcbench_option ("MCBENCH_BUFSIZE", 128 * 1024);
+    remote_latency = mcbench_option ("MCBENCH_REMOTE", 1000);
+    local_latency = mcbench_option ("MCBENCH_LOCAL", 1000);
+
+    printf ("copy of %" G_GINT64_FORMAT " bytes by %zu, latency: remote %" G_GINT64_FORMAT
+            " us, local %" G_GINT64_FORMAT " us\n",
+            size, bufsize, remote_latency, local_latency);
+
+    bench_remote_to_local (FALSE);
+    bench_remote_to_local (TRUE);
+
+    filename = g_getenv ("MCBENCH_FILE");
+    if (filename == NULL)
+    {
+        int fd;
+        char *buf;
+        gint64 done;
+
+        fd = g_file_open_tmp ("mcbench-copy-XXXXXX", &tmpname, NULL);
+        if (fd == -1)
+            return EXIT_FAILURE;
+        buf = g_malloc0 (bufsize);
+        for (done = 0; done < size; done += (gint64) bufsize)
+            write_all (fd, buf, bufsize);
+        g_free (buf);
+        close (fd);
+        filename = tmpname;
+    }
+
+    bench_local_to_remote (filename, FALSE);
+    bench_local_to_remote (filename, TRUE);
+
+    if (tmpname != NULL)
+    {
+        (void) unlink (tmpname);
+        g_free (tmpname);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------------------------- */
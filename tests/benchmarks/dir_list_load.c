@@ -0,0 +1,210 @@
+/*
+   Benchmark of loading of directory into panel.
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+   Synthetic directories with given numbers of files are loaded by dir_list_load() and
+   dir_list_reload() without sorting.  Serial mc_readdir() and mc_lstat() of every entry,
+   as dir_list_load() did for local directories before, is measured for comparison.
+
+   Options (environment):
+     MCBENCH_FILES  numbers of files in directories, e.g. "10000 100000 1000000"
+     MCBENCH_DIR    directory to create synthetic directories in, e.g. on NFS
+ */
+
+#include "tests/benchmarks/mcbench.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "lib/strutil.h"
+#include "lib/util.h"
+#include "lib/vfs/vfs.h"
+
+#include "src/vfs/local/local.c"
+
+#include "src/filemanager/dir.h"
+
+/* --------------------------------------------------------------------------------------------- */
+
+static const char *const extensions[] = { "c", "h", "txt", "tar.gz", "o", "" };
+
+/* --------------------------------------------------------------------------------------------- */
+
+static char *
+make_dir (const char *base, int count)
+{
+    char *tmpl, *dir;
+    int i;
+
+    tmpl = g_build_filename (base, "mcbench-dir-XXXXXX", (char *) NULL);
+    dir = g_mkdtemp (tmpl);
+    if (dir == NULL)
+        exit (EXIT_FAILURE);
+
+    for (i = 0; i < count; i++)
+    {
+        char name[64];
+        int fd;
+
+        g_snprintf (name, sizeof (name), "%s/file%07d.%s", dir, i,
+                    extensions[i % G_N_ELEMENTS (extensions)]);
+        fd = open (name, O_WRONLY | O_CREAT | O_EXCL, 0644);
+        if (fd == -1)
+            exit (EXIT_FAILURE);
+        close (fd);
+    }
+
+    return dir;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+remove_dir (const char *dir)
+{
+    GDir *d;
+    const char *name;
+
+    d = g_dir_open (dir, 0, NULL);
+    if (d != NULL)
+    {
+        while ((name = g_dir_read_name (d)) != NULL)
+        {
+            char *path;
+
+            path = g_build_filename (dir, name, (char *) NULL);
+            (void) unlink (path);
+            g_free (path);
+        }
+        g_dir_close (d);
+    }
+
+    (void) rmdir (dir);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+bench_serial (const vfs_path_t *vpath, int count)
+{
+    DIR *dirp;
+    struct vfs_dirent *dp;
+    gint64 t;
+    int n = 0;
+
+    t = mcbench_now ();
+
+    dirp = mc_opendir (vpath);
+    while ((dp = mc_readdir (dirp)) != NULL)
+    {
+        vfs_path_t *entry_vpath;
+        struct stat st;
+
+        entry_vpath = vfs_path_from_str (dp->d_name);
+        if (mc_lstat (entry_vpath, &st) == 0)
+            n++;
+        vfs_path_free (entry_vpath, TRUE);
+    }
+    mc_closedir (dirp);
+
+    if (n < count)
+        exit (EXIT_FAILURE);
+
+    mcbench_report ("serial mc_lstat()", n, "entries", mcbench_now () - t);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+bench_load (const vfs_path_t *vpath, int count)
+{
+    const dir_sort_options_t sort_op = { FALSE, TRUE, FALSE };
+    dir_list list;
+    gint64 t;
+
+    memset (&list, 0, sizeof (list));
+
+    t = mcbench_now ();
+    if (!dir_list_load (&list, vpath, (GCompareFunc) unsorted, &sort_op, NULL)
+        || list.len < count)
+        exit (EXIT_FAILURE);
+    mcbench_report ("dir_list_load()", list.len, "entries", mcbench_now () - t);
+
+    t = mcbench_now ();
+    if (!dir_list_reload (&list, vpath, (GCompareFunc) unsorted, &sort_op, NULL)
+        || list.len < count)
+        exit (EXIT_FAILURE);
+    mcbench_report ("dir_list_reload()", list.len, "entries", mcbench_now () - t);
+
+    dir_list_free_list (&list);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    const char *base;
+    char **counts;
+    int i;
+
+    base = mcbench_option_str ("MCBENCH_DIR", g_get_tmp_dir ());
+    counts = g_strsplit (mcbench_option_str ("MCBENCH_FILES", "10000 100000"), " ", -1);
+
+    str_init_strings (NULL);
+    vfs_init ();
+    vfs_init_localfs ();
+    vfs_setup_work_dir ();
+
+    for (i = 0; counts[i] != NULL; i++)
+    {
+        const int count = atoi (counts[i]);
+        char *dir;
+        vfs_path_t *vpath;
+
+        if (count <= 0)
+            continue;
+
+        dir = make_dir (base, count);
+        vpath = vfs_path_from_str (dir);
+        // panel loads current directory
+        if (mc_chdir (vpath) != 0)
+            return EXIT_FAILURE;
+
+        printf ("directory of %d files\n", count);
+        bench_serial (vpath, count);
+        bench_load (vpath, count);
+
+        vfs_path_free (vpath, TRUE);
+        remove_dir (dir);
+        g_free (dir);
+    }
+
+    g_strfreev (counts);
+
+    vfs_shut ();
+    str_uninit_strings ();
+
+    return EXIT_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------------------------- */
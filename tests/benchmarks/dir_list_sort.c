@@ -0,0 +1,131 @@
+/*
+   Benchmark of sorting of panel file list.
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+   List of synthetic entries is sorted by dir_list_sort() in every order one after another,
+   as if user changes sort order of panel.  Sort keys depend on locale, it is taken from
+   environment as mc does.
+
+   Options (environment):
+     MCBENCH_ENTRIES  number of entries in list
+ */
+
+#include "tests/benchmarks/mcbench.h"
+
+#include <locale.h>
+
+#include "lib/strutil.h"
+
+#include "src/filemanager/dir.h"
+
+/* --------------------------------------------------------------------------------------------- */
+
+static const struct
+{
+    const char *name;
+    GCompareFunc sort;
+    dir_sort_options_t sort_op;
+} orders[] = {
+    { "name", (GCompareFunc) sort_name, { FALSE, FALSE, FALSE } },
+    { "name, case sensitive", (GCompareFunc) sort_name, { FALSE, TRUE, FALSE } },
+    { "extension", (GCompareFunc) sort_ext, { FALSE, FALSE, FALSE } },
+    { "size", (GCompareFunc) sort_size, { FALSE, FALSE, FALSE } },
+    { "modify time", (GCompareFunc) sort_time, { FALSE, FALSE, FALSE } },
+    { "inode", (GCompareFunc) sort_inode, { FALSE, FALSE, FALSE } },
+    { "version", (GCompareFunc) sort_vers, { FALSE, FALSE, FALSE } },
+    { "name, reverse", (GCompareFunc) sort_name, { TRUE, FALSE, FALSE } },
+    { "name, again", (GCompareFunc) sort_name, { FALSE, FALSE, FALSE } },
+};
+
+static const char *const words[] = {
+    "report", "IMG_", "Makefile", "readme", "data-", "backup", "Screenshot ", "invoice_",
+    "main", "test", "Track ", "photo", ".config", "archive", "notes", "draft",
+};
+
+static const char *const extensions[] = {
+    ".c", ".h", ".txt", ".tar.gz", ".jpg", ".JPG", ".pdf", "", ".mp3", ".o", "~",
+};
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+fill_list (dir_list *list, int count)
+{
+    guint32 seed = 1;
+    int i;
+
+    dir_list_init (list);
+
+    for (i = 1; i < count; i++)
+    {
+        struct stat st;
+        char name[64];
+
+        seed = seed * 1103515245 + 12345;
+
+        memset (&st, 0, sizeof (st));
+        st.st_ino = (ino_t) seed;
+        st.st_mode = (seed >> 4) % 10 == 0 ? S_IFDIR | 0755 : S_IFREG | 0644;
+        st.st_size = (off_t) ((seed >> 8) % 1000000);
+        st.st_mtime = (time_t) (1700000000 + (seed >> 10) % 10000000);
+
+        g_snprintf (name, sizeof (name), "%s%u%s", words[(seed >> 16) % G_N_ELEMENTS (words)],
+                    (unsigned int) i, extensions[(seed >> 20) % G_N_ELEMENTS (extensions)]);
+        dir_list_append (list, name, &st, FALSE, FALSE);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    dir_list list;
+    int count;
+    size_t i;
+
+    count = (int) mcbench_option ("MCBENCH_ENTRIES", 500000);
+
+    setlocale (LC_ALL, "");
+    str_init_strings (NULL);
+
+    memset (&list, 0, sizeof (list));
+    fill_list (&list, count);
+
+    printf ("list of %d entries, codeset %s\n", count, str_detect_termencoding ());
+
+    for (i = 0; i < G_N_ELEMENTS (orders); i++)
+    {
+        gint64 t;
+
+        t = mcbench_now ();
+        dir_list_sort (&list, orders[i].sort, &orders[i].sort_op);
+        mcbench_report (orders[i].name, list.len, "entries", mcbench_now () - t);
+    }
+
+    dir_list_free_list (&list);
+    str_uninit_strings ();
+
+    return EXIT_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------------------------- */
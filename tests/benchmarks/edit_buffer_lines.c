@@ -0,0 +1,160 @@
+/*
+   Benchmark of line scanning in editor buffer.
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+   Temporary file of synthetic text is loaded by edit_buffer_read_file() which counts lines
+   while reading.  Then lines are counted over whole buffer, cursor is moved to the last line
+   and back as Ctrl-End and Ctrl-Home do, and every line is walked by edit_buffer_get_eol()
+   and edit_buffer_get_bol() as scrolling does.
+
+   Options (environment):
+     MCBENCH_SIZE  size of text in bytes
+     MCBENCH_LINE  average length of line
+ */
+
+#include "tests/benchmarks/mcbench.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "lib/widget.h"  // simple_status_msg_t
+
+#include "src/editor/editbuffer.h"
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+report_bytes (const char *name, off_t size, gint64 usecs)
+{
+    mcbench_report (name, (double) size / (1024 * 1024), "MiB", usecs);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Write text of @size bytes with lines of random length to @fd.
+ *
+ * @return number of newlines
+ */
+
+static long
+write_text (int fd, off_t size, long line)
+{
+    char chunk[BUF_LARGE];
+    guint32 seed = 1;
+    long lines = 0;
+    off_t done;
+
+    for (done = 0; done < size; done += (off_t) sizeof (chunk))
+    {
+        const size_t len = (size_t) MIN ((off_t) sizeof (chunk), size - done);
+        size_t i;
+
+        for (i = 0; i < len; i++)
+        {
+            seed = seed * 1103515245 + 12345;
+            if ((seed >> 8) % (guint32) line == 0)
+            {
+                chunk[i] = '\n';
+                lines++;
+            }
+            else
+                chunk[i] = 'a' + (char) ((seed >> 16) % 26);
+        }
+
+        if (write (fd, chunk, len) != (ssize_t) len)
+            exit (EXIT_FAILURE);
+    }
+
+    return lines;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    edit_buffer_t buf;
+    off_t size, p;
+    long line, lines, n;
+    char *tmpname;
+    gboolean aborted;
+    int fd;
+    gint64 t;
+
+    size = (off_t) mcbench_option ("MCBENCH_SIZE", 256 * 1024 * 1024);
+    line = (long) mcbench_option ("MCBENCH_LINE", 80);
+
+    fd = g_file_open_tmp ("mcbench-edit-XXXXXX", &tmpname, NULL);
+    if (fd == -1)
+        return EXIT_FAILURE;
+    lines = write_text (fd, size, line);
+    (void) lseek (fd, 0, SEEK_SET);
+
+    printf ("%ld lines in %" G_GINT64_FORMAT " bytes\n", lines, (gint64) size);
+
+    edit_buffer_init (&buf, size);
+
+    t = mcbench_now ();
+    p = edit_buffer_read_file (&buf, fd, size, NULL, &aborted);
+    report_bytes ("edit_buffer_read_file()", size, mcbench_now () - t);
+
+    close (fd);
+    (void) unlink (tmpname);
+    g_free (tmpname);
+
+    if (p != size || buf.lines != lines)
+        return EXIT_FAILURE;
+
+    t = mcbench_now ();
+    n = edit_buffer_count_lines (&buf, 0, size);
+    report_bytes ("edit_buffer_count_lines()", size, mcbench_now () - t);
+    if (n != lines)
+        return EXIT_FAILURE;
+
+    t = mcbench_now ();
+    p = edit_buffer_get_forward_offset (&buf, 0, lines, 0);
+    report_bytes ("edit_buffer_get_forward_offset()", p, mcbench_now () - t);
+
+    t = mcbench_now ();
+    p = edit_buffer_get_backward_offset (&buf, p, lines);
+    report_bytes ("edit_buffer_get_backward_offset()", size, mcbench_now () - t);
+    if (p != 0)
+        return EXIT_FAILURE;
+
+    t = mcbench_now ();
+    for (p = 0, n = 0; p < size; n++)
+        p = edit_buffer_get_eol (&buf, p) + 1;
+    report_bytes ("edit_buffer_get_eol() of every line", size, mcbench_now () - t);
+
+    t = mcbench_now ();
+    for (p = size; p > 0; n--)
+        p = edit_buffer_get_bol (&buf, p - 1);
+    report_bytes ("edit_buffer_get_bol() of every line", size, mcbench_now () - t);
+    if (n != 0)
+        return EXIT_FAILURE;
+
+    edit_buffer_clean (&buf);
+
+    return EXIT_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------------------------- */
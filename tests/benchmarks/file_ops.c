@@ -0,0 +1,441 @@
+/*
+   Benchmark of file operations.
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+   Trees of synthetic files are copied by copy_dir_dir(), moved by move_dir_dir() and erased
+   by erase_dir() as Copy, Move and Delete commands do, without dialogs and progress window.
+   Files of flat trees are also copied one by one by copy_file_file().  For every operation
+   rate of files and data, VFS calls per file and peak resident set size of the process are
+   printed.  Every VFS call of local file is one system call at least.  Local directories are
+   erased and small files are copied by workers with system calls directly, such calls are not
+   counted.
+
+   Trees:
+     tiny    many small files, 100 files per directory
+     huge    few big files
+     deep    chain of nested directories with one small file in every directory
+     sparse  few big files with one block of data per MiB
+     wide    one directory of many empty files
+
+   Options (environment):
+     MCBENCH_TREES          trees to use, e.g. "tiny deep"
+     MCBENCH_DIR            directory to create trees in
+     MCBENCH_TARGET         directory to copy trees to, copies are moved back to MCBENCH_DIR;
+                            e.g. on other file system to make move_dir_dir() copy and erase
+                            files; MCBENCH_DIR by default
+     MCBENCH_FILES          number of files of tiny tree
+     MCBENCH_TINY           size of files of tiny and deep trees in bytes
+     MCBENCH_HUGE_FILES     number of files of huge tree
+     MCBENCH_HUGE           size of files of huge tree in bytes
+     MCBENCH_DEPTH          depth of deep tree
+     MCBENCH_SPARSE_FILES   number of files of sparse tree
+     MCBENCH_SPARSE         size of files of sparse tree in bytes
+     MCBENCH_WIDE           number of files of wide tree
+     MCBENCH_COPY_WORKERS   values of file_op_copy_workers option, trees are copied with every
+                            value, e.g. "1 4"
+     MCBENCH_ERASE_WORKERS  value of file_op_erase_workers option
+ */
+
+#include "tests/benchmarks/mcbench.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "lib/strutil.h"
+#include "lib/util.h"
+#include "lib/vfs/vfs.h"
+
+#include "src/vfs/local/local.c"
+
+#include "src/setup.h"
+#include "src/filemanager/filegui.h"
+#include "src/filemanager/file.h"
+
+/* --------------------------------------------------------------------------------------------- */
+
+typedef struct
+{
+    const char *name;
+    char *path;
+    gboolean flat;  // all files are in the root directory
+    long files;
+    gint64 size;  // apparent size of all files
+} tree_t;
+
+/* --------------------------------------------------------------------------------------------- */
+
+static char chunk[BUF_LARGE];
+static char **copy_workers;
+
+static gint64 start_time;
+static guint start_calls[VFS_CALL_COUNT];
+
+/* --------------------------------------------------------------------------------------------- */
+/* @Mock */
+void
+mc_refresh (void)
+{
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+write_file (tree_t *tree, const char *path, gint64 size, gboolean sparse)
+{
+    gint64 done;
+    int fd;
+
+    fd = open (path, O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (fd == -1)
+        exit (EXIT_FAILURE);
+
+    if (sparse)
+    {
+        if (ftruncate (fd, (off_t) size) != 0)
+            exit (EXIT_FAILURE);
+        for (done = 0; done < size; done += 1024 * 1024)
+            if (pwrite (fd, chunk, (size_t) MIN (4096, size - done), (off_t) done) <= 0)
+                exit (EXIT_FAILURE);
+    }
+    else
+        for (done = 0; done < size; done += (gint64) sizeof (chunk))
+        {
+            const size_t len = (size_t) MIN ((gint64) sizeof (chunk), size - done);
+
+            if (write (fd, chunk, len) != (ssize_t) len)
+                exit (EXIT_FAILURE);
+        }
+
+    close (fd);
+
+    tree->files++;
+    tree->size += size;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+make_dir (const char *path)
+{
+    if (mkdir (path, 0755) != 0)
+        exit (EXIT_FAILURE);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+make_tree (tree_t *tree, const char *base)
+{
+    const gint64 tiny = mcbench_option ("MCBENCH_TINY", 512);
+    char *path;
+    long i, count;
+
+    tree->path = g_build_filename (base, tree->name, (char *) NULL);
+    make_dir (tree->path);
+
+    if (strcmp (tree->name, "tiny") == 0)
+    {
+        count = (long) mcbench_option ("MCBENCH_FILES", 20000);
+
+        for (i = 0; i < count; i++)
+        {
+            path = g_strdup_printf ("%s/dir%05ld", tree->path, i / 100);
+            if (i % 100 == 0)
+                make_dir (path);
+            g_free (path);
+
+            path = g_strdup_printf ("%s/dir%05ld/file%07ld.txt", tree->path, i / 100, i);
+            write_file (tree, path, tiny, FALSE);
+            g_free (path);
+        }
+    }
+    else if (strcmp (tree->name, "huge") == 0 || strcmp (tree->name, "sparse") == 0)
+    {
+        const gboolean sparse = tree->name[0] == 's';
+        gint64 size;
+
+        count = (long) mcbench_option (sparse ? "MCBENCH_SPARSE_FILES" : "MCBENCH_HUGE_FILES", 2);
+        size = mcbench_option (sparse ? "MCBENCH_SPARSE" : "MCBENCH_HUGE",
+                               (sparse ? 1024 : 128) * 1024 * 1024);
+        tree->flat = TRUE;
+
+        for (i = 0; i < count; i++)
+        {
+            path = g_strdup_printf ("%s/file%ld.bin", tree->path, i);
+            write_file (tree, path, size, sparse);
+            g_free (path);
+        }
+    }
+    else if (strcmp (tree->name, "deep") == 0)
+    {
+        char *dir;
+
+        count = (long) mcbench_option ("MCBENCH_DEPTH", 200);
+        dir = g_strdup (tree->path);
+
+        for (i = 0; i < count; i++)
+        {
+            path = g_strdup_printf ("%s/dir%03ld", dir, i);
+            g_free (dir);
+            dir = path;
+            make_dir (dir);
+
+            path = g_build_filename (dir, "file.txt", (char *) NULL);
+            write_file (tree, path, tiny, FALSE);
+            g_free (path);
+        }
+
+        g_free (dir);
+    }
+    else if (strcmp (tree->name, "wide") == 0)
+    {
+        count = (long) mcbench_option ("MCBENCH_WIDE", 100000);
+
+        for (i = 0; i < count; i++)
+        {
+            path = g_strdup_printf ("%s/file%07ld", tree->path, i);
+            write_file (tree, path, 0, FALSE);
+            g_free (path);
+        }
+    }
+    else
+    {
+        fprintf (stderr, "unknown tree: %s\n", tree->name);
+        exit (EXIT_FAILURE);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static file_op_context_t *
+context_new (FileOperation op)
+{
+    file_op_context_t *ctx;
+
+    ctx = file_op_context_new (op);
+    // as if "All" is answered to "Delete it recursively?"
+    ctx->recursive_result = RECURSIVE_ALWAYS;
+
+    return ctx;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+context_destroy (file_op_context_t *ctx)
+{
+    // operation is finished as panel_operate() does
+    file_op_free_state ();
+    file_op_context_destroy (ctx);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+bench_start (void)
+{
+    vfs_calls_get (start_calls);
+    start_time = mcbench_now ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+bench_report (const char *name, const tree_t *tree, FileProgressStatus status)
+{
+    const double secs = (double) MAX (mcbench_now () - start_time, 1) / G_USEC_PER_SEC;
+    guint calls[VFS_CALL_COUNT];
+    guint total_calls = 0;
+    int i;
+
+    if (status != FILE_CONT)
+    {
+        fprintf (stderr, "%s failed\n", name);
+        exit (EXIT_FAILURE);
+    }
+
+    vfs_calls_get (calls);
+    for (i = 0; i < VFS_CALL_COUNT; i++)
+        total_calls += calls[i] - start_calls[i];
+
+    printf ("%-28s %12.3f ms %12.1f files/s %10.1f MiB/s %7.1f calls/file %8ld KiB RSS\n", name,
+            secs * 1000, tree->files / secs, tree->size / secs / (1024 * 1024),
+            (double) total_calls / MAX (tree->files, 1), mcbench_peak_rss ());
+    fflush (stdout);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+erase_tree (const char *path)
+{
+    file_op_context_t *ctx;
+    vfs_path_t *vpath;
+
+    ctx = context_new (OP_DELETE);
+    vpath = vfs_path_from_str (path);
+    if (erase_dir (ctx, vpath) != FILE_CONT)
+        exit (EXIT_FAILURE);
+    vfs_path_free (vpath, TRUE);
+    context_destroy (ctx);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+bench_tree (const tree_t *tree, const char *base, const char *target)
+{
+    file_op_context_t *ctx;
+    char *copy, *moved;
+    vfs_path_t *vpath;
+    FileProgressStatus status;
+    int i;
+
+    copy = g_strdup_printf ("%s/%s-copy", target, tree->name);
+    moved = g_strdup_printf ("%s/%s-moved", base, tree->name);
+
+    printf ("%s: %ld files, %" G_GINT64_FORMAT " bytes\n", tree->name, tree->files, tree->size);
+
+    for (i = 0; copy_workers[i] != NULL; i++)
+    {
+        char name[64];
+
+        if (i != 0)
+            erase_tree (copy);
+
+        file_op_copy_workers = atoi (copy_workers[i]);
+        g_snprintf (name, sizeof (name), "copy_dir_dir(), workers: %d", file_op_copy_workers);
+
+        ctx = context_new (OP_COPY);
+        bench_start ();
+        status = copy_dir_dir (ctx, tree->path, copy, TRUE, FALSE, FALSE, NULL);
+        bench_report (name, tree, status);
+        context_destroy (ctx);
+    }
+
+    ctx = context_new (OP_MOVE);
+    bench_start ();
+    status = move_dir_dir (ctx, copy, moved);
+    bench_report ("move_dir_dir()", tree, status);
+    context_destroy (ctx);
+
+    ctx = context_new (OP_DELETE);
+    vpath = vfs_path_from_str (moved);
+    bench_start ();
+    status = erase_dir (ctx, vpath);
+    bench_report ("erase_dir()", tree, status);
+    vfs_path_free (vpath, TRUE);
+    context_destroy (ctx);
+
+    if (tree->flat)
+    {
+        make_dir (copy);
+
+        ctx = context_new (OP_COPY);
+        bench_start ();
+        for (i = 0, status = FILE_CONT; i < tree->files && status == FILE_CONT; i++)
+        {
+            char *src, *dst;
+
+            src = g_strdup_printf ("%s/file%d.bin", tree->path, i);
+            dst = g_strdup_printf ("%s/file%d.bin", copy, i);
+            status = copy_file_file (ctx, src, dst);
+            g_free (src);
+            g_free (dst);
+        }
+        bench_report ("copy_file_file()", tree, status);
+        context_destroy (ctx);
+
+        erase_tree (copy);
+    }
+
+    g_free (copy);
+    g_free (moved);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    const char *base, *target;
+    char **names;
+    char *src_root, *dst_root;
+    GArray *trees;
+    guint i;
+
+    base = mcbench_option_str ("MCBENCH_DIR", g_get_tmp_dir ());
+    target = mcbench_option_str ("MCBENCH_TARGET", base);
+    names = g_strsplit (mcbench_option_str ("MCBENCH_TREES", "tiny huge deep sparse wide"), " ", -1);
+
+    copy_workers = g_strsplit (mcbench_option_str ("MCBENCH_COPY_WORKERS", "1 4"), " ", -1);
+    file_op_erase_workers = (int) mcbench_option ("MCBENCH_ERASE_WORKERS", file_op_erase_workers);
+
+    str_init_strings (NULL);
+    vfs_init ();
+    vfs_init_localfs ();
+    vfs_setup_work_dir ();
+
+    memset (chunk, 'x', sizeof (chunk));
+
+    src_root = g_build_filename (base, "mcbench-src-XXXXXX", (char *) NULL);
+    dst_root = g_build_filename (target, "mcbench-dst-XXXXXX", (char *) NULL);
+    if (g_mkdtemp (src_root) == NULL || g_mkdtemp (dst_root) == NULL)
+        return EXIT_FAILURE;
+
+#ifdef ENABLE_URING
+    printf ("erase workers: %d, io_uring: built in\n", file_op_erase_workers);
+#else
+    printf ("erase workers: %d, io_uring: not built\n", file_op_erase_workers);
+#endif
+
+    trees = g_array_new (FALSE, TRUE, sizeof (tree_t));
+    for (i = 0; names[i] != NULL; i++)
+        if (names[i][0] != '\0')
+        {
+            tree_t tree = { .name = names[i] };
+
+            make_tree (&tree, src_root);
+            g_array_append_val (trees, tree);
+        }
+
+    for (i = 0; i < trees->len; i++)
+        bench_tree (&g_array_index (trees, tree_t, i), src_root, dst_root);
+
+    for (i = 0; i < trees->len; i++)
+        g_free (g_array_index (trees, tree_t, i).path);
+    g_array_free (trees, TRUE);
+
+    erase_tree (src_root);
+    erase_tree (dst_root);
+    g_free (src_root);
+    g_free (dst_root);
+    g_strfreev (names);
+    g_strfreev (copy_workers);
+
+    vfs_shut ();
+    str_uninit_strings ();
+
+    return EXIT_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------------------------- */
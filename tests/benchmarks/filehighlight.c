@@ -0,0 +1,152 @@
+/*
+   Benchmark of file highlighting.
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+   Synthetic entries of all file types with common and unknown extensions are colored by
+   mc_fhl_get_color() against misc/filehighlight.ini as the panel does on repaint.  Colors of
+   filters are taken from misc/skins/default.ini.  Sum of colors is printed to compare results
+   of different versions.
+
+   Options (environment):
+     MCBENCH_ENTRIES  number of entries
+     MCBENCH_INI      filehighlight.ini to use instead of the stock one
+ */
+
+#include "tests/benchmarks/mcbench.h"
+
+#include "lib/filehighlight.h"
+#include "lib/skin.h"
+#include "lib/strutil.h"
+#include "lib/tty/color.h"
+
+/* --------------------------------------------------------------------------------------------- */
+
+static const char *const names[] = {
+    "main.c", "util.h", "README", "Makefile", "photo.JPG", "song.mp3", "backup.tar.gz",
+    "notes.txt", "report.pdf", "core", "a.out", "setup.py", "index.html", "data.json",
+    "video.mkv", "file.bak~", "archive.zip", "lib.so.1", "image.png", "doc.DOC", "script.sh",
+    "x.unknown", ".hidden", "module.o",
+};
+
+/* --------------------------------------------------------------------------------------------- */
+
+static file_entry_t *
+make_entries (int count)
+{
+    file_entry_t *entries;
+    guint32 seed = 1;
+    int i;
+
+    entries = g_new0 (file_entry_t, count);
+
+    for (i = 0; i < count; i++)
+    {
+        file_entry_t *fe = &entries[i];
+        guint32 kind;
+
+        seed = seed * 1103515245 + 12345;
+        kind = (seed >> 4) % 100;
+
+        fe->fname = g_string_new (names[(seed >> 16) % G_N_ELEMENTS (names)]);
+        fe->st.st_nlink = (seed >> 8) % 50 == 0 ? 2 : 1;
+
+        // mostly regular files as in usual directories
+        if (kind < 70)
+            fe->st.st_mode = S_IFREG | 0644;
+        else if (kind < 80)
+            fe->st.st_mode = S_IFREG | 0755;
+        else if (kind < 90)
+            fe->st.st_mode = S_IFDIR | 0755;
+        else if (kind < 96)
+        {
+            fe->st.st_mode = S_IFLNK | 0777;
+            fe->f.link_to_dir = (kind % 2 != 0) ? 1 : 0;
+            fe->f.stale_link = kind == 95 ? 1 : 0;
+        }
+        else if (kind < 98)
+            fe->st.st_mode = S_IFCHR | 0600;
+        else
+            fe->st.st_mode = S_IFIFO | 0600;
+    }
+
+    return entries;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    const char *ini;
+    GError *error = NULL;
+    mc_fhl_t *fhl;
+    file_entry_t *entries;
+    int count, i;
+    gint64 t, sum = 0;
+
+    count = (int) mcbench_option ("MCBENCH_ENTRIES", 1000000);
+    ini = mcbench_option_str ("MCBENCH_INI", MCBENCH_TOP_SRCDIR "/misc/filehighlight.ini");
+
+    str_init_strings (NULL);
+
+    // filters without color are never matched, so colors of skin are needed
+    mc_global.share_data_dir = (char *) MCBENCH_TOP_SRCDIR "/misc";
+    mc_global.sysconfig_dir = mc_global.share_data_dir;
+    tty_init_colors (TRUE, FALSE);
+    if (!mc_skin_init ("default", &error))
+    {
+        fprintf (stderr, "%s\n", error->message);
+        g_error_free (error);
+        return EXIT_FAILURE;
+    }
+
+    fhl = mc_fhl_new (FALSE);
+    if (!mc_fhl_read_ini_file (fhl, ini) || !mc_fhl_parse_ini_file (fhl))
+    {
+        fprintf (stderr, "cannot load %s\n", ini);
+        return EXIT_FAILURE;
+    }
+
+    entries = make_entries (count);
+
+    printf ("%d entries, %u filters\n", count, fhl->filters->len);
+
+    t = mcbench_now ();
+    for (i = 0; i < count; i++)
+        sum += mc_fhl_get_color (fhl, &entries[i]);
+    mcbench_report ("mc_fhl_get_color()", count, "entries", mcbench_now () - t);
+
+    printf ("sum of colors: %" G_GINT64_FORMAT "\n", sum);
+
+    for (i = 0; i < count; i++)
+        g_string_free (entries[i].fname, TRUE);
+    g_free (entries);
+
+    mc_fhl_free (&fhl);
+    mc_skin_deinit ();
+    tty_colors_done ();
+    str_uninit_strings ();
+
+    return EXIT_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,92 @@
+#ifndef MC__BENCH
+#define MC__BENCH
+
+#include <config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+
+#include "lib/global.h"
+
+/*** typedefs(not structures) and defined constants **********************************************/
+
+/*** enums ***************************************************************************************/
+
+/*** structures declarations (and typedefs of structures)*****************************************/
+
+/*** global variables defined in .c file *********************************************************/
+
+/*** declarations of public functions ************************************************************/
+
+/*** inline functions ****************************************************************************/
+
+/**
+ * Get option of benchmark from environment, e.g. MCBENCH_FILES=1000000.
+ */
+
+static inline gint64
+mcbench_option (const char *name, gint64 def)
+{
+    const char *value;
+
+    value = g_getenv (name);
+
+    return value == NULL ? def : g_ascii_strtoll (value, NULL, 10);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static inline const char *
+mcbench_option_str (const char *name, const char *def)
+{
+    const char *value;
+
+    value = g_getenv (name);
+
+    return value == NULL ? def : value;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static inline gint64
+mcbench_now (void)
+{
+    return g_get_monotonic_time ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Peak resident set size of the benchmark process in KiB.
+ */
+
+static inline long
+mcbench_peak_rss (void)
+{
+    struct rusage ru;
+
+    if (getrusage (RUSAGE_SELF, &ru) != 0)
+        return -1;
+
+    return ru.ru_maxrss;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Print result of benchmark as "name: value unit" line.
+ *
+ * @param items number of processed items or bytes
+ * @param usecs elapsed time
+ */
+
+static inline void
+mcbench_report (const char *name, double items, const char *unit, gint64 usecs)
+{
+    const double secs = (double) MAX (usecs, 1) / G_USEC_PER_SEC;
+
+    printf ("%-40s %12.3f ms %14.1f %s/s\n", name, secs * 1000, items / secs, unit);
+    fflush (stdout);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+#endif
@@ -0,0 +1,128 @@
+/*
+   lib - tests for file_date() function
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/lib"
+
+#include "tests/mctest.h"
+
+#include <stdlib.h>
+#include <time.h>
+
+#include "lib/timefmt.c"
+
+/* --------------------------------------------------------------------------------------------- */
+
+#define TEST_TIMEFORMAT "%Y-%m-%d %H:%M:%S %Z"
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    user_recent_timeformat = (char *) TEST_TIMEFORMAT;
+    user_old_timeformat = (char *) TEST_TIMEFORMAT;
+
+    // cached days are valid for one time zone only
+    memset (local_day_cache, 0, sizeof (local_day_cache));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    user_recent_timeformat = NULL;
+    user_old_timeformat = NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_file_date_ds") */
+static const struct test_file_date_ds
+{
+    const char *tz;
+    time_t start;
+    time_t step;
+} test_file_date_ds[] = {
+    { "UTC0", 0, 7919 },
+    // DST transitions in 2024: 31 Mar 01:00 UTC and 27 Oct 01:00 UTC
+    { "CET-1CEST,M3.5.0,M10.5.0/3", 1704067200, 7919 },
+    { "CET-1CEST,M3.5.0,M10.5.0/3", 1711843200, 61 },
+    { "CET-1CEST,M3.5.0,M10.5.0/3", 1729987200, 61 },
+    // Lord Howe Island shifts clock by 30 minutes
+    { "<+1030>-10:30<+11>-11,M10.1.0,M4.1.0", 1704067200, 7919 },
+    { "EST5EDT,M3.2.0,M11.1.0", -86400L * 400, 7919 },
+    // Asuncion: DST starts at midnight, 1 Oct 2023 04:00 UTC; step back to the day before
+    { "<-04>4<-03>,M10.1.0/0,M3.4.0/0", 1696204800, -61 },
+};
+
+/* @Test(dataSource = "test_file_date_ds") */
+START_PARAMETRIZED_TEST (test_file_date, test_file_date_ds)
+{
+    time_t when;
+    int i;
+
+    // given
+    setenv ("TZ", data->tz, 1);
+    tzset ();
+
+    for (i = 0, when = data->start; i < 8000; i++, when += data->step)
+    {
+        char expected[MAX_I18NTIMELENGTH * 4 + 1];
+        const char *actual;
+
+        FMT_LOCALTIME (expected, sizeof (expected), TEST_TIMEFORMAT, when);
+
+        // when
+        actual = file_date (when);
+
+        // then
+        mctest_assert_str_eq (actual, expected);
+
+        // the same time again, now from cache
+        actual = file_date (when);
+        mctest_assert_str_eq (actual, expected);
+    }
+}
+END_PARAMETRIZED_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    // Add new tests here: ***************
+    mctest_add_parameterized_test (tc_core, test_file_date, test_file_date_ds);
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */
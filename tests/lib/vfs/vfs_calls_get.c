@@ -0,0 +1,124 @@
+/*
+   lib/vfs - tests for vfs_calls_get() function
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/lib/vfs"
+
+#include "tests/mctest.h"
+
+#include <fcntl.h>
+
+#include "lib/strutil.h"
+#include "lib/vfs/vfs.h"
+
+#include "src/vfs/local/local.c"
+
+#define TEST_FILE TEST_SHARE_DIR PATH_SEP_STR "vfs_calls_get.txt"
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    str_init_strings (NULL);
+
+    vfs_init ();
+    vfs_init_localfs ();
+    vfs_setup_work_dir ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    (void) unlink (TEST_FILE);
+
+    vfs_shut ();
+    str_uninit_strings ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Test */
+START_TEST (test_vfs_calls_get)
+{
+    // given
+    guint before[VFS_CALL_COUNT], after[VFS_CALL_COUNT];
+    vfs_path_t *vpath;
+    struct stat st;
+    char buf[16];
+    int fd;
+
+    vpath = vfs_path_from_str (TEST_FILE);
+    vfs_calls_get (before);
+
+    // when
+    fd = mc_open (vpath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ck_assert_int_ge (fd, 0);
+    ck_assert_int_eq (mc_write (fd, "data", 4), 4);
+    ck_assert_int_eq (mc_close (fd), 0);
+
+    fd = mc_open (vpath, O_RDONLY);
+    ck_assert_int_ge (fd, 0);
+    ck_assert_int_eq (mc_fstat (fd, &st), 0);
+    ck_assert_int_eq (mc_read (fd, buf, sizeof (buf)), 4);
+    ck_assert_int_eq (mc_read (fd, buf, sizeof (buf)), 0);
+    ck_assert_int_eq (mc_close (fd), 0);
+
+    ck_assert_int_eq (mc_lstat (vpath, &st), 0);
+    ck_assert_int_eq (mc_unlink (vpath), 0);
+
+    vfs_calls_get (after);
+
+    // then
+    ck_assert_int_eq (after[VFS_CALL_OPEN] - before[VFS_CALL_OPEN], 2);
+    ck_assert_int_eq (after[VFS_CALL_READ] - before[VFS_CALL_READ], 2);
+    ck_assert_int_eq (after[VFS_CALL_WRITE] - before[VFS_CALL_WRITE], 1);
+    ck_assert_int_eq (after[VFS_CALL_STAT] - before[VFS_CALL_STAT], 2);
+    ck_assert_int_eq (after[VFS_CALL_DIR] - before[VFS_CALL_DIR], 0);
+    ck_assert_int_eq (after[VFS_CALL_OTHER] - before[VFS_CALL_OTHER], 3);
+
+    vfs_path_free (vpath, TRUE);
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    // Add new tests here: ***************
+    tcase_add_test (tc_core, test_vfs_calls_get);
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */
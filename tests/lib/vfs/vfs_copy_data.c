@@ -0,0 +1,231 @@
+/*
+   lib/vfs - tests for vfs_copy_data() function
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/lib/vfs"
+
+#include "tests/mctest.h"
+
+#include <fcntl.h>
+
+#include "lib/strutil.h"
+#include "lib/vfs/vfs.h"
+
+#include "src/vfs/local/local.c"
+
+#define SRC_FILE  TEST_SHARE_DIR PATH_SEP_STR "vfs_copy_data.src"
+#define DEST_FILE TEST_SHARE_DIR PATH_SEP_STR "vfs_copy_data.dest"
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    str_init_strings (NULL);
+
+    vfs_init ();
+    vfs_init_localfs ();
+    vfs_setup_work_dir ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    (void) unlink (SRC_FILE);
+    (void) unlink (DEST_FILE);
+
+    vfs_shut ();
+    str_uninit_strings ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_vfs_copy_data_ds") */
+static const struct test_vfs_copy_data_ds
+{
+    gsize size;
+    off_t offset;
+    size_t chunk;
+} test_vfs_copy_data_ds[] = {
+    { 0, 0, 4096 },                           // 0
+    { 1, 0, 4096 },                           // 1
+    { 100000, 0, 4096 },                      // 2
+    { 3 * 1024 * 1024 + 7, 0, 1024 * 1024 },  // 3
+    { 100000, 12345, 4096 },                  // 4: reget
+};
+
+/* @Test(dataSource = "test_vfs_copy_data_ds") */
+START_PARAMETRIZED_TEST (test_vfs_copy_data, test_vfs_copy_data_ds)
+{
+    // given
+    vfs_path_t *src_vpath, *dest_vpath;
+    int src_desc, dest_desc;
+    vfs_copy_data_t method = VFS_COPY_DATA_RANGE;
+    char *content, *copy;
+    gsize i, len;
+
+    content = g_malloc (data->size + 1);
+    for (i = 0; i < data->size; i++)
+        content[i] = (char) (i * 7 + i / 251);
+    ck_assert_int_eq (g_file_set_contents (SRC_FILE, content, (gssize) data->size, NULL), TRUE);
+
+    src_vpath = vfs_path_from_str (SRC_FILE);
+    dest_vpath = vfs_path_from_str (DEST_FILE);
+    src_desc = mc_open (src_vpath, O_RDONLY);
+    dest_desc = mc_open (dest_vpath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ck_assert_int_ge (src_desc, 0);
+    ck_assert_int_ge (dest_desc, 0);
+    ck_assert_int_eq (mc_lseek (src_desc, data->offset, SEEK_SET), data->offset);
+
+    // when
+    while (TRUE)
+    {
+        char buf[4096];
+        ssize_t n;
+
+        n = vfs_copy_data (dest_desc, src_desc, data->chunk, &method);
+        if (n > 0)
+            continue;
+
+        // confirm end of file or copy the rest if kernel copy is not supported
+        n = mc_read (src_desc, buf, sizeof (buf));
+        ck_assert_int_ge (n, 0);
+        if (n == 0)
+            break;
+        ck_assert_int_eq (mc_write (dest_desc, buf, (size_t) n), n);
+        method = VFS_COPY_DATA_NONE;
+    }
+
+    mc_close (src_desc);
+    mc_close (dest_desc);
+
+    // then
+    ck_assert_int_eq (g_file_get_contents (DEST_FILE, &copy, &len, NULL), TRUE);
+    ck_assert_int_eq (len, data->size - data->offset);
+    ck_assert_int_eq (memcmp (copy, content + data->offset, len), 0);
+
+    g_free (copy);
+    g_free (content);
+    vfs_path_free (src_vpath, TRUE);
+    vfs_path_free (dest_vpath, TRUE);
+}
+END_PARAMETRIZED_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Test */
+START_TEST (test_vfs_skip_hole)
+{
+    // given
+    vfs_path_t *src_vpath, *dest_vpath;
+    int src_desc, dest_desc;
+    char *content, *copy;
+    gsize len;
+    off_t data_left = 0;
+    off_t file_part = 0;
+    const gsize size = 3 * 1024 * 1024;
+
+    // data, hole, data, hole at the end
+    content = g_malloc0 (size);
+    memcpy (content, "head", 4);
+    memcpy (content + 1024 * 1024, "middle", 6);
+
+    src_vpath = vfs_path_from_str (SRC_FILE);
+    dest_vpath = vfs_path_from_str (DEST_FILE);
+    src_desc = mc_open (src_vpath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ck_assert_int_ge (src_desc, 0);
+    ck_assert_int_eq (mc_write (src_desc, content, 4), 4);
+    ck_assert_int_eq (mc_lseek (src_desc, 1024 * 1024, SEEK_SET), 1024 * 1024);
+    ck_assert_int_eq (mc_write (src_desc, content + 1024 * 1024, 6), 6);
+    mc_close (src_desc);
+    ck_assert_int_eq (truncate (SRC_FILE, (off_t) size), 0);
+
+    src_desc = mc_open (src_vpath, O_RDONLY);
+    ck_assert_int_ge (src_desc, 0);
+
+    dest_desc = mc_open (dest_vpath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ck_assert_int_ge (dest_desc, 0);
+
+    // when
+    while (TRUE)
+    {
+        char buf[4096];
+        off_t hole;
+        ssize_t n;
+
+        if (data_left == 0)
+        {
+            hole = vfs_skip_hole (dest_desc, src_desc, &data_left);
+            if (hole == -1)
+                data_left = sizeof (buf);  // SEEK_DATA is not supported
+            else
+                file_part += hole;
+        }
+
+        n = mc_read (src_desc, buf, (size_t) MIN ((off_t) sizeof (buf), data_left));
+        ck_assert_int_ge (n, 0);
+        if (n == 0)
+            break;
+        ck_assert_int_eq (mc_write (dest_desc, buf, (size_t) n), n);
+        file_part += n;
+        data_left -= n;
+    }
+
+    mc_close (src_desc);
+    mc_close (dest_desc);
+
+    // then
+    ck_assert_int_eq (file_part, size);
+    ck_assert_int_eq (g_file_get_contents (DEST_FILE, &copy, &len, NULL), TRUE);
+    ck_assert_int_eq (len, size);
+    ck_assert_int_eq (memcmp (copy, content, len), 0);
+
+    g_free (copy);
+    g_free (content);
+    vfs_path_free (src_vpath, TRUE);
+    vfs_path_free (dest_vpath, TRUE);
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    // Add new tests here: ***************
+    mctest_add_parameterized_test (tc_core, test_vfs_copy_data, test_vfs_copy_data_ds);
+    tcase_add_test (tc_core, test_vfs_skip_hole);
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,304 @@
+/*
+   lib/vfs - tests for persistent cache of remote directory listings
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/lib/vfs"
+
+#include "tests/mctest.h"
+
+#include "lib/strutil.h"
+#include "lib/vfs/dircache.c"  // for testing static methods
+
+#include "src/vfs/local/local.c"
+
+#define CACHE_DIR TEST_SHARE_DIR PATH_SEP_STR "dircache"
+#define DIR_PATH  "/pub/dir"
+
+static struct vfs_s_subclass test_subclass;
+static struct vfs_class *vfs_test_ops = VFS_CLASS (&test_subclass);
+
+static struct vfs_s_super *super;
+static struct vfs_s_inode *parent;
+
+/* --------------------------------------------------------------------------------------------- */
+
+static struct vfs_s_entry *
+add_entry (struct vfs_s_inode *dir, const char *name, mode_t mode, off_t size, time_t mtime,
+           const char *linkname)
+{
+    struct vfs_s_entry *ent;
+
+    ent = vfs_s_generate_entry (vfs_test_ops, name, dir, mode);
+    ent->ino->st.st_mode = mode;
+    ent->ino->st.st_size = size;
+    ent->ino->st.st_mtime = mtime;
+    ent->ino->linkname = g_strdup (linkname);
+    vfs_s_insert_entry (vfs_test_ops, dir, ent);
+
+    return ent;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static struct vfs_s_inode *
+new_dir (void)
+{
+    struct stat *st;
+
+    st = vfs_s_default_stat (vfs_test_ops, S_IFDIR | 0755);
+    return vfs_s_new_inode (vfs_test_ops, super, st);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static char *
+get_cache_filename (void)
+{
+    char *key, *filename;
+
+    key = dircache_get_key (vfs_test_ops, super->root, DIR_PATH);
+    filename = dircache_get_filename (key);
+    g_free (key);
+
+    return filename;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    vfs_path_element_t *element;
+    struct vfs_s_inode *root;
+
+    g_setenv ("XDG_CACHE_HOME", CACHE_DIR, TRUE);
+
+    str_init_strings (NULL);
+
+    vfs_init ();
+    vfs_init_localfs ();
+    vfs_setup_work_dir ();
+
+    vfs_init_subclass (&test_subclass, "testfs", VFSF_REMOTE, "test");
+    vfs_register_class (vfs_test_ops);
+
+    element = g_new0 (vfs_path_element_t, 1);
+    element->class = vfs_test_ops;
+    element->user = g_strdup ("user");
+    element->password = g_strdup ("secret");
+    element->host = g_strdup ("host.net");
+
+    super = g_new0 (struct vfs_s_super, 1);
+    super->me = vfs_test_ops;
+    super->path_element = element;
+    root = vfs_s_new_inode (vfs_test_ops, super, NULL);
+    super->root = root;
+
+    // parent directory with known mtime of DIR_PATH
+    parent = new_dir ();
+    add_entry (parent, "dir", S_IFDIR | 0755, 4096, 1000, NULL);
+    vfs_s_insert_entry (vfs_test_ops, root, vfs_s_new_entry (vfs_test_ops, "/pub", parent));
+
+    vfs_persistent_dircache = TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    char *filename;
+
+    filename = get_cache_filename ();
+    (void) unlink (filename);
+    g_free (filename);
+
+    vfs_s_free_inode (vfs_test_ops, super->root);
+    vfs_path_element_free (super->path_element);
+    g_free (super);
+
+    vfs_shut ();
+    str_uninit_strings ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Test */
+START_TEST (test_vfs_s_dircache_load_saved)
+{
+    // given
+    struct vfs_s_inode *dir, *loaded;
+    struct vfs_s_entry *ent;
+    gboolean ok;
+
+    dir = new_dir ();
+    add_entry (dir, "file.txt", S_IFREG | 0644, 12345, 100, NULL);
+    add_entry (dir, "link", S_IFLNK | 0777, 8, 200, "file.txt");
+    add_entry (dir, "subdir", S_IFDIR | 0700, 4096, 300, NULL);
+    vfs_s_dircache_save (vfs_test_ops, super->root, dir, DIR_PATH);
+
+    // when
+    loaded = new_dir ();
+    ok = vfs_s_dircache_load (vfs_test_ops, super->root, loaded, DIR_PATH);
+
+    // then
+    ck_assert_int_eq (ok, TRUE);
+    ck_assert_int_eq (g_queue_get_length (loaded->subdir), 3);
+
+    ent = VFS_ENTRY (g_queue_peek_nth (loaded->subdir, 0));
+    mctest_assert_str_eq (ent->name, "file.txt");
+    ck_assert_int_eq (ent->ino->st.st_mode, S_IFREG | 0644);
+    ck_assert_int_eq (ent->ino->st.st_size, 12345);
+    ck_assert_int_eq (ent->ino->st.st_mtime, 100);
+    mctest_assert_null (ent->ino->linkname);
+
+    ent = VFS_ENTRY (g_queue_peek_nth (loaded->subdir, 1));
+    mctest_assert_str_eq (ent->name, "link");
+    ck_assert_int_eq (ent->ino->st.st_mode, S_IFLNK | 0777);
+    mctest_assert_str_eq (ent->ino->linkname, "file.txt");
+
+    ent = VFS_ENTRY (g_queue_peek_nth (loaded->subdir, 2));
+    mctest_assert_str_eq (ent->name, "subdir");
+    ck_assert_int_eq (ent->ino->st.st_mode, S_IFDIR | 0700);
+    ck_assert_int_eq (ent->ino->st.st_mtime, 300);
+
+    // listing is reread from the remote host soon
+    ck_assert_int_le (loaded->timestamp,
+                      g_get_monotonic_time () + DIRCACHE_REVALIDATE_TIMEOUT * G_USEC_PER_SEC);
+
+    vfs_s_free_inode (vfs_test_ops, dir);
+    vfs_s_free_inode (vfs_test_ops, loaded);
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Test */
+START_TEST (test_vfs_s_dircache_changed_dir)
+{
+    // given
+    struct vfs_s_inode *dir, *loaded;
+    struct vfs_s_entry *ent;
+    char *filename;
+    gboolean ok;
+
+    dir = new_dir ();
+    add_entry (dir, "file.txt", S_IFREG | 0644, 1, 100, NULL);
+    vfs_s_dircache_save (vfs_test_ops, super->root, dir, DIR_PATH);
+
+    ent = VFS_ENTRY (g_queue_peek_head (parent->subdir));
+    ent->ino->st.st_mtime = 2000;
+
+    // when
+    loaded = new_dir ();
+    ok = vfs_s_dircache_load (vfs_test_ops, super->root, loaded, DIR_PATH);
+
+    // then
+    ck_assert_int_eq (ok, FALSE);
+    ck_assert_int_eq (g_queue_get_length (loaded->subdir), 0);
+
+    // outdated snapshot is removed
+    filename = get_cache_filename ();
+    ck_assert_int_eq (g_file_test (filename, G_FILE_TEST_EXISTS), FALSE);
+    g_free (filename);
+
+    vfs_s_free_inode (vfs_test_ops, dir);
+    vfs_s_free_inode (vfs_test_ops, loaded);
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Test */
+START_TEST (test_vfs_s_dircache_no_password)
+{
+    // given
+    struct vfs_s_inode *dir;
+    char *filename, *contents;
+    gsize len;
+
+    dir = new_dir ();
+    add_entry (dir, "file.txt", S_IFREG | 0644, 1, 100, NULL);
+
+    // when
+    vfs_s_dircache_save (vfs_test_ops, super->root, dir, DIR_PATH);
+
+    // then
+    filename = get_cache_filename ();
+    ck_assert_int_eq (g_file_get_contents (filename, &contents, &len, NULL), TRUE);
+    mctest_assert_null (g_strstr_len (contents, (gssize) len, "secret"));
+    mctest_assert_not_null (g_strstr_len (contents, (gssize) len, "user@host.net"));
+    g_free (contents);
+    g_free (filename);
+
+    vfs_s_free_inode (vfs_test_ops, dir);
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Test */
+START_TEST (test_vfs_s_dircache_disabled)
+{
+    // given
+    struct vfs_s_inode *dir;
+    char *filename;
+
+    dir = new_dir ();
+    add_entry (dir, "file.txt", S_IFREG | 0644, 1, 100, NULL);
+    vfs_persistent_dircache = FALSE;
+
+    // when
+    vfs_s_dircache_save (vfs_test_ops, super->root, dir, DIR_PATH);
+
+    // then
+    filename = get_cache_filename ();
+    ck_assert_int_eq (g_file_test (filename, G_FILE_TEST_EXISTS), FALSE);
+    g_free (filename);
+
+    vfs_s_free_inode (vfs_test_ops, dir);
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    // Add new tests here: ***************
+    tcase_add_test (tc_core, test_vfs_s_dircache_load_saved);
+    tcase_add_test (tc_core, test_vfs_s_dircache_changed_dir);
+    tcase_add_test (tc_core, test_vfs_s_dircache_no_password);
+    tcase_add_test (tc_core, test_vfs_s_dircache_disabled);
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */
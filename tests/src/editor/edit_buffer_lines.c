@@ -0,0 +1,313 @@
+/*
+   src/editor - tests for line scanning and line index in editor buffer
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/editor"
+
+#include "tests/mctest.h"
+
+// small buffers to cross their bounds often
+#define S_EDIT_BUF_SIZE 4
+
+#include "src/editor/editbuffer.c"
+
+/* --------------------------------------------------------------------------------------------- */
+
+static const char *test_text = "first line\n"
+                               "\n"
+                               "a line which is longer than one buffer of editor\n"
+                               "\n"
+                               "\n"
+                               "x\n"
+                               "no newline at the end";
+
+static edit_buffer_t buf;
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+fill_buffer (const char *text, off_t cursor)
+{
+    off_t len, i;
+
+    len = (off_t) strlen (text);
+
+    edit_buffer_init (&buf, 0);
+
+    for (i = 0; i < cursor; i++)
+        edit_buffer_insert (&buf, text[i]);
+    for (i = len - 1; i >= cursor; i--)
+        edit_buffer_insert_ahead (&buf, text[i]);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    edit_buffer_clean (&buf);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_edit_buffer_lines_ds") */
+static const struct test_edit_buffer_lines_ds
+{
+    off_t cursor;
+} test_edit_buffer_lines_ds[] = {
+    { 0 },   // 0: all text in b2
+    { 11 },  // 1: cursor at begin of line
+    { 37 },  // 2: cursor in the middle of long line
+    { 60 },  // 3: cursor at newline
+    { 86 },  // 4: all text in b1
+};
+
+/* @Test(dataSource = "test_edit_buffer_lines_ds") */
+START_PARAMETRIZED_TEST (test_edit_buffer_lines, test_edit_buffer_lines_ds)
+{
+    // given
+    off_t len, first, last;
+
+    len = (off_t) strlen (test_text);
+    ck_assert_int_eq (len, 86);
+
+    // when
+    fill_buffer (test_text, data->cursor);
+
+    // then
+    ck_assert_int_eq (buf.size, len);
+
+    for (first = 0; first <= len; first++)
+    {
+        off_t bol, eol;
+        long lines = 0;
+
+        for (bol = first; bol > 0 && test_text[bol - 1] != '\n'; bol--)
+            ;
+        for (eol = first; eol < len && test_text[eol] != '\n'; eol++)
+            ;
+
+        ck_assert_int_eq (edit_buffer_get_bol (&buf, first), bol);
+        ck_assert_int_eq (edit_buffer_get_eol (&buf, first), eol);
+
+        for (last = first; last <= len; last++)
+        {
+            ck_assert_int_eq (edit_buffer_count_lines (&buf, first, last), lines);
+            if (last < len && test_text[last] == '\n')
+                lines++;
+        }
+    }
+
+    ck_assert_int_eq (edit_buffer_get_forward_offset (&buf, 0, 3, 0), 61);
+    ck_assert_int_eq (edit_buffer_get_forward_offset (&buf, 0, 100, 0), 65);
+    ck_assert_int_eq (edit_buffer_get_forward_offset (&buf, 0, 0, len), 6);
+    ck_assert_int_eq (edit_buffer_get_backward_offset (&buf, 67, 2), 62);
+    ck_assert_int_eq (edit_buffer_get_backward_offset (&buf, 67, 100), 0);
+}
+END_PARAMETRIZED_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_edit_buffer_line_index_ds") */
+static const struct test_edit_buffer_line_index_ds
+{
+    off_t cursor;
+    off_t move;
+} test_edit_buffer_line_index_ds[] = {
+    { 0, 0 },        // 0
+    { 16, 0 },       // 1: cursor at bound of buffer
+    { 5000, 0 },     // 2
+    { 5000, -333 },  // 3: cursor is moved back
+    { 5000, 777 },   // 4: cursor is moved forward
+    { 20000, 0 },    // 5
+};
+
+/* @Test(dataSource = "test_edit_buffer_line_index_ds") */
+START_PARAMETRIZED_TEST (test_edit_buffer_line_index, test_edit_buffer_line_index_ds)
+{
+    // given
+    char *text;
+    off_t len, i;
+    off_t *offsets;
+    long lines = 0;
+
+    len = 20000;
+    text = g_malloc (len + 1);
+    offsets = g_new (off_t, len + 1);
+    offsets[0] = 0;
+
+    for (i = 0; i < len; i++)
+    {
+        text[i] = (i * 7 + i / 13) % 5 == 0 ? '\n' : 'a';
+        if (text[i] == '\n')
+            offsets[++lines] = i + 1;
+    }
+    text[len] = '\0';
+
+    // when
+    fill_buffer (text, data->cursor);
+
+    for (i = 0; i > data->move; i--)
+        edit_buffer_insert_ahead (&buf, edit_buffer_backspace (&buf));
+    for (i = 0; i < data->move; i++)
+        edit_buffer_insert (&buf, edit_buffer_delete (&buf));
+
+    // then
+    for (i = 0; i <= lines; i++)
+    {
+        ck_assert_int_eq (edit_buffer_get_line_offset (&buf, (long) i), offsets[i]);
+        ck_assert_int_eq (edit_buffer_get_line (&buf, offsets[i]), i);
+        ck_assert_int_eq (edit_buffer_count_lines (&buf, 0, offsets[i]), i);
+    }
+
+    ck_assert_int_eq (edit_buffer_get_line_offset (&buf, lines + 1), offsets[lines]);
+    ck_assert_int_eq (edit_buffer_get_line (&buf, len), lines);
+    ck_assert_int_eq (edit_buffer_get_line (&buf, offsets[100] - 1), 99);
+
+    ck_assert_int_eq (edit_buffer_get_forward_offset (&buf, offsets[100] + 1, 2000, 0),
+                      offsets[2100]);
+    ck_assert_int_eq (edit_buffer_get_forward_offset (&buf, offsets[100], lines, 0),
+                      offsets[lines]);
+    ck_assert_int_eq (edit_buffer_get_backward_offset (&buf, offsets[3000] + 1, 2000),
+                      offsets[1000]);
+    ck_assert_int_eq (edit_buffer_get_backward_offset (&buf, offsets[3000], lines), 0);
+
+    g_free (offsets);
+    g_free (text);
+}
+END_PARAMETRIZED_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_edit_buffer_bytes_ds") */
+static const struct test_edit_buffer_bytes_ds
+{
+    off_t cursor;
+    off_t move;
+    off_t insert;
+    off_t remove;
+} test_edit_buffer_bytes_ds[] = {
+    { 0, 0, 0, 0 },            // 0
+    { 0, 700, 50, 30 },        // 1
+    { 5000, -4000, 3, 1 },     // 2
+    { 5000, 4000, 100, 500 },  // 3
+    { 16, 0, 1000, 15 },       // 4: cursor at bound of buffer
+    { 9000, 1000, 20, 2000 },  // 5: more bytes than can be deleted
+};
+
+/* @Test(dataSource = "test_edit_buffer_bytes_ds") */
+START_PARAMETRIZED_TEST (test_edit_buffer_bytes, test_edit_buffer_bytes_ds)
+{
+    // given
+    const off_t len = 10000;
+    char *text, *ins, *removed;
+    GString *expected;
+    off_t i, cursor, n;
+    long lines = 0, moved = 0;
+
+    text = g_malloc (len + 1);
+    for (i = 0; i < len; i++)
+        text[i] = (i * 11 + i / 17) % 7 == 0 ? '\n' : (char) ('a' + i % 26);
+    text[len] = '\0';
+
+    ins = g_malloc (data->insert + 1);
+    for (i = 0; i < data->insert; i++)
+        ins[i] = i % 9 == 4 ? '\n' : 'X';
+
+    removed = g_malloc (data->remove + 1);
+
+    fill_buffer (text, data->cursor);
+
+    cursor = data->cursor + data->move;
+    for (i = MIN (cursor, data->cursor); i < MAX (cursor, data->cursor); i++)
+        if (text[i] == '\n')
+            moved++;
+
+    // when
+    ck_assert_int_eq (edit_buffer_move_cursor (&buf, data->move), moved);
+    ck_assert_int_eq (buf.curs1, cursor);
+
+    edit_buffer_insert_bytes (&buf, ins, data->insert);
+    edit_buffer_insert_ahead_bytes (&buf, ins, data->insert);
+    n = edit_buffer_delete_bytes (&buf, removed, data->remove);
+
+    // then
+    ck_assert_int_eq (n, MIN (data->remove, len - cursor + data->insert));
+    ck_assert_int_eq (memcmp (removed, ins, MIN (n, data->insert)), 0);
+    if (n > data->insert)
+        ck_assert_int_eq (memcmp (removed + data->insert, text + cursor, n - data->insert), 0);
+
+    n = edit_buffer_backspace_bytes (&buf, removed, data->remove);
+    ck_assert_int_eq (n, MIN (data->remove, cursor + data->insert));
+    ck_assert_int_eq (
+        memcmp (removed + n - MIN (n, data->insert), ins + data->insert - MIN (n, data->insert),
+                MIN (n, data->insert)),
+        0);
+
+    expected = g_string_new_len (text, len);
+    g_string_insert_len (expected, cursor, ins, data->insert);
+    g_string_insert_len (expected, cursor, ins, data->insert);
+    g_string_erase (expected, cursor + data->insert,
+                    MIN (data->remove, (off_t) expected->len - cursor - data->insert));
+    g_string_erase (expected, cursor + data->insert - n, n);
+
+    ck_assert_int_eq (buf.size, (off_t) expected->len);
+    for (i = 0; i < buf.size; i++)
+        ck_assert_int_eq (edit_buffer_get_byte (&buf, i), expected->str[i]);
+
+    for (i = 0; i < (off_t) expected->len; i++)
+        if (expected->str[i] == '\n')
+        {
+            lines++;
+            ck_assert_int_eq (edit_buffer_get_line_offset (&buf, lines), i + 1);
+        }
+    ck_assert_int_eq (edit_buffer_count_lines (&buf, 0, buf.size), lines);
+
+    g_string_free (expected, TRUE);
+    g_free (removed);
+    g_free (ins);
+    g_free (text);
+}
+END_PARAMETRIZED_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    tcase_add_checked_fixture (tc_core, NULL, teardown);
+
+    // Add new tests here: ***************
+    mctest_add_parameterized_test (tc_core, test_edit_buffer_lines, test_edit_buffer_lines_ds);
+    mctest_add_parameterized_test (tc_core, test_edit_buffer_line_index,
+                                   test_edit_buffer_line_index_ds);
+    mctest_add_parameterized_test (tc_core, test_edit_buffer_bytes, test_edit_buffer_bytes_ds);
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */
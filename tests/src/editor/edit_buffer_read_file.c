@@ -0,0 +1,291 @@
+/*
+   src/editor - tests for lazy loading of file into editor buffer
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/editor"
+
+#include "tests/mctest.h"
+
+#include <fcntl.h>
+
+#include "lib/strutil.h"
+#include "lib/vfs/vfs.h"
+
+#include "src/vfs/local/local.c"
+
+// small buffers to load small file lazily
+#define S_EDIT_BUF_SIZE 4
+
+#include "src/editor/editbuffer.c"
+
+/* --------------------------------------------------------------------------------------------- */
+
+static char *filename = NULL;
+static char *savename = NULL;
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    int fd;
+
+    str_init_strings (NULL);
+
+    vfs_init ();
+    vfs_init_localfs ();
+    vfs_setup_work_dir ();
+
+    fd = g_file_open_tmp ("mctest-editbuffer-XXXXXX", &filename, NULL);
+    ck_assert_int_ge (fd, 0);
+    close (fd);
+
+    fd = g_file_open_tmp ("mctest-editbuffer-XXXXXX", &savename, NULL);
+    ck_assert_int_ge (fd, 0);
+    close (fd);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    (void) unlink (filename);
+    g_free (filename);
+    (void) unlink (savename);
+    g_free (savename);
+
+    vfs_shut ();
+    str_uninit_strings ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static char *
+make_content (gsize size, long *lines)
+{
+    char *content;
+    gsize i;
+
+    content = g_malloc (size);
+    *lines = 0;
+
+    for (i = 0; i < size; i++)
+    {
+        content[i] = (i * 7 + i / 13) % 5 == 0 ? '\n' : 'a' + i % 26;
+        if (content[i] == '\n')
+            (*lines)++;
+    }
+
+    ck_assert_int_eq (g_file_set_contents (filename, content, (gssize) size, NULL), TRUE);
+
+    return content;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+read_file (edit_buffer_t *buf, gsize size)
+{
+    vfs_path_t *vpath;
+    int fd;
+    gboolean aborted;
+
+    vpath = vfs_path_from_str (filename);
+    fd = mc_open (vpath, O_RDONLY);
+    ck_assert_int_ge (fd, 0);
+    edit_buffer_init (buf, (off_t) size);
+    ck_assert_int_eq (edit_buffer_read_file (buf, fd, buf->size, NULL, &aborted), size);
+    mc_close (fd);
+    vfs_path_free (vpath, TRUE);
+
+    ck_assert_int_ne (buf->file_fd, -1);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_edit_buffer_read_file_lazily_ds") */
+static const struct test_edit_buffer_read_file_lazily_ds
+{
+    gsize size;
+    gboolean read_all;
+} test_edit_buffer_read_file_lazily_ds[] = {
+    { 20000, FALSE },  // 0
+    { 20007, FALSE },  // 1: first buffer is not filled
+    { 20007, TRUE },   // 2
+};
+
+/* @Test(dataSource = "test_edit_buffer_read_file_lazily_ds") */
+START_PARAMETRIZED_TEST (test_edit_buffer_read_file_lazily, test_edit_buffer_read_file_lazily_ds)
+{
+    // given
+    edit_buffer_t buf;
+    vfs_path_t *vpath;
+    int fd;
+    char *content, *expected, *copy;
+    gsize i, len;
+    long lines;
+
+    content = make_content (data->size, &lines);
+
+    // the same changes in expected text
+    expected = g_malloc (data->size + 50);
+    memcpy (expected, content, 5000);
+    memset (expected + 5000, 'X', 50);
+    memcpy (expected + 5050, content + 5100, data->size - 5100);
+    len = data->size - 50;
+
+    // when
+    read_file (&buf, data->size);
+
+    // then
+    ck_assert_int_eq (buf.lines, lines);
+    ck_assert_int_eq (edit_buffer_get_line (&buf, buf.size), lines);
+    for (i = 0; i < data->size; i++)
+        ck_assert_int_eq (edit_buffer_get_byte (&buf, (off_t) i), (unsigned char) content[i]);
+
+    // when
+    for (i = 0; i < 5000; i++)
+        edit_buffer_insert (&buf, edit_buffer_delete (&buf));
+    for (i = 0; i < 100; i++)
+        edit_buffer_delete (&buf);
+    for (i = 0; i < 50; i++)
+        edit_buffer_insert_ahead (&buf, 'X');
+
+    if (data->read_all)
+    {
+        edit_buffer_read_all (&buf);
+        ck_assert_int_eq (buf.file_fd, -1);
+    }
+
+    vpath = vfs_path_from_str (savename);
+    fd = mc_open (vpath, O_WRONLY | O_TRUNC);
+    ck_assert_int_ge (fd, 0);
+    ck_assert_int_eq (edit_buffer_write_file (&buf, fd), len);
+    mc_close (fd);
+    vfs_path_free (vpath, TRUE);
+
+    edit_buffer_clean (&buf);
+
+    // then
+    ck_assert_int_eq (g_file_get_contents (savename, &copy, &i, NULL), TRUE);
+    ck_assert_int_eq (i, len);
+    ck_assert_int_eq (memcmp (copy, expected, len), 0);
+    g_free (copy);
+
+    // loaded file is not changed
+    ck_assert_int_eq (g_file_get_contents (filename, &copy, &i, NULL), TRUE);
+    ck_assert_int_eq (i, data->size);
+    ck_assert_int_eq (memcmp (copy, content, i), 0);
+    g_free (copy);
+
+    g_free (expected);
+    g_free (content);
+}
+END_PARAMETRIZED_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_edit_buffer_read_changed_file_ds") */
+static const struct test_edit_buffer_read_changed_file_ds
+{
+    gsize size;
+    gsize new_size;
+    char c;
+} test_edit_buffer_read_changed_file_ds[] = {
+    { 20007, 10003, 'a' },   // 0: file is truncated
+    { 20007, 20007, '\n' },  // 1: file is rewritten with more lines
+    { 20007, 20007, 'b' },   // 2: file is rewritten without lines
+};
+
+/* @Test(dataSource = "test_edit_buffer_read_changed_file_ds") */
+START_PARAMETRIZED_TEST (test_edit_buffer_read_changed_file,
+                         test_edit_buffer_read_changed_file_ds)
+{
+    // given
+    edit_buffer_t buf;
+    char *content, *changed;
+    int fd;
+    long lines, line;
+    off_t offset;
+    gsize i;
+
+    content = make_content (data->size, &lines);
+    read_file (&buf, data->size);
+
+    // file is changed in place
+    changed = g_malloc (data->new_size);
+    memset (changed, data->c, data->new_size);
+    fd = open (filename, O_WRONLY | O_TRUNC);
+    ck_assert_int_ge (fd, 0);
+    ck_assert_int_eq (write (fd, changed, data->new_size), data->new_size);
+    close (fd);
+
+    // when
+    for (line = 0; line <= lines; line++)
+    {
+        offset = edit_buffer_get_line_offset (&buf, line);
+        ck_assert_int_ge (offset, 0);
+        ck_assert_int_le (offset, buf.size);
+    }
+
+    // then: the line index corresponds to the read text
+    lines = 0;
+    for (i = 0; i < data->size; i++)
+        if (edit_buffer_get_byte (&buf, (off_t) i) == '\n')
+        {
+            lines++;
+            ck_assert_int_eq (edit_buffer_get_line_offset (&buf, lines), i + 1);
+        }
+
+    ck_assert_int_eq (buf.lines, lines);
+    ck_assert_int_eq (edit_buffer_get_line (&buf, buf.size), lines);
+
+    edit_buffer_clean (&buf);
+    g_free (changed);
+    g_free (content);
+}
+END_PARAMETRIZED_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    // Add new tests here: ***************
+    mctest_add_parameterized_test (tc_core, test_edit_buffer_read_file_lazily,
+                                   test_edit_buffer_read_file_lazily_ds);
+    mctest_add_parameterized_test (tc_core, test_edit_buffer_read_changed_file,
+                                   test_edit_buffer_read_changed_file_ds);
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,262 @@
+/*
+   src/editor - tests for undo log of editor
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/editor"
+
+#include "tests/mctest.h"
+
+// spill bytes to the file soon
+#define EDIT_UNDO_MEMORY_MAX 100
+// split big actions into several records
+#define EDIT_UNDO_RECORD_MAX 1000
+
+#include "src/editor/editundo.c"
+
+/* --------------------------------------------------------------------------------------------- */
+
+#define GROUP 1000
+
+static edit_undo_log_t ulog;
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    edit_undo_log_clean (&ulog);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+assert_pop (long action, off_t count, const char *bytes)
+{
+    edit_undo_record_t record;
+    const char *p;
+
+    ck_assert_int_eq (edit_undo_log_pop (&ulog, &record, &p), TRUE);
+    ck_assert_int_eq (record.action, action);
+    ck_assert_int_eq (record.count, count);
+    ck_assert_int_eq (record.bytes, bytes != NULL);
+
+    if (bytes != NULL)
+        ck_assert_int_eq (memcmp (p, bytes, (size_t) count), 0);
+    else
+        mctest_assert_null (p);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Test */
+START_TEST (test_edit_undo_log_push)
+{
+    // given
+    edit_undo_record_t record;
+    const char *p;
+
+    edit_undo_log_init (&ulog, GROUP, 1000);
+
+    // when
+    edit_undo_log_push (&ulog, GROUP, 1);
+    edit_undo_log_push (&ulog, 1, 2);
+    edit_undo_log_push (&ulog, 1, 3);
+    edit_undo_log_push_bytes (&ulog, 1, "abc", 3);
+    edit_undo_log_push_bytes (&ulog, 1, "de", 2);
+    edit_undo_log_push_bytes (&ulog, 2, "f", 1);
+    edit_undo_log_push (&ulog, 2, 1);
+    edit_undo_log_push (&ulog, 2, 0);
+
+    // then
+    ck_assert_int_eq (ulog.records->len, 5);
+    ck_assert_int_eq (edit_undo_log_last (&ulog)->action, 2);
+
+    assert_pop (2, 1, NULL);
+    assert_pop (2, 1, "f");
+    assert_pop (1, 5, "abcde");
+
+    // bytes of popped records are replaced by the next push
+    edit_undo_log_push_bytes (&ulog, 1, "xyz", 3);
+    assert_pop (1, 3, "xyz");
+
+    assert_pop (1, 5, NULL);
+    assert_pop (GROUP, 1, NULL);
+    ck_assert_int_eq (edit_undo_log_pop (&ulog, &record, &p), FALSE);
+    mctest_assert_null (edit_undo_log_last (&ulog));
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_edit_undo_log_limit_ds") */
+static const struct test_edit_undo_log_limit_ds
+{
+    gboolean spill;
+    off_t len;
+} test_edit_undo_log_limit_ds[] = {
+    { TRUE, 10 },    // 0
+    { FALSE, 10 },   // 1
+    { TRUE, 1000 },  // 2: bytes are spilled to the file
+    { FALSE, 1000 }, // 3: groups are dropped to free memory
+};
+
+/* @Test(dataSource = "test_edit_undo_log_limit_ds") */
+START_PARAMETRIZED_TEST (test_edit_undo_log_limit, test_edit_undo_log_limit_ds)
+{
+    // given
+    const int groups = 100;
+    char *bytes;
+    edit_undo_record_t record;
+    const char *p;
+    int i;
+
+    bytes = g_malloc (data->len);
+
+    edit_undo_log_init (&ulog, GROUP, 64);
+    ulog.spill = data->spill;
+
+    // when
+    for (i = 0; i < groups; i++)
+    {
+        memset (bytes, 'a' + i % 26, data->len);
+        edit_undo_log_push (&ulog, GROUP + i, 1);
+        edit_undo_log_push (&ulog, 1, 1);
+        edit_undo_log_push_bytes (&ulog, 2, bytes, data->len);
+    }
+
+    // then
+    ck_assert_int_le (ulog.records->len, 64);
+    ck_assert_int_eq (g_array_index (ulog.records, edit_undo_record_t, 0).action >= GROUP, TRUE);
+    if (data->len > EDIT_UNDO_MEMORY_MAX)
+        ck_assert_int_eq (ulog.fd != -1, data->spill);
+
+    for (i = groups - 1; edit_undo_log_last (&ulog) != NULL; i--)
+    {
+        memset (bytes, 'a' + i % 26, data->len);
+        assert_pop (2, data->len, bytes);
+        assert_pop (1, 1, NULL);
+        assert_pop (GROUP + i, 1, NULL);
+    }
+
+    // the oldest groups are dropped
+    ck_assert_int_gt (i, 0);
+    ck_assert_int_lt (i, groups - 1);
+    ck_assert_int_eq (edit_undo_log_pop (&ulog, &record, &p), FALSE);
+
+    g_free (bytes);
+}
+END_PARAMETRIZED_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Test */
+START_TEST (test_edit_undo_log_last_group)
+{
+    // given
+    int i;
+
+    edit_undo_log_init (&ulog, GROUP, 64);
+
+    // when
+    edit_undo_log_push (&ulog, GROUP, 1);
+    for (i = 0; i < 1000; i++)
+    {
+        edit_undo_log_push (&ulog, 1, 1);
+        edit_undo_log_push_bytes (&ulog, 2, "x", 1);
+    }
+
+    // then
+    ck_assert_int_eq (ulog.records->len, 2001);
+    for (i = 0; i < 1000; i++)
+    {
+        assert_pop (2, 1, "x");
+        assert_pop (1, 1, NULL);
+    }
+    assert_pop (GROUP, 1, NULL);
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_edit_undo_log_big_record_ds") */
+static const struct test_edit_undo_log_big_record_ds
+{
+    gboolean spill;
+} test_edit_undo_log_big_record_ds[] = {
+    { TRUE },   // 0: records are read from the file one at a time
+    { FALSE },  // 1
+};
+
+/* @Test(dataSource = "test_edit_undo_log_big_record_ds") */
+START_PARAMETRIZED_TEST (test_edit_undo_log_big_record, test_edit_undo_log_big_record_ds)
+{
+    // given
+    char bytes[3000];
+    int i;
+
+    for (i = 0; i < (int) sizeof (bytes); i++)
+        bytes[i] = 'a' + i % 26;
+
+    edit_undo_log_init (&ulog, GROUP, 64);
+    ulog.spill = data->spill;
+
+    // when
+    edit_undo_log_push (&ulog, GROUP, 1);
+    edit_undo_log_push_bytes (&ulog, 2, bytes, 600);
+    edit_undo_log_push_bytes (&ulog, 2, bytes + 600, 2000);
+    edit_undo_log_push_bytes (&ulog, 2, bytes + 2600, 400);
+
+    // then
+    ck_assert_int_eq (ulog.records->len, 4);
+    ck_assert_int_eq (ulog.fd != -1, data->spill);
+
+    assert_pop (2, 1000, bytes + 2000);
+    assert_pop (2, 1000, bytes + 1000);
+    assert_pop (2, 1000, bytes);
+    assert_pop (GROUP, 1, NULL);
+    mctest_assert_null (edit_undo_log_last (&ulog));
+}
+END_PARAMETRIZED_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    tcase_add_checked_fixture (tc_core, NULL, teardown);
+
+    // Add new tests here: ***************
+    tcase_add_test (tc_core, test_edit_undo_log_push);
+    mctest_add_parameterized_test (tc_core, test_edit_undo_log_limit, test_edit_undo_log_limit_ds);
+    tcase_add_test (tc_core, test_edit_undo_log_last_group);
+    mctest_add_parameterized_test (tc_core, test_edit_undo_log_big_record,
+                                   test_edit_undo_log_big_record_ds);
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */
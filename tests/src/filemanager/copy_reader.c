@@ -0,0 +1,179 @@
+/*
+   src/filemanager - tests for reading of source file in background thread
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/filemanager"
+
+#include "tests/mctest.h"
+
+#include <fcntl.h>
+
+#include "src/filemanager/copyreader.c"
+
+/* --------------------------------------------------------------------------------------------- */
+
+static char *filename = NULL;
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    int fd;
+
+    fd = g_file_open_tmp ("mctest-copyreader-XXXXXX", &filename, NULL);
+    ck_assert_int_ge (fd, 0);
+    close (fd);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    (void) unlink (filename);
+    g_free (filename);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_copy_reader_ds") */
+static const struct test_copy_reader_ds
+{
+    gsize size;
+    off_t offset;
+    size_t bufsize;
+} test_copy_reader_ds[] = {
+    { 0, 0, 16 },                         // 0
+    { 15, 0, 16 },                        // 1
+    { 16 * COPY_READER_BUFFERS, 0, 16 },  // 2
+    { 100000, 0, 1000 },                  // 3
+    { 100000, 777, 4096 },                // 4: reget
+    { 100000, 100000, 16 },               // 5: reget of whole file
+};
+
+/* @Test(dataSource = "test_copy_reader_ds") */
+START_PARAMETRIZED_TEST (test_copy_reader, test_copy_reader_ds)
+{
+    // given
+    int fd;
+    copy_reader_t *reader;
+    char *content;
+    GString *copy;
+    gsize i;
+
+    content = g_malloc (data->size + 1);
+    for (i = 0; i < data->size; i++)
+        content[i] = (char) (i * 13 + i / 257);
+    ck_assert_int_eq (g_file_set_contents (filename, content, (gssize) data->size, NULL), TRUE);
+
+    fd = open (filename, O_RDONLY);
+    ck_assert_int_ge (fd, 0);
+
+    copy = g_string_new ("");
+
+    // when
+    reader = copy_reader_new (fd, data->offset, data->bufsize);
+    mctest_assert_not_null (reader);
+
+    while (TRUE)
+    {
+        char *buf;
+        int error;
+        ssize_t n;
+
+        n = copy_reader_get (reader, &buf, &error);
+        ck_assert_int_ge (n, 0);
+        if (n == 0)
+            break;
+
+        ck_assert_int_le (n, data->bufsize);
+        g_string_append_len (copy, buf, n);
+        copy_reader_release (reader);
+    }
+
+    copy_reader_free (reader);
+
+    // then
+    ck_assert_int_eq (copy->len, data->size - data->offset);
+    ck_assert_int_eq (memcmp (copy->str, content + data->offset, copy->len), 0);
+
+    g_string_free (copy, TRUE);
+    g_free (content);
+}
+END_PARAMETRIZED_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Test */
+START_TEST (test_copy_reader_error)
+{
+    // given
+    int fd;
+    copy_reader_t *reader;
+    char *buf;
+    int error;
+    ssize_t n;
+
+    fd = open (g_get_tmp_dir (), O_RDONLY);
+    ck_assert_int_ge (fd, 0);
+
+    // when
+    reader = copy_reader_new (fd, 0, 16);
+    mctest_assert_not_null (reader);
+    n = copy_reader_get (reader, &buf, &error);
+
+    // then
+    ck_assert_int_eq (n, -1);
+    ck_assert_int_eq (error, EISDIR);
+
+    // retry
+    copy_reader_release (reader);
+    n = copy_reader_get (reader, &buf, &error);
+    ck_assert_int_eq (n, -1);
+    ck_assert_int_eq (error, EISDIR);
+
+    copy_reader_free (reader);
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    // Add new tests here: ***************
+    mctest_add_parameterized_test (tc_core, test_copy_reader, test_copy_reader_ds);
+    tcase_add_test (tc_core, test_copy_reader_error);
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,167 @@
+/*
+   src/filemanager - tests for writing of target file in background thread
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/filemanager"
+
+#include "tests/mctest.h"
+
+#include <fcntl.h>
+
+#include "src/filemanager/copywriter.c"
+
+/* --------------------------------------------------------------------------------------------- */
+
+static char *filename = NULL;
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    int fd;
+
+    fd = g_file_open_tmp ("mctest-copywriter-XXXXXX", &filename, NULL);
+    ck_assert_int_ge (fd, 0);
+    close (fd);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    (void) unlink (filename);
+    g_free (filename);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_copy_writer_ds") */
+static const struct test_copy_writer_ds
+{
+    gsize size;
+    size_t bufsize;
+} test_copy_writer_ds[] = {
+    { 0, 16 },                         // 0
+    { 15, 16 },                        // 1
+    { 16 * COPY_WRITER_BUFFERS, 16 },  // 2
+    { 100000, 1000 },                  // 3
+    { 100000, 4096 },                  // 4
+};
+
+/* @Test(dataSource = "test_copy_writer_ds") */
+START_PARAMETRIZED_TEST (test_copy_writer, test_copy_writer_ds)
+{
+    // given
+    int fd;
+    copy_writer_t *writer;
+    char *content, *copy;
+    gsize i, len;
+
+    content = g_malloc (data->size + 1);
+    for (i = 0; i < data->size; i++)
+        content[i] = (char) (i * 13 + i / 257);
+
+    fd = open (filename, O_WRONLY | O_TRUNC);
+    ck_assert_int_ge (fd, 0);
+
+    // when
+    writer = copy_writer_new (fd, data->bufsize);
+    mctest_assert_not_null (writer);
+
+    for (i = 0; i < data->size; i += len)
+    {
+        ck_assert_int_eq (copy_writer_wait (writer, FALSE), 0);
+        len = MIN (data->bufsize, data->size - i);
+        memcpy (copy_writer_get (writer), content + i, len);
+        copy_writer_put (writer, len);
+    }
+
+    ck_assert_int_eq (copy_writer_wait (writer, TRUE), 0);
+    copy_writer_free (writer);
+
+    // then
+    ck_assert_int_eq (g_file_get_contents (filename, &copy, &len, NULL), TRUE);
+    ck_assert_int_eq (len, data->size);
+    ck_assert_int_eq (memcmp (copy, content, len), 0);
+
+    g_free (copy);
+    g_free (content);
+}
+END_PARAMETRIZED_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Test */
+START_TEST (test_copy_writer_error)
+{
+    // given
+    int fd;
+    copy_writer_t *writer;
+
+    fd = open (filename, O_RDONLY);
+    ck_assert_int_ge (fd, 0);
+
+    writer = copy_writer_new (fd, 16);
+    mctest_assert_not_null (writer);
+
+    // when
+    memset (copy_writer_get (writer), 'a', 16);
+    copy_writer_put (writer, 16);
+
+    // then
+    ck_assert_int_eq (copy_writer_wait (writer, TRUE), EBADF);
+
+    // retry
+    copy_writer_continue (writer, FALSE);
+    ck_assert_int_eq (copy_writer_wait (writer, TRUE), EBADF);
+
+    // skip
+    copy_writer_continue (writer, TRUE);
+    ck_assert_int_eq (copy_writer_wait (writer, TRUE), 0);
+
+    copy_writer_free (writer);
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    // Add new tests here: ***************
+    mctest_add_parameterized_test (tc_core, test_copy_writer, test_copy_writer_ds);
+    tcase_add_test (tc_core, test_copy_writer_error);
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */
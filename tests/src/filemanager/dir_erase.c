@@ -0,0 +1,226 @@
+/*
+   src/filemanager - tests for parallel removal of files in directories
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/filemanager"
+
+#include "tests/mctest.h"
+
+#include "src/filemanager/direrase.c"
+
+/* --------------------------------------------------------------------------------------------- */
+
+static char *top = NULL;
+
+/* --------------------------------------------------------------------------------------------- */
+
+static char *
+make_path (const char *name)
+{
+    return g_build_filename (top, name, NULL);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+make_file (const char *name)
+{
+    char *path;
+
+    path = make_path (name);
+    ck_assert_int_eq (g_file_set_contents (path, "data", 4, NULL), TRUE);
+    g_free (path);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+exists (const char *name)
+{
+    char *path;
+    struct stat st;
+    gboolean ret;
+
+    path = make_path (name);
+    ret = lstat (path, &st) == 0;
+    g_free (path);
+
+    return ret;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+remove_tree (const char *path)
+{
+    GDir *dir;
+    const char *name;
+
+    dir = g_dir_open (path, 0, NULL);
+    if (dir != NULL)
+    {
+        while ((name = g_dir_read_name (dir)) != NULL)
+        {
+            char *p;
+            struct stat st;
+
+            p = g_build_filename (path, name, NULL);
+            if (lstat (p, &st) == 0 && S_ISDIR (st.st_mode))
+                remove_tree (p);
+            else
+                (void) unlink (p);
+            g_free (p);
+        }
+
+        g_dir_close (dir);
+    }
+
+    (void) rmdir (path);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    char *path, *target;
+    int i;
+
+    top = g_dir_make_tmp ("mctest-direrase-XXXXXX", NULL);
+    mctest_assert_not_null (top);
+
+    path = g_build_filename (top, "tree", "sub", "subsub", NULL);
+    ck_assert_int_eq (g_mkdir_with_parents (path, 0755), 0);
+    g_free (path);
+
+    path = make_path ("keep");
+    ck_assert_int_eq (g_mkdir_with_parents (path, 0755), 0);
+    g_free (path);
+
+    make_file ("tree/a");
+    make_file ("tree/sub/b");
+    make_file ("keep/c");
+
+    for (i = 0; i < 1000; i++)
+    {
+        char name[32];
+
+        g_snprintf (name, sizeof (name), "tree/sub/subsub/%d", i);
+        make_file (name);
+    }
+
+    // symlink to directory is removed, not followed
+    target = make_path ("keep");
+    path = make_path ("tree/link");
+    ck_assert_int_eq (symlink (target, path), 0);
+    g_free (path);
+    g_free (target);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    remove_tree (top);
+    g_free (top);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Test */
+START_TEST (test_dir_erase)
+{
+    // given
+    dir_erase_t *de;
+    char *path, *dirname;
+    size_t file_count;
+
+    // when
+    de = dir_erase_new (4);
+    path = make_path ("tree");
+    dir_erase_add (de, path);
+    g_free (path);
+    while (!dir_erase_wait (de, G_USEC_PER_SEC))
+        ;
+    dir_erase_get (de, &file_count, &dirname);
+    dir_erase_free (de);
+
+    // then
+    ck_assert_int_eq (file_count, 1003);
+    mctest_assert_not_null (dirname);
+    g_free (dirname);
+
+    ck_assert_int_eq (exists ("tree/a"), FALSE);
+    ck_assert_int_eq (exists ("tree/link"), FALSE);
+    ck_assert_int_eq (exists ("tree/sub/b"), FALSE);
+    ck_assert_int_eq (exists ("tree/sub/subsub/0"), FALSE);
+
+    // directories are left to the caller
+    ck_assert_int_eq (exists ("tree/sub/subsub"), TRUE);
+    ck_assert_int_eq (exists ("keep/c"), TRUE);
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Test */
+START_TEST (test_dir_erase_stop)
+{
+    // given
+    dir_erase_t *de;
+    char *path;
+
+    // when
+    de = dir_erase_new (4);
+    path = make_path ("tree");
+    dir_erase_add (de, path);
+    g_free (path);
+    dir_erase_free (de);
+
+    // then
+    ck_assert_int_eq (exists ("tree/sub/subsub"), TRUE);
+    ck_assert_int_eq (exists ("keep/c"), TRUE);
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    // Add new tests here: ***************
+    tcase_add_test (tc_core, test_dir_erase);
+    tcase_add_test (tc_core, test_dir_erase_stop);
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */
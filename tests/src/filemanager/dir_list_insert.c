@@ -0,0 +1,288 @@
+/*
+   src/filemanager - tests for dir_list_insert(), dir_list_find() and dir_list_remove() functions
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/filemanager"
+
+#include "tests/mctest.h"
+
+#include "src/filemanager/dir.c"
+
+/* --------------------------------------------------------------------------------------------- */
+
+static dir_list list;
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    str_init_strings (NULL);
+
+    memset (&list, 0, sizeof (list));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    dir_list_free_list (&list);
+
+    str_uninit_strings ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+make_entry (file_entry_t *fentry, const char *name, mode_t mode, off_t size, ino_t ino)
+{
+    memset (fentry, 0, sizeof (*fentry));
+    fentry->fname = g_string_new (name);
+    fentry->st.st_mode = mode;
+    fentry->st.st_size = size;
+    fentry->st.st_ino = ino;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Fill the list with "..", one directory and three files. Files "b" and "d" have the same inode
+ * number, so they are equal for sort_inode().
+ */
+
+static void
+fill_list (GCompareFunc sort, const dir_sort_options_t *sort_op)
+{
+    static const struct
+    {
+        const char *name;
+        mode_t mode;
+        off_t size;
+        ino_t ino;
+    } entries[] = {
+        { "sub", S_IFDIR | 0755, 0, 5 },
+        { "b", S_IFREG | 0644, 10, 3 },
+        { "d", S_IFREG | 0644, 20, 3 },
+        { "f", S_IFREG | 0644, 30, 7 },
+    };
+    size_t i;
+
+    dir_list_init (&list);
+
+    for (i = 0; i < G_N_ELEMENTS (entries); i++)
+    {
+        file_entry_t fentry;
+
+        make_entry (&fentry, entries[i].name, entries[i].mode, entries[i].size, entries[i].ino);
+        dir_list_append (&list, fentry.fname->str, &fentry.st, FALSE, FALSE);
+        g_string_free (fentry.fname, TRUE);
+    }
+
+    dir_list_sort (&list, sort, sort_op);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_dir_list_insert_ds") */
+static const struct test_dir_list_insert_ds
+{
+    GCompareFunc sort;
+    const char *name;
+    mode_t mode;
+    off_t size;
+    ino_t ino;
+    int expected_idx;
+} test_dir_list_insert_ds[] = {
+    // "!dir" sorts before "..", but ".." is always the first
+    { (GCompareFunc) sort_name, "!dir", S_IFDIR | 0755, 0, 1, 1 },  // 0
+    { (GCompareFunc) sort_name, "a", S_IFREG | 0644, 0, 1, 2 },     // 1: head of files
+    { (GCompareFunc) sort_name, "c", S_IFREG | 0644, 0, 1, 3 },     // 2
+    { (GCompareFunc) sort_name, "g", S_IFREG | 0644, 0, 1, 5 },     // 3: tail
+    { (GCompareFunc) sort_size, "z", S_IFREG | 0644, 5, 1, 2 },     // 4
+    { (GCompareFunc) sort_size, "e", S_IFREG | 0644, 20, 1, 4 },    // 5: after "d" of same size
+    { (GCompareFunc) sort_size, "x", S_IFREG | 0644, 40, 1, 5 },    // 6
+    // equal entries: new one is inserted before them
+    { (GCompareFunc) sort_inode, "c", S_IFREG | 0644, 0, 3, 2 },    // 7
+    { (GCompareFunc) sort_inode, "a", S_IFREG | 0644, 0, 9, 5 },    // 8
+    { (GCompareFunc) unsorted, "a", S_IFREG | 0644, 0, 1, 5 },      // 9: appended
+};
+
+/* @Test(dataSource = "test_dir_list_insert_ds") */
+START_PARAMETRIZED_TEST (test_dir_list_insert, test_dir_list_insert_ds)
+{
+    // given
+    const dir_sort_options_t sort_op = { FALSE, TRUE, FALSE };
+    file_entry_t fentry;
+    int i, idx;
+
+    fill_list (data->sort, &sort_op);
+    make_entry (&fentry, data->name, data->mode, data->size, data->ino);
+
+    // when
+    idx = dir_list_insert (&list, &fentry, data->sort, &sort_op);
+
+    // then
+    ck_assert_int_eq (idx, data->expected_idx);
+    ck_assert_int_eq (list.len, 6);
+    mctest_assert_str_eq (list.list[0].fname->str, "..");
+    mctest_assert_str_eq (list.list[idx].fname->str, data->name);
+
+    if (data->sort != (GCompareFunc) unsorted)
+    {
+        for (i = 2; i < list.len; i++)
+            ck_assert_int_le (data->sort (&list.list[i - 1], &list.list[i]), 0);
+        clean_sort_keys (&list, 1, list.len - 1);
+    }
+
+    // entries are found among equal ones too
+    for (i = 1; i < list.len; i++)
+        ck_assert_int_eq (dir_list_find (&list, &list.list[i], data->sort, &sort_op), i);
+}
+END_PARAMETRIZED_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Test */
+START_TEST (test_dir_list_remove)
+{
+    // given
+    const dir_sort_options_t sort_op = { FALSE, TRUE, FALSE };
+    file_entry_t head, tail;
+
+    fill_list ((GCompareFunc) sort_inode, &sort_op);
+    make_entry (&head, "b", S_IFREG | 0644, 10, 3);
+    make_entry (&tail, "f", S_IFREG | 0644, 30, 7);
+
+    // when
+    dir_list_remove (&list, list.len - 1);
+    dir_list_remove (&list, dir_list_find (&list, &head, (GCompareFunc) sort_inode, &sort_op));
+
+    // then
+    ck_assert_int_eq (list.len, 3);
+    ck_assert_int_eq (dir_list_find (&list, &head, (GCompareFunc) sort_inode, &sort_op), -1);
+    ck_assert_int_eq (dir_list_find (&list, &tail, (GCompareFunc) sort_inode, &sort_op), -1);
+    mctest_assert_str_eq (list.list[2].fname->str, "d");
+    ck_assert_int_eq (dir_list_find (&list, &list.list[2], (GCompareFunc) sort_inode, &sort_op), 2);
+
+    g_string_free (head.fname, TRUE);
+    g_string_free (tail.fname, TRUE);
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Test */
+START_TEST (test_dir_list_insert_no_dotdot)
+{
+    // given
+    const dir_sort_options_t sort_op = { FALSE, TRUE, FALSE };
+    static const char *const names[] = { "b", "a", "c" };
+    static const int expected_idx[] = { 0, 0, 2 };
+    size_t i;
+
+    // when
+    for (i = 0; i < G_N_ELEMENTS (names); i++)
+    {
+        file_entry_t fentry;
+
+        make_entry (&fentry, names[i], S_IFREG | 0644, 0, 1);
+
+        // then
+        ck_assert_int_eq (dir_list_insert (&list, &fentry, (GCompareFunc) sort_name, &sort_op),
+                          expected_idx[i]);
+    }
+
+    // then
+    ck_assert_int_eq (list.len, 3);
+    mctest_assert_str_eq (list.list[0].fname->str, "a");
+    mctest_assert_str_eq (list.list[2].fname->str, "c");
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Test */
+START_TEST (test_dir_list_insert_inode_gaps)
+{
+    // given
+    const dir_sort_options_t sort_op = { FALSE, TRUE, FALSE };
+    // differences of inode numbers don't fit in int
+    static const ino_t inodes[] = { 0x100000002ULL, 1, 0x80000001ULL };
+    file_entry_t fentry;
+    size_t j;
+    int i, idx;
+
+    dir_list_init (&list);
+
+    for (j = 0; j < G_N_ELEMENTS (inodes); j++)
+    {
+        char name[2] = { (char) ('x' + j), '\0' };
+
+        make_entry (&fentry, name, S_IFREG | 0644, 0, inodes[j]);
+        dir_list_append (&list, fentry.fname->str, &fentry.st, FALSE, FALSE);
+        g_string_free (fentry.fname, TRUE);
+    }
+
+    dir_list_sort (&list, (GCompareFunc) sort_inode, &sort_op);
+    make_entry (&fentry, "n", S_IFREG | 0644, 0, 0xC0000000ULL);
+
+    // when
+    idx = dir_list_insert (&list, &fentry, (GCompareFunc) sort_inode, &sort_op);
+
+    // then
+    ck_assert_int_eq (idx, 3);
+    mctest_assert_str_eq (list.list[1].fname->str, "y");
+    mctest_assert_str_eq (list.list[2].fname->str, "z");
+    mctest_assert_str_eq (list.list[4].fname->str, "x");
+
+    for (i = 2; i < list.len; i++)
+        ck_assert_int_lt (sort_inode (&list.list[i - 1], &list.list[i]), 0);
+
+    for (i = 1; i < list.len; i++)
+        ck_assert_int_eq (dir_list_find (&list, &list.list[i], (GCompareFunc) sort_inode, &sort_op),
+                          i);
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    // Add new tests here: ***************
+    mctest_add_parameterized_test (tc_core, test_dir_list_insert, test_dir_list_insert_ds);
+    tcase_add_test (tc_core, test_dir_list_remove);
+    tcase_add_test (tc_core, test_dir_list_insert_no_dotdot);
+    tcase_add_test (tc_core, test_dir_list_insert_inode_gaps);
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */
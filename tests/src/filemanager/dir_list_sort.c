@@ -0,0 +1,179 @@
+/*
+   src/filemanager - tests for dir_list_sort() function
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/filemanager"
+
+#include "tests/mctest.h"
+
+#include "src/filemanager/dir.c"
+
+/* --------------------------------------------------------------------------------------------- */
+
+static dir_list list;
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    str_init_strings (NULL);
+
+    memset (&list, 0, sizeof (list));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    dir_list_free_list (&list);
+
+    str_uninit_strings ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Fill the list with entries which have a lot of equal names, extensions, times and sizes.
+ * Original index of entry is kept in st_dev.
+ */
+
+static void
+fill_list (int count)
+{
+    static const char *const names[] = {
+        "a", "B", "c.txt", "C.TXT", ".hidden", ".Hidden.c", "z.c", "zz", "file.tar.gz", "File",
+    };
+    guint32 seed = 1;
+    int i;
+
+    dir_list_init (&list);
+
+    for (i = 1; i < count; i++)
+    {
+        struct stat st;
+        char *name;
+
+        seed = seed * 1103515245 + 12345;
+
+        memset (&st, 0, sizeof (st));
+        st.st_dev = (dev_t) i;
+        st.st_ino = (ino_t) ((seed >> 8) % 1000);
+        if ((seed >> 4) % 5 == 0)
+            st.st_mode = S_IFDIR | 0755;
+        else
+            st.st_mode = S_IFREG | ((seed & 1) != 0 ? 0755 : 0644);
+        st.st_size = (off_t) ((seed >> 12) % 100);
+        st.st_mtime = (time_t) ((seed >> 16) % 50);
+        st.st_atime = (time_t) ((seed >> 18) % 50);
+        st.st_ctime = (time_t) ((seed >> 20) % 50);
+
+        name = g_strdup_printf ("%s%u", names[(seed >> 3) % G_N_ELEMENTS (names)],
+                                (seed >> 24) % 16);
+        dir_list_append (&list, name, &st, FALSE, FALSE);
+        g_free (name);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_dir_list_sort_ds") */
+static const struct test_dir_list_sort_ds
+{
+    GCompareFunc sort;
+    dir_sort_options_t sort_op;
+    int count;
+} test_dir_list_sort_ds[] = {
+    { (GCompareFunc) sort_name, { FALSE, FALSE, FALSE }, 500 },           // 0
+    { (GCompareFunc) sort_name, { TRUE, TRUE, TRUE }, 500 },              // 1
+    { (GCompareFunc) sort_ext, { FALSE, TRUE, FALSE }, 500 },             // 2
+    { (GCompareFunc) sort_ext, { TRUE, FALSE, TRUE }, 500 },              // 3
+    { (GCompareFunc) sort_time, { FALSE, FALSE, FALSE }, 500 },           // 4
+    { (GCompareFunc) sort_atime, { TRUE, TRUE, FALSE }, 500 },            // 5
+    { (GCompareFunc) sort_ctime, { FALSE, TRUE, TRUE }, 500 },            // 6
+    { (GCompareFunc) sort_size, { TRUE, FALSE, FALSE }, 500 },            // 7
+    { (GCompareFunc) sort_inode, { FALSE, FALSE, FALSE }, 500 },          // 8
+    { (GCompareFunc) sort_vers, { FALSE, TRUE, FALSE }, 500 },            // 9
+    { (GCompareFunc) sort_name, { FALSE, FALSE, FALSE }, 3 * 16384 + 7 },  // 10
+    { (GCompareFunc) sort_ext, { TRUE, TRUE, FALSE }, 3 * 16384 + 7 },     // 11
+    { (GCompareFunc) sort_size, { FALSE, TRUE, TRUE }, 3 * 16384 + 7 },    // 12
+    { (GCompareFunc) sort_time, { TRUE, FALSE, FALSE }, 3 * 16384 + 7 },   // 13
+    { (GCompareFunc) sort_vers, { FALSE, FALSE, TRUE }, 3 * 16384 + 7 },   // 14
+    { (GCompareFunc) sort_inode, { TRUE, TRUE, FALSE }, 3 * 16384 + 7 },   // 15
+};
+
+/* @Test(dataSource = "test_dir_list_sort_ds") */
+START_PARAMETRIZED_TEST (test_dir_list_sort, test_dir_list_sort_ds)
+{
+    // given
+    gboolean *seen;
+    int i;
+
+    fill_list (data->count);
+
+    // when
+    dir_list_sort (&list, data->sort, &data->sort_op);
+
+    // then
+    ck_assert_int_eq (list.len, data->count);
+    mctest_assert_str_eq (list.list[0].fname->str, "..");
+
+    seen = g_new0 (gboolean, data->count);
+    for (i = 1; i < list.len; i++)
+    {
+        const int index = (int) list.list[i].st.st_dev;
+
+        ck_assert_int_gt (index, 0);
+        ck_assert_int_lt (index, data->count);
+        ck_assert_int_eq (seen[index], FALSE);
+        seen[index] = TRUE;
+    }
+    g_free (seen);
+
+    // sort options are still set by dir_list_sort()
+    for (i = 2; i < list.len; i++)
+        ck_assert_int_le (data->sort (&list.list[i - 1], &list.list[i]), 0);
+
+    clean_sort_keys (&list, 1, list.len - 1);
+}
+END_PARAMETRIZED_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    // Add new tests here: ***************
+    mctest_add_parameterized_test (tc_core, test_dir_list_sort, test_dir_list_sort_ds);
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */
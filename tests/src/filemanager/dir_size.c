@@ -0,0 +1,229 @@
+/*
+   src/filemanager - tests for parallel computing of directory sizes
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/filemanager"
+
+#include "tests/mctest.h"
+
+#include <utime.h>
+
+#include "src/filemanager/dirsize.c"
+
+/* --------------------------------------------------------------------------------------------- */
+
+static char *top = NULL;
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+make_file (const char *name, gsize size)
+{
+    char *path, *content;
+
+    path = g_build_filename (top, name, NULL);
+    content = g_malloc0 (size);
+    ck_assert_int_eq (g_file_set_contents (path, content, (gssize) size, NULL), TRUE);
+    g_free (content);
+    g_free (path);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+make_old (const char *name)
+{
+    struct utimbuf times = { 1000000000, 1000000000 };
+    char *path;
+
+    path = g_build_filename (top, name, NULL);
+    ck_assert_int_eq (utime (path, &times), 0);
+    g_free (path);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+compute (size_t *dir_count, size_t *file_count, uintmax_t *total)
+{
+    dir_size_t *ds;
+
+    ds = dir_size_new (FALSE);
+    dir_size_add (ds, top);
+    while (!dir_size_wait (ds, G_USEC_PER_SEC))
+        ;
+    dir_size_get (ds, dir_count, file_count, total, NULL);
+    dir_size_free (ds);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    char *path, *link_path;
+
+    top = g_dir_make_tmp ("mctest-dirsize-XXXXXX", NULL);
+    mctest_assert_not_null (top);
+
+    path = g_build_filename (top, "sub", "subsub", NULL);
+    ck_assert_int_eq (g_mkdir_with_parents (path, 0755), 0);
+    g_free (path);
+
+    make_file ("a", 1000);
+    make_file ("sub/b", 2000);
+    make_file ("sub/subsub/c", 3000);
+
+    // hard link is counted once
+    path = g_build_filename (top, "a", NULL);
+    link_path = g_build_filename (top, "sub", "a", NULL);
+    ck_assert_int_eq (link (path, link_path), 0);
+    g_free (link_path);
+    g_free (path);
+
+    // changes made in the last second are not cached
+    make_old ("sub/subsub");
+    make_old ("sub");
+    make_old ("");
+
+    dir_size_cache_clear ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    const char *names[] = { "sub/subsub/c", "sub/subsub", "sub/a", "sub/b", "sub/d", "sub", "a" };
+    size_t i;
+
+    for (i = 0; i < G_N_ELEMENTS (names); i++)
+    {
+        char *path;
+
+        path = g_build_filename (top, names[i], NULL);
+        (void) remove (path);
+        g_free (path);
+    }
+
+    (void) rmdir (top);
+    g_free (top);
+
+    dir_size_cache_clear ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Test */
+START_TEST (test_dir_size)
+{
+    // given
+    size_t dir_count, file_count;
+    uintmax_t total;
+
+    // when
+    compute (&dir_count, &file_count, &total);
+
+    // then
+    ck_assert_int_eq (dir_count, 3);
+    ck_assert_int_eq (file_count, 4);
+    ck_assert_int_eq (total, 6000);
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Test */
+START_TEST (test_dir_size_cache)
+{
+    // given
+    size_t dir_count, file_count;
+    uintmax_t total;
+
+    compute (&dir_count, &file_count, &total);
+    ck_assert_int_eq (g_hash_table_size (cache), 3);
+
+    // when
+    make_file ("sub/d", 500);
+    compute (&dir_count, &file_count, &total);
+
+    // then
+    ck_assert_int_eq (dir_count, 3);
+    ck_assert_int_eq (file_count, 5);
+    ck_assert_int_eq (total, 6500);
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Test */
+START_TEST (test_dir_size_skipped)
+{
+    // given
+    dir_size_t *ds;
+    char *path;
+    size_t dir_count, file_count;
+    uintmax_t total;
+
+    path = g_build_filename (top, "missing", NULL);
+
+    // when
+    ds = dir_size_new (FALSE);
+    dir_size_add (ds, top);
+    dir_size_add (ds, path);
+    while (!dir_size_wait (ds, G_USEC_PER_SEC))
+        ;
+    dir_size_get (ds, &dir_count, &file_count, &total, NULL);
+
+    // then
+    ck_assert_int_eq (dir_size_get_skipped (ds), 1);
+    ck_assert_int_eq (dir_count, 4);
+    ck_assert_int_eq (file_count, 4);
+    ck_assert_int_eq (total, 6000);
+
+    dir_size_free (ds);
+    g_free (path);
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    // Add new tests here: ***************
+    tcase_add_test (tc_core, test_dir_size);
+    tcase_add_test (tc_core, test_dir_size_cache);
+    tcase_add_test (tc_core, test_dir_size_skipped);
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */
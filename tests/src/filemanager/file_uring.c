@@ -0,0 +1,124 @@
+/*
+   src/filemanager - tests for batched file operations using io_uring
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/filemanager"
+
+#include "tests/mctest.h"
+
+#include <fcntl.h>
+
+#include "src/filemanager/fileuring.c"
+
+#define FILES_NUM 100
+
+/* --------------------------------------------------------------------------------------------- */
+
+static char *dirname = NULL;
+static int dir_fd = -1;
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    dirname = g_dir_make_tmp ("mctest-fileuring-XXXXXX", NULL);
+    mctest_assert_not_null (dirname);
+
+    dir_fd = open (dirname, O_RDONLY | O_DIRECTORY);
+    ck_assert_int_ge (dir_fd, 0);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    close (dir_fd);
+    (void) rmdir (dirname);
+    g_free (dirname);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Test */
+START_TEST (test_file_uring_unlinkat)
+{
+    // given
+    file_uring_t *ring;
+    char *names[FILES_NUM + 2];
+    int results[FILES_NUM + 2];
+    int i;
+
+    ring = file_uring_new (16);
+    if (ring == NULL)
+        return;  // io_uring is not available on this system
+
+    for (i = 0; i < FILES_NUM; i++)
+    {
+        names[i] = g_strdup_printf ("file%d", i);
+        close (openat (dir_fd, names[i], O_WRONLY | O_CREAT, 0644));
+    }
+    names[FILES_NUM] = g_strdup ("dir");
+    ck_assert_int_eq (mkdirat (dir_fd, names[FILES_NUM], 0755), 0);
+    names[FILES_NUM + 1] = g_strdup ("missing");
+
+    // when
+    file_uring_unlinkat (ring, dir_fd, names, results, FILES_NUM + 2);
+
+    // then
+    for (i = 0; i < FILES_NUM; i++)
+    {
+        ck_assert_int_eq (results[i], 0);
+        ck_assert_int_eq (faccessat (dir_fd, names[i], F_OK, AT_SYMLINK_NOFOLLOW), -1);
+    }
+    ck_assert_int_eq (results[FILES_NUM], -EISDIR);
+    ck_assert_int_eq (results[FILES_NUM + 1], -ENOENT);
+
+    ck_assert_int_eq (unlinkat (dir_fd, names[FILES_NUM], AT_REMOVEDIR), 0);
+
+    for (i = 0; i < FILES_NUM + 2; i++)
+        g_free (names[i]);
+    file_uring_free (ring);
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    // Add new tests here: ***************
+    tcase_add_test (tc_core, test_file_uring_unlinkat);
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */